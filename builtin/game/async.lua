@@ -8,15 +8,37 @@ function core.async_event_handler(jobid, retval)
 	core.async_jobs[jobid] = nil
 end
 
-function core.handle_async(func, callback, ...)
+-- Must match AsyncJobPriority
+local priorities = {high = 0, normal = 1, low = 2}
+
+local function queue_async(func, callback, options, ...)
 	assert(type(func) == "function" and type(callback) == "function",
 		"Invalid core.handle_async invocation")
+	local priority = priorities[options.priority or "normal"]
+	assert(priority, "Invalid async job priority")
 	local args = {n = select("#", ...), ...}
 	local mod_origin = core.get_last_run_mod()
 
-	local jobid = core.do_async_callback(func, args, mod_origin)
+	local jobid = core.do_async_callback(func, args, mod_origin, priority)
 	core.async_jobs[jobid] = callback
 
+	return jobid
+end
+
+function core.handle_async(func, callback, ...)
+	queue_async(func, callback, {}, ...)
 	return true
 end
 
+function core.handle_async_ex(func, callback, options, ...)
+	assert(type(options) == "table", "Invalid core.handle_async_ex invocation")
+	return queue_async(func, callback, options, ...)
+end
+
+function core.cancel_async(jobid)
+	if not core.cancel_async_callback(jobid) then
+		return false
+	end
+	core.async_jobs[jobid] = nil
+	return true
+end
@@ -1356,3 +1356,41 @@ core.register_chatcommand("kill", {
 		return handle_kill_command(name, param == "" and name or param)
 	end,
 })
+
+local lua_profiler_usage = S("start [<interval in µs>] | stop | save [folded | trace] | reset")
+core.register_chatcommand("lua_profiler", {
+	params = lua_profiler_usage,
+	description = S("Sample the Lua call stacks to find slow mod code"),
+	privs = {server=true},
+	func = function(name, param)
+		local command, arg = param:match("^(%S+)%s*(.*)$")
+		if command == "start" then
+			local interval = tonumber(arg)
+			if arg ~= "" and not interval then
+				return false, S("Invalid interval.")
+			end
+			if not core.lua_sampler_start(interval) then
+				return false, S("The Lua profiler is already running.")
+			end
+			return true, S("Lua profiler started.")
+		elseif command == "stop" then
+			local samples = core.lua_sampler_stop()
+			return true, S("Lua profiler stopped, @1 samples recorded.", samples)
+		elseif command == "save" then
+			local format = arg ~= "" and arg or "folded"
+			if format ~= "folded" and format ~= "trace" then
+				return false, S("Unknown format: @1", format)
+			end
+			local path = core.lua_sampler_save(format)
+			if not path then
+				return false, S("Saving of profile failed.")
+			end
+			core.log("action", "Lua profile saved to " .. path)
+			return true, S("Profile saved to @1", path)
+		elseif command == "reset" then
+			core.lua_sampler_clear()
+			return true, S("Lua profiler samples were reset.")
+		end
+		return false, S("Usage: @1", lua_profiler_usage)
+	end,
+})
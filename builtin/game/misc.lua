@@ -321,3 +321,25 @@ function core.run_lbm(id, pos_list, dtime_s)
 		end
 	end
 end
+
+--
+-- Helper for running entity on_step callbacks, called from C++
+--
+
+function core.run_entity_steps(count, ids, dtime, moveresults)
+	local luaentities = core.luaentities
+	local last_origin
+	for i = 1, count do
+		local self = luaentities[ids[i]]
+		local on_step = self and self.on_step
+		-- the object might have been removed by a previous callback
+		if on_step and self.object:is_valid() then
+			local origin = self.mod_origin or "??"
+			if origin ~= last_origin then
+				core.set_last_run_mod(origin)
+				last_origin = origin
+			end
+			on_step(self, dtime, moveresults[i] or nil)
+		end
+	end
+end
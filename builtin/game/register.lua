@@ -94,7 +94,12 @@ function core.register_abm(spec)
 	-- Add to core.registered_abms
 	check_node_list(spec.nodenames, "nodenames")
 	check_node_list(spec.neighbors, "neighbors")
-	assert(type(spec.action) == "function", "Required field 'action' of type function")
+	if spec.native ~= nil then
+		assert(type(spec.native) == "table", "Field 'native' must be a table")
+		check_node_list(spec.native.above, "native.above")
+	else
+		assert(type(spec.action) == "function", "Required field 'action' of type function")
+	end
 	core.registered_abms[#core.registered_abms + 1] = spec
 	spec.mod_origin = core.get_current_modname() or "??"
 end
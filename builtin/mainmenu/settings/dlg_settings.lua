@@ -19,8 +19,6 @@
 local component_funcs =  dofile(core.get_mainmenu_path() .. DIR_DELIM ..
 		"settings" .. DIR_DELIM .. "components.lua")
 
-local shader_warning_component =  dofile(core.get_mainmenu_path() .. DIR_DELIM ..
-		"settings" .. DIR_DELIM .. "shader_warning_component.lua")
 local shadows_component =  dofile(core.get_mainmenu_path() .. DIR_DELIM ..
 		"settings" .. DIR_DELIM .. "shadows_component.lua")
 
@@ -154,12 +152,7 @@ local function load()
 
 	table.insert(page_by_id.controls_keyboard_and_mouse.content, 1, change_keys)
 	do
-		local content = page_by_id.graphics_and_audio_graphics.content
-		table.insert(content, 1, shader_warning_component)
-
-		content = page_by_id.graphics_and_audio_effects.content
-		table.insert(content, 1, shader_warning_component)
-
+		local content = page_by_id.graphics_and_audio_effects.content
 		local idx = table.indexof(content, "enable_dynamic_shadows")
 		table.insert(content, idx, shadows_component)
 
@@ -360,7 +353,7 @@ local function check_requirements(name, requires)
 		touchscreen = touch_support and (touch_controls == "auto" or core.is_yes(touch_controls)),
 		keyboard_mouse = not touch_support or (touch_controls == "auto" or not core.is_yes(touch_controls)),
 		shaders_support = shaders_support,
-		shaders = core.settings:get_bool("enable_shaders") and shaders_support,
+		shaders = shaders_support,
 		opengl = video_driver == "opengl",
 		gles = video_driver:sub(1, 5) == "ogles",
 	}
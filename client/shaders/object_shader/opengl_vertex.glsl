@@ -79,6 +79,29 @@ float mtsmoothstep(in float edge0, in float edge1, in float x)
 #endif
 
 
+#ifdef ENABLE_GPU_SKINNING
+uniform int mSkinning;
+uniform highp mat4 mJointMatrices[MAX_SKINNING_JOINTS];
+
+// Blends the matrices of up to four joints, with the joint ids packed in pairs
+// into the tangent and the weights in the binormal and the tangent's Z.
+highp mat4 getSkinningMatrix()
+{
+	highp vec2 packedJoints = inVertexTangent.xy;
+	highp vec2 firstJoints = floor(packedJoints / 256.0);
+	highp vec2 secondJoints = packedJoints - firstJoints * 256.0;
+	vec4 weights = vec4(inVertexBinormal.xyz, inVertexTangent.z);
+
+	// whatever is not weighted stays in place
+	highp mat4 skin = mat4(1.0 - dot(weights, vec4(1.0)));
+	skin += mJointMatrices[int(firstJoints.x)] * weights.x;
+	skin += mJointMatrices[int(secondJoints.x)] * weights.y;
+	skin += mJointMatrices[int(firstJoints.y)] * weights.z;
+	skin += mJointMatrices[int(secondJoints.y)] * weights.w;
+	return skin;
+}
+#endif
+
 float directional_ambient(vec3 normal)
 {
 	vec3 v = normal * normal;
@@ -91,22 +114,32 @@ float directional_ambient(vec3 normal)
 
 void main(void)
 {
+	highp vec4 position = inVertexPosition;
+	vec3 normal = inVertexNormal;
+#ifdef ENABLE_GPU_SKINNING
+	if (mSkinning != 0) {
+		highp mat4 skin = getSkinningMatrix();
+		position = skin * position;
+		normal = (skin * vec4(normal, 0.0)).xyz;
+	}
+#endif
+
 	varTexCoord = (mTexture * vec4(inTexCoord0.xy, 1.0, 1.0)).st;
-	gl_Position = mWorldViewProj * inVertexPosition;
+	gl_Position = mWorldViewProj * position;
 
 	vPosition = gl_Position.xyz;
-	vNormal = (mWorld * vec4(inVertexNormal, 0.0)).xyz;
-	worldPosition = (mWorld * inVertexPosition).xyz;
-	eyeVec = -(mWorldView * inVertexPosition).xyz;
+	vNormal = (mWorld * vec4(normal, 0.0)).xyz;
+	worldPosition = (mWorld * position).xyz;
+	eyeVec = -(mWorldView * position).xyz;
 
 #if (MATERIAL_TYPE == TILE_MATERIAL_PLAIN) || (MATERIAL_TYPE == TILE_MATERIAL_PLAIN_ALPHA)
 	vIDiff = 1.0;
 #else
 	// This is intentional comparison with zero without any margin.
 	// If normal is not equal to zero exactly, then we assume it's a valid, just not normalized vector
-	vIDiff = length(inVertexNormal) == 0.0
+	vIDiff = length(normal) == 0.0
 		? 1.0
-		: directional_ambient(normalize(inVertexNormal));
+		: directional_ambient(normalize(normal));
 #endif
 
 	vec4 color = inVertexColor;
@@ -136,7 +169,7 @@ void main(void)
 		/* normalOffsetScale is in world coordinates (1/10th of a meter)
 		   z_bias is in light space coordinates */
 		float normalOffsetScale, z_bias;
-		float pFactor = getPerspectiveFactor(getRelativePosition(m_ShadowViewProj * mWorld * inVertexPosition));
+		float pFactor = getPerspectiveFactor(getRelativePosition(m_ShadowViewProj * mWorld * position));
 		if (f_normal_length > 0.0) {
 			nNormal = normalize(vNormal);
 			cosLight = max(1e-5, dot(nNormal, -v_LightDirection));
@@ -154,7 +187,7 @@ void main(void)
 		}
 		z_bias *= pFactor * pFactor / f_textureresolution / f_shadowfar;
 
-		shadow_position = applyPerspectiveDistortion(m_ShadowViewProj * mWorld * (inVertexPosition + vec4(normalOffsetScale * nNormal, 0.0))).xyz;
+		shadow_position = applyPerspectiveDistortion(m_ShadowViewProj * mWorld * (position + vec4(normalOffsetScale * nNormal, 0.0))).xyz;
 		shadow_position.z -= z_bias;
 		perspective_factor = pFactor;
 
@@ -32,9 +32,36 @@ vec4 applyPerspectiveDistortion(in vec4 position)
 	return position;
 }
 
+#ifdef ENABLE_GPU_SKINNING
+uniform int mSkinning;
+uniform mat4 mJointMatrices[MAX_SKINNING_JOINTS];
+
+// Same as in object_shader, the joints are packed into the tangent and binormal.
+mat4 getSkinningMatrix()
+{
+	vec2 packedJoints = gl_MultiTexCoord1.xy;
+	vec2 firstJoints = floor(packedJoints / 256.0);
+	vec2 secondJoints = packedJoints - firstJoints * 256.0;
+	vec4 weights = vec4(gl_MultiTexCoord2.xyz, gl_MultiTexCoord1.z);
+
+	mat4 skin = mat4(1.0 - dot(weights, vec4(1.0)));
+	skin += mJointMatrices[int(firstJoints.x)] * weights.x;
+	skin += mJointMatrices[int(secondJoints.x)] * weights.y;
+	skin += mJointMatrices[int(firstJoints.y)] * weights.z;
+	skin += mJointMatrices[int(secondJoints.y)] * weights.w;
+	return skin;
+}
+#endif
+
 void main()
 {
-	vec4 pos = LightMVP * gl_Vertex;
+	vec4 position = gl_Vertex;
+#ifdef ENABLE_GPU_SKINNING
+	if (mSkinning != 0)
+		position = getSkinningMatrix() * position;
+#endif
+
+	vec4 pos = LightMVP * position;
 
 	tPos = applyPerspectiveDistortion(pos);
 
@@ -5,3 +5,4 @@ dofile(path.."/chances.lua")
 dofile(path.."/intervals.lua")
 dofile(path.."/min_max.lua")
 dofile(path.."/neighbors.lua")
+dofile(path.."/native.lua")
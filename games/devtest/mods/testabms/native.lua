@@ -0,0 +1,66 @@
+-- test ABMs with a native action
+
+local S = core.get_translator("testnodes")
+
+-- Native ABM replace node
+core.register_node("testabms:native_replace", {
+	description = S("Node for test native ABM replace."),
+	drawtype = "normal",
+	tiles = { "testabms_wait_node.png" },
+
+	groups = { dig_immediate = 3 },
+})
+
+core.register_abm({
+	label = "testabms:native_replace",
+	nodenames = "testabms:native_replace",
+	interval = 1,
+	chance = 1,
+	native = {
+		node = "testabms:after_abm",
+		swap = true,
+	},
+})
+
+-- Native ABM light node
+core.register_node("testabms:native_light", {
+	description = S("Node for test native ABM light.") .. "\n"
+		.. S("Changes if the light above is at least 10."),
+	drawtype = "normal",
+	tiles = { "testabms_wait_node.png" },
+
+	groups = { dig_immediate = 3 },
+})
+
+core.register_abm({
+	label = "testabms:native_light",
+	nodenames = "testabms:native_light",
+	interval = 1,
+	chance = 1,
+	native = {
+		node = "testabms:after_abm",
+		min_light = 10,
+	},
+})
+
+-- Native ABM above node
+core.register_node("testabms:native_above", {
+	description = S("Node for test native ABM above.") .. "\n"
+		.. S("Places a node above if there is air."),
+	drawtype = "normal",
+	tiles = { "testabms_wait_node.png" },
+
+	groups = { dig_immediate = 3 },
+})
+
+core.register_abm({
+	label = "testabms:native_above",
+	nodenames = "testabms:native_above",
+	interval = 1,
+	chance = 1,
+	native = {
+		node = "testabms:after_abm",
+		position = "above",
+		above = "air",
+	},
+})
@@ -207,3 +207,69 @@ local function test_vector_preserve(cb)
 	end, {vec})
 end
 unittests.register("test_async_vector", test_vector_preserve, {async=true})
+
+local function test_shared_data_passing(cb, _, pos)
+	local buf = SharedBuffer({1, 2.5, 3})
+	assert(#buf == 3 and buf:get(2) == 2.5 and buf:get(4) == nil)
+	assert(deepequal(buf:to_table(2), {2.5, 3}))
+
+	local snapshot = core.get_map_snapshot(pos, pos)
+	local expect = snapshot:get_node(pos)
+	assert(deepequal(expect, core.get_node(pos)))
+	assert(not pcall(MapSnapshot, pos, vector.offset(pos, 200, 200, 200)))
+
+	core.handle_async(function(buf_, snapshot_, pos_)
+		if pcall(MapSnapshot, pos_, pos_) then
+			return "created"
+		end
+		return buf_:to_table(), snapshot_:get_node(pos_), buf_
+	end, function(list, node, buf2)
+		if list == "created" then
+			return cb("MapSnapshot created in async environment")
+		end
+		if not deepequal(list, {1, 2.5, 3}) then
+			return cb("Buffer data mismatch")
+		end
+		if not deepequal(node, expect) then
+			return cb("Node data mismatch")
+		end
+		if buf2:get(3) ~= 3 then
+			return cb("Buffer data mismatch (roundtrip)")
+		end
+		cb()
+	end, buf, snapshot, pos)
+end
+unittests.register("test_shared_data_passing", test_shared_data_passing, {map=true, async=true})
+
+local function test_async_priority(cb)
+	local function job(n)
+		local t = os.clock()
+		while os.clock() - t < 0.01 do end
+		return n
+	end
+	local order = {}
+	local expected = 21
+	local function done(n)
+		order[#order + 1] = n
+		if #order < expected then
+			return
+		end
+		-- The high priority job overtakes most of the queued ones
+		local pos = table.indexof(order, "high")
+		if pos > 10 then
+			return cb("High priority job finished late: " .. pos)
+		end
+		cb()
+	end
+
+	local last
+	for i = 1, 20 do
+		last = core.handle_async_ex(job, done, {priority = "low"}, i)
+	end
+	-- Fails if a worker already started the job
+	if core.cancel_async(last) then
+		expected = expected - 1
+	end
+	core.handle_async_ex(job, done, {priority = "high"}, "high")
+end
+unittests.register("test_async_priority", test_async_priority, {async=true})
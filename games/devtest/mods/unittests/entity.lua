@@ -133,6 +133,21 @@ local function test_entity_interact(_, pos)
 end
 unittests.register("test_entity_interact", test_entity_interact, {map=true})
 
+local function test_entity_xyz_getters(_, pos)
+	local obj = core.add_entity(pos, "unittests:dummy")
+	obj:set_velocity(vector.new(1, -2, 3.5))
+
+	local x, y, z = obj:get_pos_xyz()
+	assert(vector.equals(vector.new(x, y, z), obj:get_pos()))
+	x, y, z = obj:get_velocity_xyz()
+	assert(x == 1 and y == -2 and z == 3.5)
+
+	obj:remove()
+	assert(obj:get_pos_xyz() == nil)
+	assert(obj:get_velocity_xyz() == nil)
+end
+unittests.register("test_entity_xyz_getters", test_entity_xyz_getters, {map=true})
+
 local function test_entity_attach(player, pos)
 	log = {}
 
@@ -234,3 +249,36 @@ local function test_get_bone_rot(_, pos)
 	end
 end
 unittests.register("test_get_bone_rot", test_get_bone_rot, {map=true})
+
+-- Clearing the objects from on_step removes entities whose step is not done
+local clear_objects_cb
+core.register_entity("unittests:clear_objects", {
+	initial_properties = {
+		static_save = false,
+	},
+	on_step = function(self)
+		if clear_objects_cb then
+			core.clear_objects({mode = "quick"})
+			-- The rest of the server step runs before this
+			core.after(0, clear_objects_cb)
+			clear_objects_cb = nil
+		end
+	end,
+})
+
+local function test_clear_objects_in_on_step(cb, _, pos)
+	local objs = {}
+	for i = 1, 3 do
+		objs[i] = core.add_entity(pos, "unittests:clear_objects")
+	end
+	clear_objects_cb = function()
+		for _, obj in ipairs(objs) do
+			if obj:is_valid() then
+				return cb("Entity was not cleared")
+			end
+		end
+		cb()
+	end
+end
+unittests.register("test_clear_objects_in_on_step", test_clear_objects_in_on_step,
+	{map=true, async=true})
@@ -70,6 +70,17 @@ local function test_metadata(meta)
 	meta:set_float("j", 0 / 0)
 	assert(core.is_nan(meta:get_float("j")))
 
+	meta:set_many({a = "x", b = 5, k = "new", c = ""})
+	local values = meta:get_many({"a", "b", "c", "k", "missing"})
+	assert(values.a == "x" and values.b == "5" and values.k == "new")
+	assert(values.c == "" and values.missing == "")
+	assert(not meta:contains("c"))
+
+	-- numeric keys are converted like in set_string
+	meta:set_many({[1] = "one", [2] = "two", x = "y"})
+	assert(meta:get_string("1") == "one" and meta:get_string("2") == "two")
+	assert(meta:get_string("x") == "y")
+
 	meta:from_table()
 	assert(next(meta:to_table().fields) == nil)
 	assert(#meta:get_keys() == 0)
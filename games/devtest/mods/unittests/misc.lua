@@ -118,6 +118,55 @@ local function test_node_callbacks(_, pos)
 end
 unittests.register("test_node_callbacks", test_node_callbacks, {map=true})
 
+local function test_bulk_node_queries(_, pos)
+	local minp, maxp = pos:subtract(1), pos:add(1)
+	local area = VoxelArea(minp, maxp)
+	local dirt = {pos, pos:offset(0, -1, 0), pos:offset(1, 0, 1)}
+	for x = minp.x, maxp.x do
+	for y = minp.y, maxp.y do
+	for z = minp.z, maxp.z do
+		core.set_node(vector.new(x, y, z), {name="air"})
+	end
+	end
+	end
+	core.bulk_set_node(dirt, {name="basenodes:dirt"})
+
+	-- Reuse a buffer with more entries than results
+	local buffer = {}
+	for i = 1, 10 do
+		buffer[i] = 0
+	end
+	local indices, count = core.find_nodes_in_area_indices(maxp, minp,
+		"basenodes:dirt", buffer)
+	assert(indices == buffer)
+	assert(count == #dirt)
+	local found = {}
+	for i = 1, count do
+		found[indices[i]] = true
+	end
+	for _, p in ipairs(dirt) do
+		assert(found[area:indexp(p)])
+	end
+	assert(buffer[count + 1] == 0)
+
+	-- The lower one of the stacked nodes has no air above it
+	indices, count = core.find_nodes_in_area_under_air_indices(minp, maxp,
+		"basenodes:dirt")
+	assert(count == 2)
+
+	local ids = core.get_node_content_ids_in_area(minp, maxp)
+	assert(#ids == area:getVolume())
+	local c_dirt = core.get_content_id("basenodes:dirt")
+	for i in area:iterp(minp, maxp) do
+		assert(ids[i] == (found[i] and c_dirt or core.CONTENT_AIR))
+	end
+
+	for _, p in ipairs(dirt) do
+		core.remove_node(p)
+	end
+end
+unittests.register("test_bulk_node_queries", test_bulk_node_queries, {map=true})
+
 local function test_hashing()
 	local input = "hello\000world"
 	assert(core.sha1(input) == "f85b420f1e43ebf88649dfcab302b898d889606c")
@@ -11,6 +11,7 @@
 
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace irr
 {
@@ -76,9 +77,22 @@ class ISkinnedMesh : public IAnimatedMesh
 	virtual void convertMeshToTangents() = 0;
 
 	//! Allows to enable hardware skinning.
-	/* This feature is not implemented in Irrlicht yet */
+	/** The mesh stays in its static pose, with the joint ids and weights
+	of each vertex stored in its tangent and binormal. Scene nodes pass the
+	joint matrices to the vertex shader through
+	IVideoDriver::setSkinningMatrices().
+	\return True if the mesh is now skinned in hardware. False if it is
+	not animated, is already tangent-mapped or has vertices with more than
+	four joint influences. */
 	virtual bool setHardwareSkinning(bool on) = 0;
 
+	//! Returns whether the mesh is skinned in hardware
+	virtual bool isHardwareSkinned() const = 0;
+
+	//! Gets the joint matrices to skin the static pose with, one per joint
+	/** Valid after skinMesh() was called for the current frame. */
+	virtual void getSkinningMatrices(std::vector<core::matrix4> &matrices) const = 0;
+
 	//! Refreshes vertex data cached in joints such as positions and normals
 	virtual void refreshJointCache() = 0;
 
@@ -156,6 +156,19 @@ class IVideoDriver : public virtual IReferenceCounted
 	\return Matrix describing the transformation. */
 	virtual const core::matrix4 &getTransform(E_TRANSFORMATION_STATE state) const = 0;
 
+	//! Sets the joint matrices used to skin the following draws in a vertex shader.
+	/** Set by scene nodes which leave the skinning of their mesh to the
+	GPU, for the shader callbacks to upload. The matrices are not copied,
+	they must stay valid until reset by passing a count of 0.
+	\param matrices Joint matrices transforming the static pose of the mesh.
+	\param count Number of matrices. */
+	virtual void setSkinningMatrices(const core::matrix4 *matrices, u32 count) = 0;
+
+	//! Returns the joint matrices set by setSkinningMatrices
+	/** \param count Receives the number of matrices, 0 if the following
+	draws are not skinned on the GPU. */
+	virtual const core::matrix4 *getSkinningMatrices(u32 &count) const = 0;
+
 	//! Retrieve the number of image loaders
 	/** \return Number of image loaders */
 	virtual u32 getImageLoaderCount() const = 0;
@@ -349,6 +362,28 @@ class IVideoDriver : public virtual IReferenceCounted
 	actual value of pixels. */
 	virtual u32 getOcclusionQueryResult(scene::ISceneNode *node) const = 0;
 
+	//! Create an occlusion query that is not tied to a scene node.
+	/** Everything drawn between beginOcclusionQuery() and
+	endOcclusionQuery() is counted.
+	\return Handle of the query, or 0 if queries are not supported. */
+	virtual u32 createOcclusionQuery() = 0;
+
+	//! Delete a query created by createOcclusionQuery().
+	virtual void deleteOcclusionQuery(u32 query) = 0;
+
+	//! Start counting the samples that pass the depth test.
+	/** Only one query can be active at a time. */
+	virtual void beginOcclusionQuery(u32 query) = 0;
+
+	//! Stop counting samples for the active query.
+	virtual void endOcclusionQuery() = 0;
+
+	//! Retrieve the result of a query without waiting for the GPU.
+	/** \param samples Receives the number of samples that passed. Any
+	non-zero value means that something was visible.
+	\return False if the result is not available yet. */
+	virtual bool pollOcclusionQuery(u32 query, u32 &samples) = 0;
+
 	//! Create render target.
 	virtual IRenderTarget *addRenderTarget() = 0;
 
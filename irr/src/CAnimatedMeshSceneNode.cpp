@@ -234,6 +234,14 @@ void CAnimatedMeshSceneNode::render()
 
 	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
 
+	// the mesh is shared, so the joint matrices are taken while it is in our pose
+	const bool hardwareSkinned = Mesh->getMeshType() == EAMT_SKINNED &&
+			static_cast<CSkinnedMesh *>(Mesh)->isHardwareSkinned();
+	if (hardwareSkinned) {
+		static_cast<CSkinnedMesh *>(Mesh)->getSkinningMatrices(SkinningMatrices);
+		driver->setSkinningMatrices(SkinningMatrices.data(), SkinningMatrices.size());
+	}
+
 	for (u32 i = 0; i < m->getMeshBufferCount(); ++i) {
 		const bool transparent = driver->needsTransparentRenderPass(Materials[i]);
 
@@ -252,6 +260,9 @@ void CAnimatedMeshSceneNode::render()
 		}
 	}
 
+	if (hardwareSkinned)
+		driver->setSkinningMatrices(nullptr, 0);
+
 	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
 
 	// for debug purposes only:
@@ -9,6 +9,8 @@
 
 #include "matrix4.h"
 
+#include <vector>
+
 namespace irr
 {
 namespace scene
@@ -171,6 +173,9 @@ class CAnimatedMeshSceneNode : public IAnimatedMeshSceneNode
 
 	core::array<IBoneSceneNode *> JointChildSceneNodes;
 	core::array<core::matrix4> PretransitingSave;
+
+	//! Joint matrices for meshes skinned in the vertex shader
+	std::vector<core::matrix4> SkinningMatrices;
 };
 
 } // end namespace scene
@@ -262,6 +262,18 @@ const core::matrix4 &CNullDriver::getTransform(E_TRANSFORMATION_STATE state) con
 	return TransformationMatrix;
 }
 
+void CNullDriver::setSkinningMatrices(const core::matrix4 *matrices, u32 count)
+{
+	SkinningMatrices = count ? matrices : nullptr;
+	SkinningMatrixCount = count;
+}
+
+const core::matrix4 *CNullDriver::getSkinningMatrices(u32 &count) const
+{
+	count = SkinningMatrixCount;
+	return SkinningMatrices;
+}
+
 //! sets a material
 void CNullDriver::setMaterial(const SMaterial &material)
 {
@@ -1354,6 +1366,28 @@ u32 CNullDriver::getOcclusionQueryResult(scene::ISceneNode *node) const
 	return ~0;
 }
 
+u32 CNullDriver::createOcclusionQuery()
+{
+	return 0;
+}
+
+void CNullDriver::deleteOcclusionQuery(u32 query)
+{
+}
+
+void CNullDriver::beginOcclusionQuery(u32 query)
+{
+}
+
+void CNullDriver::endOcclusionQuery()
+{
+}
+
+bool CNullDriver::pollOcclusionQuery(u32 query, u32 &samples)
+{
+	return false;
+}
+
 //! Create render target.
 IRenderTarget *CNullDriver::addRenderTarget()
 {
@@ -407,6 +407,16 @@ class CNullDriver : public IVideoDriver, public IGPUProgrammingServices
 	actual value of pixels. */
 	u32 getOcclusionQueryResult(scene::ISceneNode *node) const override;
 
+	u32 createOcclusionQuery() override;
+
+	void deleteOcclusionQuery(u32 query) override;
+
+	void beginOcclusionQuery(u32 query) override;
+
+	void endOcclusionQuery() override;
+
+	bool pollOcclusionQuery(u32 query, u32 &samples) override;
+
 	//! Create render target.
 	IRenderTarget *addRenderTarget() override;
 
@@ -433,6 +443,12 @@ class CNullDriver : public IVideoDriver, public IGPUProgrammingServices
 	//! Returns the transformation set by setTransform
 	const core::matrix4 &getTransform(E_TRANSFORMATION_STATE state) const override;
 
+	//! Sets the joint matrices used to skin the following draws in a vertex shader.
+	void setSkinningMatrices(const core::matrix4 *matrices, u32 count) override;
+
+	//! Returns the joint matrices set by setSkinningMatrices
+	const core::matrix4 *getSkinningMatrices(u32 &count) const override;
+
 	//! Returns pointer to the IGPUProgrammingServices interface.
 	IGPUProgrammingServices *getGPUProgrammingServices() override;
 
@@ -726,6 +742,8 @@ class CNullDriver : public IVideoDriver, public IGPUProgrammingServices
 	core::rect<s32> ViewPort;
 	core::dimension2d<u32> ScreenSize;
 	core::matrix4 TransformationMatrix;
+	const core::matrix4 *SkinningMatrices = nullptr;
+	u32 SkinningMatrixCount = 0;
 
 	CFPSCounter FPSCounter;
 	SFrameStats FrameStats;
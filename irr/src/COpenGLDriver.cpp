@@ -642,6 +642,57 @@ u32 COpenGLDriver::getOcclusionQueryResult(scene::ISceneNode *node) const
 		return ~0;
 }
 
+u32 COpenGLDriver::createOcclusionQuery()
+{
+	if (!queryFeature(EVDF_OCCLUSION_QUERY))
+		return 0;
+
+	GLuint query = 0;
+	extGlGenQueries(1, &query);
+	return query;
+}
+
+void COpenGLDriver::deleteOcclusionQuery(u32 query)
+{
+	const GLuint id = query;
+	if (id != 0)
+		extGlDeleteQueries(1, &id);
+}
+
+void COpenGLDriver::beginOcclusionQuery(u32 query)
+{
+#ifdef GL_ARB_occlusion_query
+	extGlBeginQuery(GL_SAMPLES_PASSED_ARB, query);
+#else
+	extGlBeginQuery(0, query);
+#endif
+}
+
+void COpenGLDriver::endOcclusionQuery()
+{
+#ifdef GL_ARB_occlusion_query
+	extGlEndQuery(GL_SAMPLES_PASSED_ARB);
+#else
+	extGlEndQuery(0);
+#endif
+}
+
+bool COpenGLDriver::pollOcclusionQuery(u32 query, u32 &samples)
+{
+#ifdef GL_ARB_occlusion_query
+	GLuint available = GL_FALSE;
+	extGlGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE_ARB, &available);
+	if (available != GL_TRUE)
+		return false;
+	GLuint result = 0;
+	extGlGetQueryObjectuiv(query, GL_QUERY_RESULT_ARB, &result);
+	samples = result;
+	return true;
+#else
+	return false;
+#endif
+}
+
 //! Create render target.
 IRenderTarget *COpenGLDriver::addRenderTarget()
 {
@@ -105,6 +105,16 @@ class COpenGLDriver : public CNullDriver, public IMaterialRendererServices, publ
 	actual value of pixels. */
 	u32 getOcclusionQueryResult(scene::ISceneNode *node) const override;
 
+	u32 createOcclusionQuery() override;
+
+	void deleteOcclusionQuery(u32 query) override;
+
+	void beginOcclusionQuery(u32 query) override;
+
+	void endOcclusionQuery() override;
+
+	bool pollOcclusionQuery(u32 query, u32 &samples) override;
+
 	//! Create render target.
 	IRenderTarget *addRenderTarget() override;
 
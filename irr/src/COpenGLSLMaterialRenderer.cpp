@@ -421,6 +421,11 @@ bool COpenGLSLMaterialRenderer::linkProgram()
 			ui.name = buf;
 			ui.location = Driver->extGlGetUniformLocation(Program2, buf);
 
+			// arrays are reported as "name[0]", look them up by their plain name
+			s32 bracket = ui.name.findFirst('[');
+			if (bracket >= 0)
+				ui.name = ui.name.subString(0, bracket);
+
 			UniformInfo.push_back(ui);
 		}
 
@@ -491,6 +496,10 @@ bool COpenGLSLMaterialRenderer::linkProgram()
 			ui.name = buf;
 			ui.location = Driver->extGlGetUniformLocationARB(Program, buf);
 
+			s32 bracket = ui.name.findFirst('[');
+			if (bracket >= 0)
+				ui.name = ui.name.subString(0, bracket);
+
 			UniformInfo.push_back(ui);
 		}
 
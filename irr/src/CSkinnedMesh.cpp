@@ -3,6 +3,7 @@
 // For conditions of distribution and use, see copyright notice in irrlicht.h
 
 #include "CSkinnedMesh.h"
+#include <map>
 #include <optional>
 #include "CBoneSceneNode.h"
 #include "IAnimatedMeshSceneNode.h"
@@ -464,18 +465,19 @@ void CSkinnedMesh::skinMesh()
 	//-----------------
 
 	SkinnedLastFrame = true;
+
+	// rigid animation
+	for (u32 i = 0; i < AllJoints.size(); ++i) {
+		for (u32 j = 0; j < AllJoints[i]->AttachedMeshes.size(); ++j) {
+			SSkinMeshBuffer *Buffer = (*SkinningBuffers)[AllJoints[i]->AttachedMeshes[j]];
+			Buffer->Transformation = AllJoints[i]->GlobalAnimatedMatrix;
+		}
+	}
+
 	if (!HardwareSkinning) {
 		// Software skin....
 		u32 i;
 
-		// rigid animation
-		for (i = 0; i < AllJoints.size(); ++i) {
-			for (u32 j = 0; j < AllJoints[i]->AttachedMeshes.size(); ++j) {
-				SSkinMeshBuffer *Buffer = (*SkinningBuffers)[AllJoints[i]->AttachedMeshes[j]];
-				Buffer->Transformation = AllJoints[i]->GlobalAnimatedMatrix;
-			}
-		}
-
 		// clear skinning helper array
 		for (i = 0; i < Vertices_Moved.size(); ++i)
 			for (u32 j = 0; j < Vertices_Moved[i].size(); ++j)
@@ -691,28 +693,118 @@ const core::array<CSkinnedMesh::SJoint *> &CSkinnedMesh::getAllJoints() const
 	return AllJoints;
 }
 
-//! (This feature is not implemented in irrlicht yet)
+//! Leaves the skinning to a vertex shader
+/** The buffers are converted to tangent vertices in their static pose, with
+up to four joint influences per vertex stored in place of the tangent frame:
+the joint ids packed in pairs (id0 * 256 + id1, id2 * 256 + id3) into the
+tangent's X and Y, the weights of joints 0-2 into the binormal and the
+weight of joint 3 into the tangent's Z. */
 bool CSkinnedMesh::setHardwareSkinning(bool on)
 {
-	if (HardwareSkinning != on) {
-		if (on) {
-
-			// set mesh to static pose...
-			for (u32 i = 0; i < AllJoints.size(); ++i) {
-				SJoint *joint = AllJoints[i];
-				for (u32 j = 0; j < joint->Weights.size(); ++j) {
-					const u16 buffer_id = joint->Weights[j].buffer_id;
-					const u32 vertex_id = joint->Weights[j].vertex_id;
-					LocalBuffers[buffer_id]->getVertex(vertex_id)->Pos = joint->Weights[j].StaticPos;
-					LocalBuffers[buffer_id]->getVertex(vertex_id)->Normal = joint->Weights[j].StaticNormal;
-					LocalBuffers[buffer_id]->boundingBoxNeedsRecalculated();
-				}
-			}
+	if (HardwareSkinning == on)
+		return HardwareSkinning;
+
+	if (!on) {
+		// the software skinning overwrites the static pose again
+		HardwareSkinning = false;
+		HardwareSkinnedBoxes.clear();
+		SkinnedLastFrame = false;
+		return false;
+	}
+
+	// static meshes and already tangent-mapped buffers are left alone,
+	// as are joint ids that do not fit the packing
+	if (!HasAnimation || !PreparedForSkinning || AllJoints.size() > 256)
+		return false;
+	for (u32 i = 0; i < LocalBuffers.size(); ++i) {
+		if (LocalBuffers[i]->getVertexType() == video::EVT_TANGENTS)
+			return false;
+	}
+
+	struct SInfluences
+	{
+		u32 joints[4] = {};
+		f32 weights[4] = {};
+		u8 count = 0;
+	};
+	std::vector<std::vector<SInfluences>> influences(LocalBuffers.size());
+	for (u32 i = 0; i < LocalBuffers.size(); ++i)
+		influences[i].resize(LocalBuffers[i]->getVertexCount());
+
+	for (u32 i = 0; i < AllJoints.size(); ++i) {
+		const SJoint *joint = AllJoints[i];
+		for (u32 j = 0; j < joint->Weights.size(); ++j) {
+			const SWeight &weight = joint->Weights[j];
+			SInfluences &vertex = influences[weight.buffer_id][weight.vertex_id];
+			if (vertex.count == 4)
+				return false; // needs software skinning
+			vertex.joints[vertex.count] = i;
+			vertex.weights[vertex.count] = weight.strength;
+			++vertex.count;
 		}
+	}
 
-		HardwareSkinning = on;
+	// set mesh to static pose...
+	for (u32 i = 0; i < AllJoints.size(); ++i) {
+		SJoint *joint = AllJoints[i];
+		for (u32 j = 0; j < joint->Weights.size(); ++j) {
+			const u16 buffer_id = joint->Weights[j].buffer_id;
+			const u32 vertex_id = joint->Weights[j].vertex_id;
+			LocalBuffers[buffer_id]->getVertex(vertex_id)->Pos = joint->Weights[j].StaticPos;
+			LocalBuffers[buffer_id]->getVertex(vertex_id)->Normal = joint->Weights[j].StaticNormal;
+		}
+	}
+
+	// ...and store the influences in the vertices
+	HardwareSkinnedBoxes.clear();
+	for (u32 i = 0; i < LocalBuffers.size(); ++i) {
+		SSkinMeshBuffer *buffer = LocalBuffers[i];
+		buffer->convertToTangents();
+
+		// the unweighted vertices are collected under an invalid joint id
+		std::map<u32, core::aabbox3df> boxes;
+		auto addToBox = [&boxes](u32 joint_id, const core::vector3df &pos) {
+			auto it = boxes.find(joint_id);
+			if (it == boxes.end())
+				boxes.emplace(joint_id, core::aabbox3df(pos));
+			else
+				it->second.addInternalPoint(pos);
+		};
+		for (u32 v = 0; v < buffer->getVertexCount(); ++v) {
+			video::S3DVertexTangents &vertex = buffer->Vertices_Tangents->Data[v];
+			const SInfluences &vertex_influences = influences[i][v];
+			const u32 *joints = vertex_influences.joints;
+			const f32 *weights = vertex_influences.weights;
+			vertex.Tangent.set(joints[0] * 256 + joints[1],
+					joints[2] * 256 + joints[3], weights[3]);
+			vertex.Binormal.set(weights[0], weights[1], weights[2]);
+
+			if (vertex_influences.count == 0)
+				addToBox(AllJoints.size(), vertex.Pos);
+			for (u8 j = 0; j < vertex_influences.count; ++j)
+				addToBox(joints[j], vertex.Pos);
+		}
+		for (const auto &it : boxes)
+			HardwareSkinnedBoxes.push_back({static_cast<u16>(i), it.first, it.second});
+
+		buffer->boundingBoxNeedsRecalculated();
+		buffer->recalculateBoundingBox();
+		buffer->setDirty(EBT_VERTEX);
+	}
+
+	HardwareSkinning = true;
+	SkinnedLastFrame = false;
+	return true;
+}
+
+void CSkinnedMesh::getSkinningMatrices(std::vector<core::matrix4> &matrices) const
+{
+	matrices.resize(AllJoints.size());
+	for (u32 i = 0; i < AllJoints.size(); ++i) {
+		const SJoint *joint = AllJoints[i];
+		matrices[i].setbyproduct_nocheck(joint->GlobalAnimatedMatrix,
+				joint->GlobalInversedMatrix.value_or(core::IdentityMatrix));
 	}
-	return HardwareSkinning;
 }
 
 void CSkinnedMesh::refreshJointCache()
@@ -1051,6 +1143,11 @@ void CSkinnedMesh::updateBoundingBox(void)
 	if (!SkinningBuffers)
 		return;
 
+	if (HardwareSkinning) {
+		updateHardwareSkinnedBoundingBox();
+		return;
+	}
+
 	core::array<SSkinMeshBuffer *> &buffer = *SkinningBuffers;
 	BoundingBox.reset(0, 0, 0);
 
@@ -1065,6 +1162,33 @@ void CSkinnedMesh::updateBoundingBox(void)
 	}
 }
 
+//! Bounds the skinned vertices without touching them: every vertex is a
+//! weighted average of its static position pulled by its joints, so it lies
+//! within the pulled static boxes.
+void CSkinnedMesh::updateHardwareSkinnedBoundingBox()
+{
+	BoundingBox.reset(0, 0, 0);
+
+	bool first = true;
+	for (const SSkinnedBox &skinned : HardwareSkinnedBoxes) {
+		core::aabbox3df bb = skinned.box;
+		if (skinned.joint_id < AllJoints.size()) {
+			const SJoint *joint = AllJoints[skinned.joint_id];
+			core::matrix4 jointVertexPull;
+			jointVertexPull.setbyproduct_nocheck(joint->GlobalAnimatedMatrix,
+					joint->GlobalInversedMatrix.value_or(core::IdentityMatrix));
+			jointVertexPull.transformBoxEx(bb);
+		}
+		LocalBuffers[skinned.buffer_id]->Transformation.transformBoxEx(bb);
+
+		if (first)
+			BoundingBox = bb;
+		else
+			BoundingBox.addInternalBox(bb);
+		first = false;
+	}
+}
+
 scene::SSkinMeshBuffer *CSkinnedMesh::addMeshBuffer()
 {
 	scene::SSkinMeshBuffer *buffer = new scene::SSkinMeshBuffer();
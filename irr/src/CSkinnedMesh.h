@@ -108,9 +108,15 @@ class CSkinnedMesh : public ISkinnedMesh
 	//! Does the mesh have no animation
 	bool isStatic() override;
 
-	//! (This feature is not implemented in irrlicht yet)
+	//! Leaves the skinning to a vertex shader
 	bool setHardwareSkinning(bool on) override;
 
+	//! Returns whether the skinning is left to a vertex shader
+	bool isHardwareSkinned() const override { return HardwareSkinning; }
+
+	//! Gets the joint matrices to skin the static pose with
+	void getSkinningMatrices(std::vector<core::matrix4> &matrices) const override;
+
 	//! Refreshes vertex data cached in joints such as positions and normals
 	void refreshJointCache() override;
 
@@ -185,6 +191,8 @@ class CSkinnedMesh : public ISkinnedMesh
 
 	void skinJoint(SJoint *Joint, SJoint *ParentJoint);
 
+	void updateHardwareSkinnedBoundingBox();
+
 	void calculateTangents(core::vector3df &normal,
 			core::vector3df &tangent, core::vector3df &binormal,
 			const core::vector3df &vt1, const core::vector3df &vt2, const core::vector3df &vt3,
@@ -205,6 +213,15 @@ class CSkinnedMesh : public ISkinnedMesh
 
 	core::aabbox3d<f32> BoundingBox;
 
+	//! Static pose box of the vertices a joint pulls in a buffer, for hardware skinning
+	struct SSkinnedBox
+	{
+		u16 buffer_id;
+		u32 joint_id; // no joint for vertices without weights
+		core::aabbox3df box;
+	};
+	std::vector<SSkinnedBox> HardwareSkinnedBoxes;
+
 	f32 EndFrame;
 	f32 FramesPerSecond;
 
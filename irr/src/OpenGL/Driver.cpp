@@ -675,6 +675,45 @@ IRenderTarget *COpenGL3DriverBase::addRenderTarget()
 	return renderTarget;
 }
 
+u32 COpenGL3DriverBase::createOcclusionQuery()
+{
+	if (!queryFeature(EVDF_OCCLUSION_QUERY))
+		return 0;
+
+	GLuint query = 0;
+	GL.GenQueries(1, &query);
+	return query;
+}
+
+void COpenGL3DriverBase::deleteOcclusionQuery(u32 query)
+{
+	const GLuint id = query;
+	if (id != 0)
+		GL.DeleteQueries(1, &id);
+}
+
+void COpenGL3DriverBase::beginOcclusionQuery(u32 query)
+{
+	GL.BeginQuery(OcclusionQueryTarget, query);
+}
+
+void COpenGL3DriverBase::endOcclusionQuery()
+{
+	GL.EndQuery(OcclusionQueryTarget);
+}
+
+bool COpenGL3DriverBase::pollOcclusionQuery(u32 query, u32 &samples)
+{
+	GLuint available = GL_FALSE;
+	GL.GetQueryObjectuiv(query, GL.QUERY_RESULT_AVAILABLE, &available);
+	if (available != GL_TRUE)
+		return false;
+	GLuint result = 0;
+	GL.GetQueryObjectuiv(query, GL.QUERY_RESULT, &result);
+	samples = result;
+	return true;
+}
+
 //! draws a vertex primitive list
 void COpenGL3DriverBase::drawVertexPrimitiveList(const void *vertices, u32 vertexCount,
 		const void *indexList, u32 primitiveCount,
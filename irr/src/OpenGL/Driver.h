@@ -74,6 +74,16 @@ class COpenGL3DriverBase : public CNullDriver, public IMaterialRendererServices,
 
 	IRenderTarget *addRenderTarget() override;
 
+	u32 createOcclusionQuery() override;
+
+	void deleteOcclusionQuery(u32 query) override;
+
+	void beginOcclusionQuery(u32 query) override;
+
+	void endOcclusionQuery() override;
+
+	bool pollOcclusionQuery(u32 query, u32 &samples) override;
+
 	//! draws a vertex primitive list
 	virtual void drawVertexPrimitiveList(const void *vertices, u32 vertexCount,
 			const void *indexList, u32 primitiveCount,
@@ -70,8 +70,9 @@ class COpenGL3ExtensionHandler : public COGLESCoreExtensionHandler
 		case EVDF_MRT_BLEND:
 		case EVDF_MRT_COLOR_MASK:
 		case EVDF_MRT_BLEND_FUNC:
-		case EVDF_OCCLUSION_QUERY:
 			return false;
+		case EVDF_OCCLUSION_QUERY:
+			return OcclusionQuerySupported;
 		case EVDF_STENCIL_BUFFER:
 			return StencilBuffer;
 		default:
@@ -161,6 +162,8 @@ class COpenGL3ExtensionHandler : public COGLESCoreExtensionHandler
 
 	bool AnisotropicFilterSupported = false;
 	bool BlendMinMaxSupported = false;
+	bool OcclusionQuerySupported = false;
+	GLenum OcclusionQueryTarget = GL_NONE;
 };
 
 }
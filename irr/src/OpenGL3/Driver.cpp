@@ -58,6 +58,10 @@ void COpenGL3Driver::initFeatures()
 
 	AnisotropicFilterSupported = isVersionAtLeast(4, 6) || queryExtension("GL_ARB_texture_filter_anisotropic") || queryExtension("GL_EXT_texture_filter_anisotropic");
 	BlendMinMaxSupported = true;
+	OcclusionQuerySupported = true;
+	// Only visibility matters, so prefer the cheaper boolean query
+	OcclusionQueryTarget = isVersionAtLeast(3, 3) || queryExtension("GL_ARB_occlusion_query2") ?
+			GL.ANY_SAMPLES_PASSED : GL.SAMPLES_PASSED;
 
 	// COGLESCoreExtensionHandler::Feature
 	static_assert(MATERIAL_MAX_TEXTURES <= 16, "Only up to 16 textures are guaranteed");
@@ -109,6 +109,8 @@ void COpenGLES2Driver::initFeatures()
 	AnisotropicFilterSupported = queryExtension("GL_EXT_texture_filter_anisotropic");
 	BlendMinMaxSupported = (Version.Major >= 3) || FeatureAvailable[IRR_GL_EXT_blend_minmax];
 	const bool TextureLODBiasSupported = queryExtension("GL_EXT_texture_lod_bias");
+	OcclusionQuerySupported = Version.Major >= 3;
+	OcclusionQueryTarget = GL.ANY_SAMPLES_PASSED;
 
 	// COGLESCoreExtensionHandler::Feature
 	static_assert(MATERIAL_MAX_TEXTURES <= 8, "Only up to 8 textures are guaranteed");
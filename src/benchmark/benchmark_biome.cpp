@@ -0,0 +1,155 @@
+// Luanti
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (C) 2024 Luanti Authors
+
+#include "catch.h"
+#include "mapgen/mg_biome.h"
+#include "unittest/mock_server.h"
+#include "noise.h"
+
+#include <cfloat>
+
+namespace {
+
+constexpr s16 CHUNK_SIZE = 80;
+
+// The lookup as it was implemented before BiomeGenOriginal got its
+// acceleration structure, kept here as reference.
+Biome *calcBiomeLinear(const BiomeManager *bmgr, float heat, float humidity, v3s16 pos)
+{
+	Biome *biome_closest = nullptr;
+	Biome *biome_closest_blend = nullptr;
+	float dist_min = FLT_MAX;
+	float dist_min_blend = FLT_MAX;
+
+	for (size_t i = 1; i < bmgr->getNumObjects(); i++) {
+		Biome *b = (Biome *)bmgr->getRaw(i);
+		if (!b ||
+				pos.Y < b->min_pos.Y || pos.Y > b->max_pos.Y + b->vertical_blend ||
+				pos.X < b->min_pos.X || pos.X > b->max_pos.X ||
+				pos.Z < b->min_pos.Z || pos.Z > b->max_pos.Z)
+			continue;
+
+		float d_heat = heat - b->heat_point;
+		float d_humidity = humidity - b->humidity_point;
+		float dist = (d_heat * d_heat) + (d_humidity * d_humidity);
+
+		if (pos.Y <= b->max_pos.Y) {
+			if (dist < dist_min) {
+				dist_min = dist;
+				biome_closest = b;
+			}
+		} else if (dist < dist_min_blend) {
+			dist_min_blend = dist;
+			biome_closest_blend = b;
+		}
+	}
+
+	const u64 seed = static_cast<s64>(pos.Y + (heat + humidity) * 0.9f);
+	PcgRandom rng(seed);
+
+	if (biome_closest_blend && dist_min_blend <= dist_min &&
+			rng.range(0, biome_closest_blend->vertical_blend) >=
+			pos.Y - biome_closest_blend->max_pos.Y)
+		return biome_closest_blend;
+
+	return (biome_closest) ? biome_closest : (Biome *)bmgr->getRaw(BIOME_NONE);
+}
+
+// Registers biomes laid out like a large game: a grid of climates, each
+// split into an underground, ocean, beach and land layer.
+void fillBiomes(BiomeManager *bmgr, int climates)
+{
+	PcgRandom rng(1234);
+	static const s16 layers[][3] = {
+		// y_min, y_max, vertical_blend
+		{-31000, -256, 0},
+		{-255, -2, 0},
+		{-1, 3, 1},
+		{4, 31000, 8},
+	};
+	for (int i = 0; i < climates; i++) {
+		float heat = rng.range(-20, 120);
+		float humidity = rng.range(-20, 120);
+		for (const auto &layer : layers) {
+			Biome *b = new Biome;
+			b->name = "biome_" + std::to_string(bmgr->getNumObjects());
+			b->flags = 0;
+			b->min_pos = v3s16(-31000, layer[0], -31000);
+			b->max_pos = v3s16(31000, layer[1], 31000);
+			b->vertical_blend = layer[2];
+			b->heat_point = heat;
+			b->humidity_point = humidity;
+			bmgr->add(b);
+		}
+	}
+	// A few horizontally limited biomes
+	for (int i = 0; i < climates / 8; i++) {
+		Biome *b = new Biome;
+		b->name = "biome_" + std::to_string(bmgr->getNumObjects());
+		b->flags = 0;
+		b->min_pos = v3s16(rng.range(-400, 0), -100, rng.range(-400, 0));
+		b->max_pos = v3s16(rng.range(0, 400), 200, rng.range(0, 400));
+		b->vertical_blend = 4;
+		b->heat_point = rng.range(-20, 120);
+		b->humidity_point = rng.range(-20, 120);
+		bmgr->add(b);
+	}
+}
+
+void benchBiomeLookup(int climates)
+{
+	MockServer server;
+	BiomeManager bmgr(&server);
+	fillBiomes(&bmgr, climates);
+
+	BiomeParamsOriginal params;
+	params.seed = 42;
+	const v3s16 csize(CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE);
+	BiomeGenOriginal biomegen(&bmgr, &params, csize);
+
+	const v3s16 pmin(-32, -32, -32);
+	biomegen.calcBiomeNoise(pmin);
+
+	std::vector<s16> heightmap(CHUNK_SIZE * CHUNK_SIZE);
+	PcgRandom rng(5678);
+	for (auto &h : heightmap)
+		h = rng.range(-300, 300);
+
+	for (s16 zr = 0; zr < CHUNK_SIZE; zr++)
+	for (s16 xr = 0; xr < CHUNK_SIZE; xr++) {
+		s32 i = zr * CHUNK_SIZE + xr;
+		v3s16 pos(pmin.X + xr, heightmap[i], pmin.Z + zr);
+		REQUIRE(biomegen.getBiomeAtIndex(i, pos) == calcBiomeLinear(&bmgr,
+			biomegen.heatmap[i], biomegen.humidmap[i], pos));
+	}
+
+	const std::string suffix = " (" + std::to_string(bmgr.getNumObjects()) + " biomes)";
+
+	BENCHMARK_ADVANCED("linear scan" + suffix)(Catch::Benchmark::Chronometer meter) {
+		meter.measure([&] {
+			size_t x = 0;
+			for (s16 zr = 0; zr < CHUNK_SIZE; zr++)
+			for (s16 xr = 0; xr < CHUNK_SIZE; xr++) {
+				s32 i = zr * CHUNK_SIZE + xr;
+				x += calcBiomeLinear(&bmgr, biomegen.heatmap[i], biomegen.humidmap[i],
+					v3s16(pmin.X + xr, heightmap[i], pmin.Z + zr))->index;
+			}
+			return x;
+		});
+	};
+
+	BENCHMARK_ADVANCED("BiomeGenOriginal::getBiomes" + suffix)(Catch::Benchmark::Chronometer meter) {
+		meter.measure([&] {
+			return biomegen.getBiomes(heightmap.data(), pmin)[0];
+		});
+	};
+}
+
+}
+
+TEST_CASE("benchmark_biome")
+{
+	benchBiomeLookup(4);
+	benchBiomeLookup(40);
+}
@@ -6,6 +6,8 @@
 #include "voxelalgorithms.h"
 #include "dummygamedef.h"
 #include "dummymap.h"
+#include "mapgen/mapgen.h"
+#include "noise.h"
 
 TEST_CASE("benchmark_lighting")
 {
@@ -69,3 +71,119 @@ TEST_CASE("benchmark_lighting")
 		});
 	};
 }
+
+TEST_CASE("benchmark_mapgen_lighting")
+{
+	DummyGameDef gamedef;
+	NodeDefManager *ndef = gamedef.getWritableNodeDefManager();
+
+	v3s16 bpmin(-3, -3, -3), bpmax(2, 2, 2);
+	DummyMap map(&gamedef, bpmin, bpmax);
+
+	content_t content_wall;
+	{
+		ContentFeatures f;
+		f.name = "stone";
+		content_wall = ndef->set(f.name, f);
+	}
+
+	content_t content_light;
+	{
+		ContentFeatures f;
+		f.name = "light";
+		f.param_type = CPT_LIGHT;
+		f.light_propagates = true;
+		f.light_source = 14;
+		content_light = ndef->set(f.name, f);
+	}
+
+	MMVManip vm(&map);
+	vm.initialEmerge(bpmin, bpmax, false);
+
+	// Hilly terrain riddled with caves, with scattered light sources
+	PcgRandom pr(42);
+	const VoxelArea &area = vm.m_area;
+	for (s16 z = area.MinEdge.Z; z <= area.MaxEdge.Z; z++)
+	for (s16 y = area.MinEdge.Y; y <= area.MaxEdge.Y; y++)
+	for (s16 x = area.MinEdge.X; x <= area.MaxEdge.X; x++) {
+		float ground = 8.0f * std::sin(x * 0.1f) * std::cos(z * 0.13f);
+		bool cave = std::sin(x * 0.3f) + std::sin(y * 0.25f) + std::sin(z * 0.2f) > 1.5f;
+		content_t c = CONTENT_AIR;
+		if (y < ground && !cave)
+			c = pr.range(0, 500) == 0 ? content_light : content_wall;
+		vm.m_data[area.index(x, y, z)] = MapNode(c);
+	}
+
+	Mapgen mg;
+	mg.vm = &vm;
+	mg.ndef = ndef;
+
+	const v3s16 nmin = area.MinEdge + v3s16(1, 1, 1) * MAP_BLOCKSIZE;
+	const v3s16 nmax = area.MaxEdge - v3s16(1, 1, 1) * MAP_BLOCKSIZE;
+
+	BENCHMARK_ADVANCED("Mapgen::calcLighting")(Catch::Benchmark::Chronometer meter) {
+		meter.measure([&] {
+			mg.setLighting(0, area.MinEdge, area.MaxEdge);
+			mg.calcLighting(nmin - v3s16(0, 1, 0), nmax + v3s16(0, 1, 0),
+				area.MinEdge, area.MaxEdge);
+		});
+	};
+}
+
+TEST_CASE("benchmark_lighting_batch")
+{
+	DummyGameDef gamedef;
+	NodeDefManager *ndef = gamedef.getWritableNodeDefManager();
+
+	v3s16 bpmin(-2, -2, -2), bpmax(1, 1, 1);
+	DummyMap map(&gamedef, bpmin, bpmax);
+
+	content_t content_wall;
+	{
+		ContentFeatures f;
+		f.name = "stone";
+		content_wall = ndef->set(f.name, f);
+	}
+
+	// Open area above a stone floor
+	{
+		std::map<v3s16, MapBlock*> modified_blocks;
+		MMVManip vm(&map);
+		vm.initialEmerge(bpmin, bpmax, false);
+		const VoxelArea &area = vm.m_area;
+		for (s16 z = area.MinEdge.Z; z <= area.MaxEdge.Z; z++)
+		for (s16 y = area.MinEdge.Y; y <= area.MaxEdge.Y; y++)
+		for (s16 x = area.MinEdge.X; x <= area.MaxEdge.X; x++)
+			vm.m_data[area.index(x, y, z)] = MapNode(y < 0 ? content_wall : CONTENT_AIR);
+		voxalgo::blit_back_with_light(&map, &vm, &modified_blocks);
+	}
+
+	// Build and remove a 16x16 roof, like bulk_set_node would
+	auto build_roof = [&] (content_t c, std::map<v3s16, MapBlock*> &modified_blocks) {
+		for (s16 z = -8; z < 8; z++)
+		for (s16 x = -8; x < 8; x++)
+			map.addNodeAndUpdate(v3s16(x, 8, z), MapNode(c), modified_blocks);
+	};
+
+	BENCHMARK_ADVANCED("addNodeAndUpdate")(Catch::Benchmark::Chronometer meter) {
+		std::map<v3s16, MapBlock*> modified_blocks;
+		meter.measure([&] {
+			build_roof(content_wall, modified_blocks);
+			build_roof(CONTENT_AIR, modified_blocks);
+		});
+	};
+
+	BENCHMARK_ADVANCED("addNodeAndUpdate batched")(Catch::Benchmark::Chronometer meter) {
+		std::map<v3s16, MapBlock*> modified_blocks;
+		meter.measure([&] {
+			{
+				MapLightUpdateBatch light_batch(&map);
+				build_roof(content_wall, modified_blocks);
+			}
+			{
+				MapLightUpdateBatch light_batch(&map);
+				build_roof(CONTENT_AIR, modified_blocks);
+			}
+		});
+	};
+}
@@ -0,0 +1,80 @@
+// Luanti
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (C) 2024 Luanti Authors
+
+#include "catch.h"
+#include "nodetimer.h"
+#include "constants.h"
+#include <vector>
+
+// 100 timers in each of 1000 blocks
+static constexpr u32 NUM_BLOCKS = 1000;
+static constexpr u32 TIMERS_PER_BLOCK = 100;
+
+static v3s16 timerPos(u32 i)
+{
+	return v3s16(i % MAP_BLOCKSIZE, (i / MAP_BLOCKSIZE) % MAP_BLOCKSIZE,
+		i / (MAP_BLOCKSIZE * MAP_BLOCKSIZE));
+}
+
+// Timeouts between 1 and 10 seconds, like most game timers
+static f32 timerTimeout(u32 block, u32 i)
+{
+	return 1.0f + ((block * 7 + i * 13) % 90) * 0.1f;
+}
+
+static void fillTimers(std::vector<NodeTimerList> &lists)
+{
+	lists.clear();
+	lists.resize(NUM_BLOCKS);
+	for (u32 b = 0; b < NUM_BLOCKS; b++) {
+		for (u32 i = 0; i < TIMERS_PER_BLOCK; i++)
+			lists[b].set(NodeTimer(timerTimeout(b, i), 0.0f, timerPos(i)));
+	}
+}
+
+// Steps all blocks like ServerEnvironment does, restarting the elapsed timers
+// like most on_timer callbacks do
+static u32 stepTimers(std::vector<NodeTimerList> &lists, float dtime)
+{
+	u32 count = 0;
+	for (NodeTimerList &list : lists) {
+		std::vector<NodeTimer> elapsed = list.step(dtime);
+		for (const NodeTimer &t : elapsed)
+			list.set(NodeTimer(t.timeout, 0.0f, t.position));
+		count += elapsed.size();
+	}
+	return count;
+}
+
+TEST_CASE("benchmark_nodetimer")
+{
+	std::vector<NodeTimerList> lists;
+
+	BENCHMARK_ADVANCED("set_100k")(Catch::Benchmark::Chronometer meter) {
+		meter.measure([&] {
+			fillTimers(lists);
+			return lists.size();
+		});
+	};
+
+	fillTimers(lists);
+
+	BENCHMARK_ADVANCED("step_100k")(Catch::Benchmark::Chronometer meter) {
+		// Server step length
+		meter.measure([&] {
+			return stepTimers(lists, 0.09f);
+		});
+	};
+
+	BENCHMARK_ADVANCED("get_100k")(Catch::Benchmark::Chronometer meter) {
+		meter.measure([&] {
+			f32 sum = 0;
+			for (const NodeTimerList &list : lists) {
+				for (u32 i = 0; i < TIMERS_PER_BLOCK; i++)
+					sum += list.get(timerPos(i)).elapsed;
+			}
+			return sum;
+		});
+	};
+}
@@ -450,11 +450,18 @@ void Client::step(float dtime)
 	*/
 	const float map_timer_and_unload_dtime = 5.25;
 	if(m_map_timer_and_unload_interval.step(dtime, map_timer_and_unload_dtime)) {
+		s32 mapblock_limit = g_settings->getS32("client_mapblock_limit");
+		// Far terrain is cheap to draw when it is simplified, so don't let
+		// the limit cut down the viewing range by unloading the blocks in view
+		if (mapblock_limit >= 0 && g_settings->getU16("lod_distance") > 0) {
+			mapblock_limit = std::max<s32>(mapblock_limit,
+				m_env.getClientMap().getDrawListBlockCount() * 5 / 4);
+		}
+
 		std::vector<v3s16> deleted_blocks;
 		m_env.getMap().timerUpdate(map_timer_and_unload_dtime,
 			std::max(g_settings->getFloat("client_unload_unused_data_timeout"), 0.0f),
-			g_settings->getS32("client_mapblock_limit"),
-			&deleted_blocks);
+			mapblock_limit, &deleted_blocks);
 
 		/*
 			Send info to server
@@ -636,8 +643,10 @@ void Client::step(float dtime)
 				sendGotBlocks(blocks_to_ack);
 		}
 
-		if (num_processed_meshes > 0)
+		if (num_processed_meshes > 0) {
 			g_profiler->graphAdd("num_processed_meshes", num_processed_meshes);
+			m_env.getClientMap().invalidateDrawList();
+		}
 
 		auto shadow_renderer = RenderingEngine::get_shadow_renderer();
 		if (shadow_renderer && force_update_shadows)
@@ -1861,6 +1870,16 @@ void Client::afterContentReceived()
 	tu_args.tsrc = m_tsrc;
 	m_nodedef->updateTextures(this, &tu_args);
 
+	// Far terrain is drawn with plain cubes, colored by their vertices
+	if (g_settings->getU16("lod_distance") > 0) {
+		TileSpec tile;
+		TileLayer &layer = tile.layers[0];
+		layer.texture = m_tsrc->getTextureForMesh("[fill:1x1:#ffffff", &layer.texture_id);
+		layer.material_type = TILE_MATERIAL_OPAQUE;
+		layer.shader_id = m_shsrc->getShader("nodes_shader", TILE_MATERIAL_OPAQUE, NDT_NORMAL);
+		m_mesh_update_manager->setLodTile(tile);
+	}
+
 	// Start mesh update thread after setting up content definitions
 	infostream<<"- Starting mesh update thread"<<std::endl;
 	m_mesh_update_manager->start();
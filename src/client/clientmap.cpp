@@ -8,6 +8,7 @@
 #include "mapblock_mesh.h"
 #include <IMaterialRenderer.h>
 #include <IVideoDriver.h>
+#include <SMeshBuffer.h>
 #include <matrix4.h>
 #include "mapsector.h"
 #include "mapblock.h"
@@ -19,6 +20,7 @@
 #include "util/tracy_wrapper.h"
 #include "client/renderingengine.h"
 
+#include <algorithm>
 #include <queue>
 
 namespace {
@@ -74,8 +76,11 @@ static const std::string ClientMap_settings[] = {
 	"bilinear_filter",
 	"anisotropic_filter",
 	"transparency_sorting_distance",
+	"mesh_buffer_min_vertices",
+	"lod_distance",
 	"occlusion_culler",
 	"enable_raytraced_culling",
+	"enable_occlusion_queries",
 };
 
 ClientMap::ClientMap(
@@ -89,8 +94,7 @@ ClientMap::ClientMap(
 		rendering_engine->get_scene_manager(), id),
 	m_client(client),
 	m_rendering_engine(rendering_engine),
-	m_control(control),
-	m_drawlist(MapBlockComparer(v3s16(0,0,0)))
+	m_control(control)
 {
 
 	/*
@@ -117,15 +121,37 @@ void ClientMap::onSettingChanged(std::string_view name, bool all)
 		m_cache_anistropic_filter = g_settings->getBool("anisotropic_filter");
 	if (all || name == "transparency_sorting_distance")
 		m_cache_transparency_sorting_distance = g_settings->getU16("transparency_sorting_distance");
-	if (all || name == "occlusion_culler")
+	if (all || name == "mesh_buffer_min_vertices") {
+		m_cache_mesh_buffer_min_vertices = g_settings->getU32("mesh_buffer_min_vertices");
+		m_merged_buffers.clear();
+	}
+	if (all || name == "lod_distance")
+		m_cache_lod_distance = g_settings->getU16("lod_distance");
+	if (all || name == "occlusion_culler") {
 		m_loops_occlusion_culler = g_settings->get("occlusion_culler") == "loops";
-	if (all || name == "enable_raytraced_culling")
+		m_drawlist_outdated = true;
+	}
+	if (all || name == "enable_raytraced_culling") {
 		m_enable_raytraced_culling = g_settings->getBool("enable_raytraced_culling");
+		m_drawlist_outdated = true;
+	}
+	if (all || name == "enable_occlusion_queries") {
+		m_enable_occlusion_queries = g_settings->getBool("enable_occlusion_queries");
+		if (!m_enable_occlusion_queries)
+			clearOcclusionQueries();
+	}
 }
 
 ClientMap::~ClientMap()
 {
 	g_settings->deregisterAllChangedCallbacks(this);
+	clearOcclusionQueries();
+}
+
+u32 ClientMap::getDrawListBlockCount() const
+{
+	u32 cell_size = m_client->getMeshGrid().cell_size;
+	return m_drawlist.size() * cell_size * cell_size * cell_size;
 }
 
 void ClientMap::updateCamera(v3f pos, v3f dir, f32 fov, v3s16 offset, video::SColor light_color)
@@ -269,6 +295,20 @@ void ClientMap::updateDrawList()
 
 	m_needs_update_drawlist = false;
 
+	const v3s16 cam_pos_nodes = floatToInt(m_camera_position, BS);
+
+	// The list only changes if the camera or the meshes do. This does not
+	// apply when all blocks are visited, as that also keeps them alive.
+	DrawListInputs inputs{cam_pos_nodes, m_camera_direction, m_camera_fov,
+			m_control.wanted_range, m_control.range_all, m_control.allow_noclip};
+	bool visits_all_blocks = m_control.range_all || m_loops_occlusion_culler;
+	if (!m_drawlist_outdated && !visits_all_blocks && inputs == m_drawlist_inputs) {
+		g_profiler->avg("MapBlocks drawn [#]", m_drawlist.size());
+		return;
+	}
+	m_drawlist_inputs = inputs;
+	m_drawlist_outdated = false;
+
 	for (auto &i : m_drawlist) {
 		MapBlock *block = i.second;
 		block->refDrop();
@@ -280,8 +320,6 @@ void ClientMap::updateDrawList()
 	}
 	m_keeplist.clear();
 
-	const v3s16 cam_pos_nodes = floatToInt(m_camera_position, BS);
-
 	v3s16 p_blocks_min;
 	v3s16 p_blocks_max;
 	getBlocksInViewRange(cam_pos_nodes, &p_blocks_min, &p_blocks_max);
@@ -304,7 +342,6 @@ void ClientMap::updateDrawList()
 	}
 
 	const v3s16 camera_block = getContainerPos(cam_pos_nodes, MAP_BLOCKSIZE);
-	m_drawlist = std::map<v3s16, MapBlock*, MapBlockComparer>(MapBlockComparer(camera_block));
 
 	auto is_frustum_culled = m_client->getCamera()->getFrustumCuller();
 
@@ -320,7 +357,7 @@ void ClientMap::updateDrawList()
 	 When range_all is enabled, enumerate all blocks visible in the
 	 frustum and display them.
 	 */
-	if (m_control.range_all || m_loops_occlusion_culler) {
+	if (visits_all_blocks) {
 		// Number of blocks currently loaded by the client
 		u32 blocks_loaded = 0;
 		// Number of blocks with mesh in rendering range
@@ -399,7 +436,7 @@ void ClientMap::updateDrawList()
 				} else if (mesh) {
 					// without mesh chunking we can add the block to the drawlist
 					block->refGrab();
-					m_drawlist.emplace(block->getPos(), block);
+					m_drawlist.emplace_back(block->getPos(), block);
 				}
 			}
 		}
@@ -507,7 +544,7 @@ void ClientMap::updateDrawList()
 			} else if (mesh) {
 				// without mesh chunking we can add the block to the drawlist
 				block->refGrab();
-				m_drawlist.emplace(block_coord, block);
+				m_drawlist.emplace_back(block_coord, block);
 			}
 
 			// Decide which sides to traverse next or to block away
@@ -619,10 +656,17 @@ void ClientMap::updateDrawList()
 		MapBlock *block = getBlockNoCreateNoEx(pos);
 		if (block) {
 			block->refGrab();
-			m_drawlist.emplace(pos, block);
+			m_drawlist.emplace_back(pos, block);
 		}
 	}
 
+	// Each block is added once, so sorting a vector is all that's needed
+	MapBlockComparer comparer(camera_block);
+	std::sort(m_drawlist.begin(), m_drawlist.end(),
+		[&comparer] (const auto &a, const auto &b) {
+			return comparer(a.first, b.first);
+		});
+
 	g_profiler->avg("MapBlocks occlusion culled [#]", blocks_occlusion_culled);
 	g_profiler->avg("MapBlocks frustum culled [#]", blocks_frustum_culled);
 	g_profiler->avg("MapBlocks drawn [#]", m_drawlist.size());
@@ -720,7 +764,6 @@ void ClientMap::renderMap(video::IVideoDriver* driver, s32 pass)
 	*/
 	const float animation_time = m_client->getAnimationTime();
 	const int crack = m_client->getCrackLevel();
-	const u32 daynight_ratio = m_client->getEnv().getDayNightRatio();
 
 	const v3f camera_position = m_camera_position;
 
@@ -752,6 +795,8 @@ void ClientMap::renderMap(video::IVideoDriver* driver, s32 pass)
 	auto is_frustum_culled = m_client->getCamera()->getFrustumCuller();
 
 	const MeshGrid mesh_grid = m_client->getMeshGrid();
+	// Blocks whose occlusion is tested after the solid pass
+	std::vector<v3s16> queried_blocks;
 	for (auto &i : m_drawlist) {
 		v3s16 block_pos = i.first;
 		MapBlock *block = i.second;
@@ -769,8 +814,36 @@ void ClientMap::renderMap(video::IVideoDriver* driver, s32 pass)
 		if (is_frustum_culled(mesh_sphere_center, mesh_sphere_radius))
 			continue;
 
+		// Skip blocks that were hidden in the previous frame
+		if (m_enable_occlusion_queries) {
+			if (is_transparent_pass) {
+				auto it = m_occlusion_queries.find(block_pos);
+				if (it != m_occlusion_queries.end() && it->second.hidden)
+					continue;
+			} else {
+				OcclusionQuery &query = m_occlusion_queries[block_pos];
+				query.used = true;
+				u32 samples;
+				if (query.pending && driver->pollOcclusionQuery(query.id, samples)) {
+					query.pending = false;
+					query.hidden = samples == 0;
+				}
+				queried_blocks.push_back(block_pos);
+				if (query.hidden)
+					continue;
+			}
+		}
+
+		// Far away meshes are drawn simplified, which is decided once per frame
+		u8 lod_level = pass == scene::ESNRP_SOLID ?
+				block_mesh->updateLodLevel(camera_position.getDistanceFrom(
+					mesh_sphere_center), m_cache_lod_distance * BS) :
+				block_mesh->getLodLevel();
+		if (block_mesh->takeLodMissing())
+			m_client->addUpdateMeshTask(block_pos);
+
 		// Mesh animation
-		if (pass == scene::ESNRP_SOLID) {
+		if (pass == scene::ESNRP_SOLID && lod_level == 0) {
 			// 50 nodes is pretty arbitrary but it should work somewhat nicely
 			float distance_sq = camera_position.getDistanceFromSQ(mesh_sphere_center);
 			bool faraway = distance_sq >= std::pow(BS * 50 + mesh_sphere_radius, 2.0f);
@@ -779,7 +852,7 @@ void ClientMap::renderMap(video::IVideoDriver* driver, s32 pass)
 					mesh_animate_count < (m_control.range_all ? 200 : 50)) {
 
 				bool animated = block_mesh->animate(faraway, animation_time,
-					crack, daynight_ratio);
+					crack);
 				if (animated)
 					mesh_animate_count++;
 			} else {
@@ -793,14 +866,20 @@ void ClientMap::renderMap(video::IVideoDriver* driver, s32 pass)
 		if (is_transparent_pass) {
 			// In transparent pass, the mesh will give us
 			// the partial buffers in the correct order
+			// (simplified meshes are entirely opaque)
+			if (lod_level > 0)
+				continue;
 			for (auto &buffer : block_mesh->getTransparentBuffers())
 				draw_order.emplace_back(block_pos, &buffer);
 		}
 		else {
 			// otherwise, group buffers across meshes
 			// using MeshBufListMaps
-			for (int layer = 0; layer < MAX_TILE_LAYERS; layer++) {
-				scene::IMesh *mesh = block_mesh->getMesh(layer);
+			// (a simplified mesh has a single layer)
+			int layer_count = lod_level > 0 ? 1 : MAX_TILE_LAYERS;
+			for (int layer = 0; layer < layer_count; layer++) {
+				scene::IMesh *mesh = lod_level > 0 ?
+						block_mesh->getLodMesh(lod_level) : block_mesh->getMesh(layer);
 				assert(mesh);
 
 				u32 c = mesh->getMeshBufferCount();
@@ -824,12 +903,13 @@ void ClientMap::renderMap(video::IVideoDriver* driver, s32 pass)
 	}
 
 	// Capture draw order for all solid meshes
+	u32 merged_rebuilt = 0;
 	for (auto &map : grouped_buffers.maps) {
 		for (auto &list : map) {
-			// iterate in reverse to draw closest blocks first
-			for (auto it = list.second.rbegin(); it != list.second.rend(); ++it) {
-				draw_order.emplace_back(it->first, it->second, it != list.second.rbegin());
-			}
+			// reverse to draw closest blocks first
+			std::reverse(list.second.begin(), list.second.end());
+			merged_rebuilt += mergeMeshBuffers(list.second, draw_order,
+					mesh_grid);
 		}
 	}
 
@@ -881,9 +961,26 @@ void ClientMap::renderMap(video::IVideoDriver* driver, s32 pass)
 
 	g_profiler->avg(prefix + "draw meshes [ms]", draw.stop(true));
 
+	if (m_enable_occlusion_queries && pass == scene::ESNRP_SOLID)
+		runOcclusionQueries(driver, queried_blocks, mesh_grid);
+
 	// Log only on solid pass because values are the same
 	if (pass == scene::ESNRP_SOLID) {
 		g_profiler->avg("renderMap(): animated meshes [#]", mesh_animate_count);
+
+		// Drop the merged buffers that were not drawn in this frame
+		size_t merged_count = 0;
+		for (auto it = m_merged_buffers.begin(); it != m_merged_buffers.end(); ) {
+			if (!it->second.used) {
+				it = m_merged_buffers.erase(it);
+				continue;
+			}
+			it->second.used = false;
+			++merged_count;
+			++it;
+		}
+		g_profiler->avg("renderMap(): merged buffers [#]", merged_count);
+		g_profiler->avg("renderMap(): merged buffers rebuilt [#]", merged_rebuilt);
 	}
 
 	if (pass == scene::ESNRP_TRANSPARENT) {
@@ -1367,6 +1464,117 @@ u32 ClientMap::DrawDescriptor::draw(video::IVideoDriver* driver)
 	}
 }
 
+u32 ClientMap::mergeMeshBuffers(std::vector<std::pair<v3s16, scene::IMeshBuffer *>> &list,
+		std::vector<DrawDescriptor> &draw_order, const MeshGrid &mesh_grid)
+{
+	// Side length of the regions, in mesh grid cells, in which buffers are
+	// merged. The merged buffers stay the same while only blocks outside of
+	// the region enter or leave the view, so they can be reused.
+	constexpr s16 MERGE_REGION_SIZE = 4;
+
+	const size_t draw_order_start = draw_order.size();
+	u32 rebuilt = 0;
+
+	// Large buffers are drawn as they are, the rest is ordered by region
+	auto small_begin = std::stable_partition(list.begin(), list.end(),
+		[this] (const std::pair<v3s16, scene::IMeshBuffer *> &it) {
+			return it.second->getVertexCount() >= m_cache_mesh_buffer_min_vertices;
+		});
+	for (auto it = list.begin(); it != small_begin; ++it)
+		draw_order.emplace_back(it->first, it->second, false);
+
+	auto get_region = [&] (v3s16 block_pos) {
+		return getContainerPos(mesh_grid.getCellPos(block_pos), MERGE_REGION_SIZE);
+	};
+	std::stable_sort(small_begin, list.end(),
+		[&] (const std::pair<v3s16, scene::IMeshBuffer *> &a,
+				const std::pair<v3s16, scene::IMeshBuffer *> &b) {
+			return get_region(a.first) < get_region(b.first);
+		});
+
+	std::vector<std::pair<v3s16, scene::IMeshBuffer *>> pending;
+	u32 pending_vertices = 0;
+	auto flush = [&] () {
+		if (pending.size() == 1) {
+			draw_order.emplace_back(pending[0].first, pending[0].second, false);
+		} else if (!pending.empty()) {
+			bool was_rebuilt = false;
+			draw_order.emplace_back(pending[0].first, getMergedMeshBuffer(pending,
+					mesh_grid, was_rebuilt), false);
+			rebuilt += was_rebuilt;
+		}
+		pending.clear();
+		pending_vertices = 0;
+	};
+
+	for (auto it = small_begin; it != list.end(); ++it) {
+		const u32 vertex_count = it->second->getVertexCount();
+		// The indices are 16-bit
+		if (!pending.empty() && (pending_vertices + vertex_count > U16_MAX + 1 ||
+				get_region(pending[0].first) != get_region(it->first)))
+			flush();
+		pending.push_back(*it);
+		pending_vertices += vertex_count;
+	}
+	flush();
+
+	// All of them share the same material
+	for (size_t i = draw_order_start + 1; i < draw_order.size(); i++)
+		draw_order[i].m_reuse_material = true;
+
+	return rebuilt;
+}
+
+scene::IMeshBuffer *ClientMap::getMergedMeshBuffer(
+		const std::vector<std::pair<v3s16, scene::IMeshBuffer *>> &list,
+		const MeshGrid &mesh_grid, bool &rebuilt)
+{
+	std::vector<scene::IMeshBuffer *> key;
+	key.reserve(list.size());
+	for (auto &it : list)
+		key.push_back(it.second);
+
+	MergedMeshBuffer &merged = m_merged_buffers[key];
+	merged.used = true;
+	rebuilt = !merged.buffer;
+	if (!rebuilt) {
+		// The material is changed in place by block animations
+		merged.buffer->getMaterial() = list[0].second->getMaterial();
+		return merged.buffer.get();
+	}
+
+	auto *buf = new scene::SMeshBuffer();
+	buf->Material = list[0].second->getMaterial();
+	merged.sources.clear();
+
+	// The vertices are placed relative to the first block
+	const v3s16 origin = mesh_grid.getMeshPos(list[0].first);
+	for (auto &it : list) {
+		scene::IMeshBuffer *src = it.second;
+		assert(src->getVertexType() == video::EVT_STANDARD);
+		const v3f offset = intToFloat(
+				(mesh_grid.getMeshPos(it.first) - origin) * MAP_BLOCKSIZE, BS);
+
+		const u32 vertex_start = buf->getVertexCount();
+		const auto *vertices = static_cast<const video::S3DVertex *>(src->getVertices());
+		for (u32 i = 0; i < src->getVertexCount(); i++) {
+			buf->Vertices->Data.push_back(vertices[i]);
+			buf->Vertices->Data.back().Pos += offset;
+		}
+		const u16 *indices = src->getIndices();
+		for (u32 i = 0; i < src->getIndexCount(); i++)
+			buf->Indices->Data.push_back(indices[i] + vertex_start);
+
+		merged.sources.emplace_back();
+		merged.sources.back().grab(src);
+	}
+	buf->recalculateBoundingBox();
+	buf->setHardwareMappingHint(scene::EHM_STATIC);
+
+	merged.buffer.reset(buf);
+	return buf;
+}
+
 bool ClientMap::isMeshOccluded(MapBlock *mesh_block, u16 mesh_size, v3s16 cam_pos_nodes)
 {
 	if (mesh_size == 1)
@@ -1417,3 +1625,101 @@ bool ClientMap::isMeshOccluded(MapBlock *mesh_block, u16 mesh_size, v3s16 cam_po
 
 	return true;
 }
+
+// Unit cube drawn for the occlusion queries
+static scene::IMeshBuffer *createOcclusionBox()
+{
+	auto *buf = new scene::SMeshBuffer();
+	const video::SColor c(255, 255, 255, 255);
+	for (u16 i = 0; i < 8; i++)
+		buf->Vertices->Data.emplace_back(i & 1, (i >> 1) & 1, (i >> 2) & 1,
+				0, 0, 0, c, 0, 0);
+	// Two triangles per side, the winding does not matter
+	static const u16 indices[] = {
+		0, 2, 3, 0, 3, 1, // -Z
+		4, 5, 7, 4, 7, 6, // +Z
+		0, 4, 6, 0, 6, 2, // -X
+		1, 3, 7, 1, 7, 5, // +X
+		0, 1, 5, 0, 5, 4, // -Y
+		2, 6, 7, 2, 7, 3, // +Y
+	};
+	buf->Indices->Data.assign(std::begin(indices), std::end(indices));
+	buf->recalculateBoundingBox();
+	buf->setHardwareMappingHint(scene::EHM_STATIC);
+	return buf;
+}
+
+void ClientMap::runOcclusionQueries(video::IVideoDriver *driver,
+		const std::vector<v3s16> &blocks, const MeshGrid &mesh_grid)
+{
+	if (!m_occlusion_box)
+		m_occlusion_box.reset(createOcclusionBox());
+
+	// Only test against the depth buffer
+	video::SMaterial material;
+	material.ColorMask = video::ECP_NONE;
+	material.ZWriteEnable = video::EZW_OFF;
+	material.BackfaceCulling = false;
+	driver->setMaterial(material);
+
+	const v3f offset = intToFloat(m_camera_offset, BS);
+	// The bounding box is grown by a node on each side, so that it always
+	// lies in front of the geometry of its own block
+	const f32 size = (mesh_grid.cell_size * MAP_BLOCKSIZE + 2) * BS;
+	u32 query_count = 0;
+
+	for (v3s16 block_pos : blocks) {
+		OcclusionQuery &query = m_occlusion_queries[block_pos];
+		if (query.pending)
+			continue;
+
+		v3f box_min = intToFloat(block_pos * MAP_BLOCKSIZE, BS) - v3f(1.5f * BS);
+		aabb3f box(box_min, box_min + v3f(size));
+		// The near plane would clip the box if the camera is (almost) inside
+		box.MinEdge -= v3f(BS);
+		box.MaxEdge += v3f(BS);
+		if (box.isPointInside(m_camera_position)) {
+			query.hidden = false;
+			continue;
+		}
+
+		if (query.id == 0) {
+			query.id = driver->createOcclusionQuery();
+			// Not supported by the driver
+			if (query.id == 0)
+				continue;
+		}
+
+		core::matrix4 m;
+		m.setScale(size);
+		m.setTranslation(box_min - offset);
+		driver->setTransform(video::ETS_WORLD, m);
+
+		driver->beginOcclusionQuery(query.id);
+		driver->drawMeshBuffer(m_occlusion_box.get());
+		driver->endOcclusionQuery();
+		query.pending = true;
+		++query_count;
+	}
+
+	// Forget the blocks that were not considered in this frame
+	for (auto it = m_occlusion_queries.begin(); it != m_occlusion_queries.end(); ) {
+		if (!it->second.used) {
+			driver->deleteOcclusionQuery(it->second.id);
+			it = m_occlusion_queries.erase(it);
+			continue;
+		}
+		it->second.used = false;
+		++it;
+	}
+
+	g_profiler->avg("renderMap(): occlusion queries [#]", query_count);
+}
+
+void ClientMap::clearOcclusionQueries()
+{
+	video::IVideoDriver *driver = SceneManager->getVideoDriver();
+	for (auto &it : m_occlusion_queries)
+		driver->deleteOcclusionQuery(it.second.id);
+	m_occlusion_queries.clear();
+}
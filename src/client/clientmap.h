@@ -5,10 +5,12 @@
 #pragma once
 
 #include "irrlichttypes_bloated.h"
+#include "irr_ptr.h"
 #include "map.h"
 #include "camera.h"
 #include <set>
 #include <map>
+#include <unordered_map>
 
 struct MapDrawControl
 {
@@ -85,6 +87,9 @@ class ClientMap : public Map, public scene::ISceneNode
 	void updateDrawListShadow(v3f shadow_light_pos, v3f shadow_light_dir, float radius, float length);
 	// Returns true if draw list needs updating before drawing the next frame.
 	bool needsUpdateDrawList() { return m_needs_update_drawlist; }
+	// Makes the next updateDrawList() call rebuild the list even if the
+	// camera did not move. Call when block meshes were added or replaced.
+	void invalidateDrawList() { m_drawlist_outdated = true; }
 	void renderMap(video::IVideoDriver* driver, s32 pass);
 
 	void renderMapShadows(video::IVideoDriver *driver,
@@ -101,6 +106,8 @@ class ClientMap : public Map, public scene::ISceneNode
 	const MapDrawControl & getControl() const { return m_control; }
 	f32 getWantedRange() const { return m_control.wanted_range; }
 	f32 getCameraFov() const { return m_camera_fov; }
+	// Number of map blocks covered by the meshes in the draw list
+	u32 getDrawListBlockCount() const;
 
 	void onSettingChanged(std::string_view name, bool all);
 
@@ -157,6 +164,40 @@ class ClientMap : public Map, public scene::ISceneNode
 		u32 draw(video::IVideoDriver* driver);
 	};
 
+	// Solid mesh buffers of several blocks merged into one
+	struct MergedMeshBuffer {
+		// Holds the source buffers, so that their addresses can't be reused
+		// while they are part of the key
+		std::vector<irr_ptr<scene::IMeshBuffer>> sources;
+		irr_ptr<scene::IMeshBuffer> buffer;
+		bool used;
+	};
+
+	// Appends the solid buffers sharing a material to the draw order, merging
+	// the small ones of nearby blocks into larger buffers.
+	// Returns the number of merged buffers that had to be (re)built.
+	u32 mergeMeshBuffers(std::vector<std::pair<v3s16, scene::IMeshBuffer *>> &list,
+			std::vector<DrawDescriptor> &draw_order, const MeshGrid &mesh_grid);
+	scene::IMeshBuffer *getMergedMeshBuffer(
+			const std::vector<std::pair<v3s16, scene::IMeshBuffer *>> &list,
+			const MeshGrid &mesh_grid, bool &rebuilt);
+
+	// Hardware occlusion query of the bounding box of a block
+	struct OcclusionQuery {
+		u32 id = 0;
+		// Result of the last finished query
+		bool hidden = false;
+		// Issued, but the result was not read yet
+		bool pending = false;
+		bool used = false;
+	};
+
+	// Draws the bounding boxes of the given blocks against the depth buffer
+	// of the solid pass. The results are used in the next frame.
+	void runOcclusionQueries(video::IVideoDriver *driver,
+			const std::vector<v3s16> &blocks, const MeshGrid &mesh_grid);
+	void clearOcclusionQueries();
+
 	Client *m_client;
 	RenderingEngine *m_rendering_engine;
 
@@ -172,18 +213,54 @@ class ClientMap : public Map, public scene::ISceneNode
 	video::SColor m_camera_light_color = video::SColor(0xFFFFFFFF);
 	bool m_needs_update_transparent_meshes = true;
 
-	std::map<v3s16, MapBlock*, MapBlockComparer> m_drawlist;
+	// Sorted from the farthest to the nearest block
+	std::vector<std::pair<v3s16, MapBlock*>> m_drawlist;
 	std::vector<MapBlock*> m_keeplist;
 	std::map<v3s16, MapBlock*> m_drawlist_shadow;
 	bool m_needs_update_drawlist;
 
+	// Everything the draw list depends on besides the map,
+	// so that unnecessary updates can be skipped.
+	// There is no incremental update: once any of this changes, the
+	// list is rebuilt and sorted as a whole.
+	struct DrawListInputs {
+		v3s16 camera_node;
+		v3f camera_direction;
+		f32 camera_fov;
+		f32 wanted_range;
+		bool range_all;
+		bool allow_noclip;
+
+		bool operator==(const DrawListInputs &other) const
+		{
+			return camera_node == other.camera_node &&
+				camera_direction == other.camera_direction &&
+				camera_fov == other.camera_fov &&
+				wanted_range == other.wanted_range &&
+				range_all == other.range_all &&
+				allow_noclip == other.allow_noclip;
+		}
+	};
+	DrawListInputs m_drawlist_inputs;
+	// Set when block meshes or culling settings change
+	bool m_drawlist_outdated = true;
+
 	std::set<v2s16> m_last_drawn_sectors;
 
+	// Kept as long as the same buffers are merged in consecutive frames
+	std::map<std::vector<scene::IMeshBuffer *>, MergedMeshBuffer> m_merged_buffers;
+
+	std::unordered_map<v3s16, OcclusionQuery> m_occlusion_queries;
+	irr_ptr<scene::IMeshBuffer> m_occlusion_box;
+
 	bool m_cache_trilinear_filter;
 	bool m_cache_bilinear_filter;
 	bool m_cache_anistropic_filter;
 	u16 m_cache_transparency_sorting_distance;
+	u32 m_cache_mesh_buffer_min_vertices;
+	u16 m_cache_lod_distance;
 
 	bool m_loops_occlusion_culler;
 	bool m_enable_raytraced_culling;
+	bool m_enable_occlusion_queries;
 };
@@ -33,17 +33,12 @@ Clouds::Clouds(scene::ISceneManager* mgr, IShaderSource *ssrc,
 	m_seed(seed)
 {
 	assert(ssrc);
-	m_enable_shaders = g_settings->getBool("enable_shaders");
 
 	m_material.BackfaceCulling = true;
 	m_material.FogEnable = true;
 	m_material.AntiAliasing = video::EAAM_SIMPLE;
-	if (m_enable_shaders) {
-		auto sid = ssrc->getShader("cloud_shader", TILE_MATERIAL_ALPHA);
-		m_material.MaterialType = ssrc->getShaderInfo(sid).material;
-	} else {
-		m_material.MaterialType = video::EMT_TRANSPARENT_ALPHA_CHANNEL;
-	}
+	auto sid = ssrc->getShader("cloud_shader", TILE_MATERIAL_ALPHA);
+	m_material.MaterialType = ssrc->getShaderInfo(sid).material;
 
 	m_params = SkyboxDefaults::getCloudDefaults();
 
@@ -118,15 +113,11 @@ void Clouds::updateMesh()
 	) + m_origin;
 
 	// Colors with primitive shading
-
-	video::SColorf c_top_f(m_color);
-	video::SColorf c_side_1_f(m_color);
-	video::SColorf c_side_2_f(m_color);
-	video::SColorf c_bottom_f(m_color);
-	if (m_enable_shaders) {
-		// shader mixes the base color, set via ColorParam
-		c_top_f = c_side_1_f = c_side_2_f = c_bottom_f = video::SColorf(1.0f, 1.0f, 1.0f, 1.0f);
-	}
+	// The shader mixes in the base color, set via ColorParam
+	video::SColorf c_top_f(1.0f, 1.0f, 1.0f, 1.0f);
+	video::SColorf c_side_1_f = c_top_f;
+	video::SColorf c_side_2_f = c_top_f;
+	video::SColorf c_bottom_f = c_top_f;
 	video::SColorf shadow = m_params.color_shadow;
 
 	c_side_1_f.r *= shadow.r * 0.25f + 0.75f;
@@ -385,8 +376,7 @@ void Clouds::render()
 	}
 
 	m_material.BackfaceCulling = is3D();
-	if (m_enable_shaders)
-		m_material.ColorParam = m_color.toSColor();
+	m_material.ColorParam = m_color.toSColor();
 
 	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
 	driver->setMaterial(m_material);
@@ -7,6 +7,7 @@
 #include <ICameraSceneNode.h>
 #include <IMeshManipulator.h>
 #include <IAnimatedMeshSceneNode.h>
+#include <ISkinnedMesh.h>
 #include "client/client.h"
 #include "client/renderingengine.h"
 #include "client/sound.h"
@@ -349,8 +350,6 @@ bool GenericCAO::collideWithObjects() const
 void GenericCAO::initialize(const std::string &data)
 {
 	processInitData(data);
-
-	m_enable_shaders = g_settings->getBool("enable_shaders");
 }
 
 void GenericCAO::processInitData(const std::string &data)
@@ -603,27 +602,18 @@ void GenericCAO::addToScene(ITextureSource *tsrc, scene::ISceneManager *smgr)
 
 	m_material_type_param = 0.5f; // May cut off alpha < 128 depending on m_material_type
 
-	if (m_enable_shaders) {
-		IShaderSource *shader_source = m_client->getShaderSource();
-		MaterialType material_type;
+	IShaderSource *shader_source = m_client->getShaderSource();
+	MaterialType material_type;
 
-		if (m_prop.shaded && m_prop.glow == 0)
-			material_type = (m_prop.use_texture_alpha) ?
-				TILE_MATERIAL_ALPHA : TILE_MATERIAL_BASIC;
-		else
-			material_type = (m_prop.use_texture_alpha) ?
-				TILE_MATERIAL_PLAIN_ALPHA : TILE_MATERIAL_PLAIN;
+	if (m_prop.shaded && m_prop.glow == 0)
+		material_type = (m_prop.use_texture_alpha) ?
+			TILE_MATERIAL_ALPHA : TILE_MATERIAL_BASIC;
+	else
+		material_type = (m_prop.use_texture_alpha) ?
+			TILE_MATERIAL_PLAIN_ALPHA : TILE_MATERIAL_PLAIN;
 
-		u32 shader_id = shader_source->getShader("object_shader", material_type, NDT_NORMAL);
-		m_material_type = shader_source->getShaderInfo(shader_id).material;
-	} else {
-		if (m_prop.use_texture_alpha) {
-			m_material_type = video::EMT_TRANSPARENT_ALPHA_CHANNEL;
-			m_material_type_param = 1.0f / 256.f; // minimal alpha for texture rendering
-		} else {
-			m_material_type = video::EMT_TRANSPARENT_ALPHA_CHANNEL_REF;
-		}
-	}
+	u32 shader_id = shader_source->getShader("object_shader", material_type, NDT_NORMAL);
+	m_material_type = shader_source->getShaderInfo(shader_id).material;
 
 	auto grabMatrixNode = [this] {
 		m_matrixnode = m_smgr->addDummyTransformationSceneNode();
@@ -688,9 +678,7 @@ void GenericCAO::addToScene(ITextureSource *tsrc, scene::ISceneManager *smgr)
 
 			// Set material
 			setMaterial(buf->getMaterial());
-			if (m_enable_shaders) {
-				buf->getMaterial().ColorParam = c;
-			}
+			buf->getMaterial().ColorParam = c;
 
 			// Add to mesh
 			mesh->addMeshBuffer(buf);
@@ -714,9 +702,7 @@ void GenericCAO::addToScene(ITextureSource *tsrc, scene::ISceneManager *smgr)
 
 			// Set material
 			setMaterial(buf->getMaterial());
-			if (m_enable_shaders) {
-				buf->getMaterial().ColorParam = c;
-			}
+			buf->getMaterial().ColorParam = c;
 
 			// Add to mesh
 			mesh->addMeshBuffer(buf);
@@ -794,15 +780,22 @@ void GenericCAO::addToScene(ITextureSource *tsrc, scene::ISceneManager *smgr)
 
 	/* Set VBO hint */
 	// wieldmesh sets its own hint, no need to handle it
-	if (m_enable_shaders && (m_meshnode || m_animated_meshnode)) {
+	if (m_meshnode || m_animated_meshnode) {
 		// sprite uses vertex animation
 		if (m_meshnode && m_prop.visual != "upright_sprite")
 			m_meshnode->getMesh()->setHardwareMappingHint(scene::EHM_STATIC);
 
 		if (m_animated_meshnode) {
 			auto *mesh = m_animated_meshnode->getMesh();
-			// skinning happens on the CPU
-			if (m_animated_meshnode->getJointCount() > 0)
+			// skinning happens on the CPU, unless the shaders can take it
+			bool gpu_skinning = false;
+			if (mesh->getMeshType() == scene::EAMT_SKINNED &&
+					m_animated_meshnode->getJointCount() > 0 &&
+					m_animated_meshnode->getJointCount() <= getMaxSkinningJoints()) {
+				gpu_skinning = static_cast<scene::ISkinnedMesh *>(mesh)->
+						setHardwareSkinning(true);
+			}
+			if (m_animated_meshnode->getJointCount() > 0 && !gpu_skinning)
 				mesh->setHardwareMappingHint(scene::EHM_STREAM, scene::EBT_VERTEX);
 			else
 				mesh->setHardwareMappingHint(scene::EHM_STATIC, scene::EBT_VERTEX);
@@ -892,10 +885,7 @@ void GenericCAO::updateLight(u32 day_night_ratio)
 
 	// Encode light into color, adding a small boost
 	// based on the entity glow.
-	if (m_enable_shaders)
-		light = encode_light(light_at_pos, m_prop.glow);
-	else
-		final_color_blend(&light, light_at_pos, day_night_ratio);
+	light = encode_light(light_at_pos, m_prop.glow);
 
 	if (light != m_last_light) {
 		m_last_light = light;
@@ -911,23 +901,10 @@ void GenericCAO::setNodeLight(const video::SColor &light_color)
 		return;
 	}
 
-	if (m_enable_shaders) {
-		auto *node = getSceneNode();
-		if (!node)
-			return;
-		setColorParam(node, light_color);
-	} else {
-		// TODO refactor vertex colors to be separate from the other vertex attributes
-		// instead of mutating meshes / buffers for everyone via setMeshColor.
-		// (Note: There are a couple more places here where setMeshColor is used.)
-		if (m_meshnode) {
-			setMeshColor(m_meshnode->getMesh(), light_color);
-		} else if (m_animated_meshnode) {
-			setMeshColor(m_animated_meshnode->getMesh(), light_color);
-		} else if (m_spritenode) {
-			m_spritenode->setColor(light_color);
-		}
-	}
+	auto *node = getSceneNode();
+	if (!node)
+		return;
+	setColorParam(node, light_color);
 }
 
 u16 GenericCAO::getLightPosition(v3s16 *pos)
@@ -328,6 +328,39 @@ static inline int lightDiff(LightPair a, LightPair b)
 	return abs(a.lightDay - b.lightDay) + abs(a.lightNight - b.lightNight);
 }
 
+// Whether faces with this tile can be merged into a larger quad
+static bool isMergeableTile(const TileSpec &tile)
+{
+	for (const TileLayer &layer : tile.layers) {
+		// Cracks are drawn on a single node only, and waving needs the vertices
+		if (layer.material_flags & MATERIAL_FLAG_CRACK)
+			return false;
+		switch (layer.material_type) {
+		case TILE_MATERIAL_WAVING_LEAVES:
+		case TILE_MATERIAL_WAVING_PLANTS:
+		case TILE_MATERIAL_WAVING_LIQUID_BASIC:
+		case TILE_MATERIAL_WAVING_LIQUID_TRANSPARENT:
+		case TILE_MATERIAL_WAVING_LIQUID_OPAQUE:
+			return false;
+		default:
+			break;
+		}
+	}
+	return true;
+}
+
+static bool isSameTile(const TileSpec &a, const TileSpec &b)
+{
+	if (a.world_aligned != b.world_aligned || a.rotation != b.rotation ||
+			a.emissive_light != b.emissive_light)
+		return false;
+	for (int layernum = 0; layernum < MAX_TILE_LAYERS; layernum++) {
+		if (a.layers[layernum] != b.layers[layernum])
+			return false;
+	}
+	return true;
+}
+
 void MapblockMeshGenerator::drawAutoLightedCuboid(aabb3f box, const f32 *txc,
 	TileSpec *tiles, int tile_count, u8 mask)
 {
@@ -410,7 +443,7 @@ void MapblockMeshGenerator::drawSolidNode()
 	content_t n1 = cur_node.n.getContent();
 	for (int face = 0; face < 6; face++) {
 		v3s16 p2 = blockpos_nodes + cur_node.p + tile_dirs[face];
-		MapNode neighbor = data->m_vmanip.getNodeNoEx(p2);
+		MapNode neighbor = data->m_vmanip.getNodeNoExNoEmerge(p2);
 		content_t n2 = neighbor.getContent();
 		bool backface_culling = cur_node.f->drawtype == NDT_NORMAL;
 		if (n2 == n1)
@@ -442,26 +475,48 @@ void MapblockMeshGenerator::drawSolidNode()
 	if (!faces)
 		return;
 	u8 mask = faces ^ 0b0011'1111; // k-th bit is set if k-th face is to be *omitted*, as expected by cuboid drawing functions.
-	cur_node.origin = intToFloat(cur_node.p, BS);
-	auto box = aabb3f(v3f(-0.5 * BS), v3f(0.5 * BS));
-	f32 texture_coord_buf[24];
-	box.MinEdge += cur_node.origin;
-	box.MaxEdge += cur_node.origin;
-	generateCuboidTextureCoords(box, texture_coord_buf);
+	LightPair smooth_lights[6][4];
 	if (data->m_smooth_lighting) {
-		LightPair lights[6][4];
 		for (int face = 0; face < 6; ++face) {
 			if (mask & (1 << face))
 				continue;
 			for (int k = 0; k < 4; k++) {
 				v3s16 corner = light_dirs[light_indices[face][k]];
-				lights[face][k] = LightPair(getSmoothLightSolid(
+				smooth_lights[face][k] = LightPair(getSmoothLightSolid(
 						blockpos_nodes + cur_node.p, tile_dirs[face], corner, data));
 			}
 		}
+	}
+
+	// Evenly lit faces are merged with their neighbors later on
+	for (int face = 0; face < 6; ++face) {
+		if ((mask & (1 << face)) || !isMergeableTile(tiles[face]))
+			continue;
+		LightPair light = data->m_smooth_lighting ?
+				smooth_lights[face][0] : LightPair(lights[face]);
+		if (data->m_smooth_lighting && (
+				(u16)smooth_lights[face][1] != light ||
+				(u16)smooth_lights[face][2] != light ||
+				(u16)smooth_lights[face][3] != light))
+			continue;
+		video::SColor color = encode_light(light, cur_node.f->light_source);
+		if (!cur_node.f->light_source)
+			applyFacesShading(color, v3f(tile_dirs[face].X, tile_dirs[face].Y, tile_dirs[face].Z));
+		solid_faces[face].push_back({cur_node.p, getSolidTileIndex(tiles[face]), color});
+		mask |= 1 << face;
+	}
+	if (mask == 0b0011'1111)
+		return;
 
+	cur_node.origin = intToFloat(cur_node.p, BS);
+	auto box = aabb3f(v3f(-0.5 * BS), v3f(0.5 * BS));
+	f32 texture_coord_buf[24];
+	box.MinEdge += cur_node.origin;
+	box.MaxEdge += cur_node.origin;
+	generateCuboidTextureCoords(box, texture_coord_buf);
+	if (data->m_smooth_lighting) {
 		drawCuboid(box, tiles, 6, texture_coord_buf, mask, [&] (int face, video::S3DVertex vertices[4]) {
-			auto final_lights = lights[face];
+			auto final_lights = smooth_lights[face];
 			for (int j = 0; j < 4; j++) {
 				video::S3DVertex &vertex = vertices[j];
 				vertex.Color = encode_light(final_lights[j], cur_node.f->light_source);
@@ -486,6 +541,98 @@ void MapblockMeshGenerator::drawSolidNode()
 	}
 }
 
+u16 MapblockMeshGenerator::getSolidTileIndex(const TileSpec &tile)
+{
+	// Few distinct tiles are used per block, and neighbors tend to share them
+	for (size_t i = solid_tiles.size(); i-- > 0; ) {
+		if (isSameTile(solid_tiles[i], tile))
+			return i;
+	}
+	solid_tiles.push_back(tile);
+	return solid_tiles.size() - 1;
+}
+
+// Draws the faces collected by drawSolidNode, merging adjacent faces with the
+// same tile and light into larger quads. The texture coordinates are derived
+// from the position in the block, so the texture simply repeats across them.
+void MapblockMeshGenerator::drawMergedSolidFaces(s16 cell_size)
+{
+	// Axes along which the faces are merged (U and V) and the face normal axis
+	static const u8 face_axes[6][3] = {
+		{0, 2, 1}, // up
+		{0, 2, 1}, // down
+		{2, 1, 0}, // right
+		{2, 1, 0}, // left
+		{0, 1, 2}, // back
+		{0, 1, 2}, // front
+	};
+	const s16 side = data->side_length / cell_size;
+	std::vector<s32> grid(side * side, -1);
+
+	for (int face = 0; face < 6; face++) {
+		std::vector<SolidFace> &faces = solid_faces[face];
+		const u8 u_axis = face_axes[face][0];
+		const u8 v_axis = face_axes[face][1];
+		const u8 n_axis = face_axes[face][2];
+		// Stable, so the faces of each slice stay in generation order
+		std::stable_sort(faces.begin(), faces.end(),
+			[n_axis] (const SolidFace &a, const SolidFace &b) {
+				return a.p[n_axis] < b.p[n_axis];
+			});
+
+		auto can_merge = [&] (const SolidFace &a, s32 i) {
+			return i >= 0 && faces[i].tile == a.tile && faces[i].color == a.color;
+		};
+
+		for (size_t begin = 0; begin < faces.size(); ) {
+			size_t end = begin;
+			for (; end < faces.size() && faces[end].p[n_axis] == faces[begin].p[n_axis]; end++)
+				grid[faces[end].p[v_axis] * side + faces[end].p[u_axis]] = end;
+
+			for (s16 v = 0; v < side; v++)
+			for (s16 u = 0; u < side; u++) {
+				s32 i = grid[v * side + u];
+				if (i < 0)
+					continue;
+				const SolidFace &f = faces[i];
+
+				// Grow along U first, then add rows along V that match entirely
+				s16 w = 1;
+				while (u + w < side && can_merge(f, grid[v * side + u + w]))
+					w++;
+				s16 h = 1;
+				for (; v + h < side; h++) {
+					s16 k = 0;
+					while (k < w && can_merge(f, grid[(v + h) * side + u + k]))
+						k++;
+					if (k < w)
+						break;
+				}
+				for (s16 dv = 0; dv < h; dv++)
+					std::fill_n(&grid[(v + dv) * side + u], w, -1);
+
+				v3s16 p_max = f.p;
+				p_max[u_axis] += w - 1;
+				p_max[v_axis] += h - 1;
+				aabb3f box(intToFloat(f.p * cell_size, BS) - v3f(0.5 * BS),
+						intToFloat((p_max + 1) * cell_size, BS) - v3f(0.5 * BS));
+				f32 texture_coord_buf[24];
+				generateCuboidTextureCoords(box, texture_coord_buf);
+				u8 mask = 0b0011'1111 ^ (1 << face);
+				drawCuboid(box, &solid_tiles[f.tile], 1, texture_coord_buf, mask,
+					[&] (int, video::S3DVertex vertices[4]) {
+						for (int j = 0; j < 4; j++)
+							vertices[j].Color = f.color;
+						return QuadDiagonal::Diag02;
+					});
+			}
+			begin = end;
+		}
+		faces.clear();
+	}
+	solid_tiles.clear();
+}
+
 u8 MapblockMeshGenerator::getNodeBoxMask(aabb3f box, u8 solid_neighbors, u8 sametype_neighbors) const
 {
 	const f32 NODE_BOUNDARY = 0.5 * BS;
@@ -528,8 +675,8 @@ void MapblockMeshGenerator::prepareLiquidNodeDrawing()
 	getSpecialTile(0, &cur_liquid.tile_top);
 	getSpecialTile(1, &cur_liquid.tile);
 
-	MapNode ntop    = data->m_vmanip.getNodeNoEx(blockpos_nodes + cur_node.p + v3s16(0,  1, 0));
-	MapNode nbottom = data->m_vmanip.getNodeNoEx(blockpos_nodes + cur_node.p + v3s16(0, -1, 0));
+	MapNode ntop    = data->m_vmanip.getNodeNoExNoEmerge(blockpos_nodes + cur_node.p + v3s16(0,  1, 0));
+	MapNode nbottom = data->m_vmanip.getNodeNoExNoEmerge(blockpos_nodes + cur_node.p + v3s16(0, -1, 0));
 	cur_liquid.c_flowing = cur_node.f->liquid_alternative_flowing_id;
 	cur_liquid.c_source = cur_node.f->liquid_alternative_source_id;
 	cur_liquid.top_is_same_liquid = (ntop.getContent() == cur_liquid.c_flowing)
@@ -568,7 +715,7 @@ void MapblockMeshGenerator::getLiquidNeighborhood()
 	for (int u = -1; u <= 1; u++) {
 		LiquidData::NeighborData &neighbor = cur_liquid.neighbors[w + 1][u + 1];
 		v3s16 p2 = cur_node.p + v3s16(u, 0, w);
-		MapNode n2 = data->m_vmanip.getNodeNoEx(blockpos_nodes + p2);
+		MapNode n2 = data->m_vmanip.getNodeNoExNoEmerge(blockpos_nodes + p2);
 		neighbor.content = n2.getContent();
 		neighbor.level = -0.5f;
 		neighbor.is_same_liquid = false;
@@ -594,7 +741,7 @@ void MapblockMeshGenerator::getLiquidNeighborhood()
 		// NOTE: This doesn't get executed if neighbor
 		//       doesn't exist
 		p2.Y++;
-		n2 = data->m_vmanip.getNodeNoEx(blockpos_nodes + p2);
+		n2 = data->m_vmanip.getNodeNoExNoEmerge(blockpos_nodes + p2);
 		if (n2.getContent() == cur_liquid.c_source || n2.getContent() == cur_liquid.c_flowing)
 			neighbor.top_is_same_liquid = true;
 	}
@@ -924,7 +1071,7 @@ void MapblockMeshGenerator::drawGlasslikeFramedNode()
 			if (!check_nb[i])
 				continue;
 			v3s16 n2p = blockpos_nodes + cur_node.p + g_26dirs[i];
-			MapNode n2 = data->m_vmanip.getNodeNoEx(n2p);
+			MapNode n2 = data->m_vmanip.getNodeNoExNoEmerge(n2p);
 			content_t n2c = n2.getContent();
 			if (n2c == current)
 				nb[i] = 1;
@@ -1256,7 +1403,7 @@ void MapblockMeshGenerator::drawPlantlikeRootedNode()
 	if (data->m_smooth_lighting) {
 		getSmoothLightFrame();
 	} else {
-		MapNode ntop = data->m_vmanip.getNodeNoEx(blockpos_nodes + cur_node.p);
+		MapNode ntop = data->m_vmanip.getNodeNoExNoEmerge(blockpos_nodes + cur_node.p);
 		cur_node.light = LightPair(getInteriorLight(ntop, 0, nodedef));
 	}
 	drawPlantlike(true);
@@ -1294,7 +1441,7 @@ void MapblockMeshGenerator::drawFirelikeNode()
 	content_t current = cur_node.n.getContent();
 	for (int i = 0; i < 6; i++) {
 		v3s16 n2p = blockpos_nodes + cur_node.p + g_6dirs[i];
-		MapNode n2 = data->m_vmanip.getNodeNoEx(n2p);
+		MapNode n2 = data->m_vmanip.getNodeNoExNoEmerge(n2p);
 		content_t n2c = n2.getContent();
 		if (n2c != CONTENT_IGNORE && n2c != CONTENT_AIR && n2c != current) {
 			neighbor[i] = true;
@@ -1365,7 +1512,7 @@ void MapblockMeshGenerator::drawFencelikeNode()
 	// Now a section of fence, +X, if there's a post there
 	v3s16 p2 = cur_node.p;
 	p2.X++;
-	MapNode n2 = data->m_vmanip.getNodeNoEx(blockpos_nodes + p2);
+	MapNode n2 = data->m_vmanip.getNodeNoExNoEmerge(blockpos_nodes + p2);
 	const ContentFeatures *f2 = &nodedef->get(n2);
 	if (f2->drawtype == NDT_FENCELIKE) {
 		static const aabb3f bar_x1(BS / 2 - bar_len,  BS / 4 - bar_rad, -bar_rad,
@@ -1387,7 +1534,7 @@ void MapblockMeshGenerator::drawFencelikeNode()
 	// Now a section of fence, +Z, if there's a post there
 	p2 = cur_node.p;
 	p2.Z++;
-	n2 = data->m_vmanip.getNodeNoEx(blockpos_nodes + p2);
+	n2 = data->m_vmanip.getNodeNoExNoEmerge(blockpos_nodes + p2);
 	f2 = &nodedef->get(n2);
 	if (f2->drawtype == NDT_FENCELIKE) {
 		static const aabb3f bar_z1(-bar_rad,  BS / 4 - bar_rad, BS / 2 - bar_len,
@@ -1409,7 +1556,7 @@ void MapblockMeshGenerator::drawFencelikeNode()
 
 bool MapblockMeshGenerator::isSameRail(v3s16 dir)
 {
-	MapNode node2 = data->m_vmanip.getNodeNoEx(blockpos_nodes + cur_node.p + dir);
+	MapNode node2 = data->m_vmanip.getNodeNoExNoEmerge(blockpos_nodes + cur_node.p + dir);
 	if (node2.getContent() == cur_node.n.getContent())
 		return true;
 	const ContentFeatures &def2 = nodedef->get(node2);
@@ -1560,7 +1707,7 @@ void MapblockMeshGenerator::drawNodeboxNode()
 	for (int dir = 0; dir != 6; dir++) {
 		u8 flag = 1 << dir;
 		v3s16 p2 = blockpos_nodes + cur_node.p + nodebox_tile_dirs[dir];
-		MapNode n2 = data->m_vmanip.getNodeNoEx(p2);
+		MapNode n2 = data->m_vmanip.getNodeNoExNoEmerge(p2);
 
 		// mark neighbors that are the same node type
 		// and have the same rotation or higher level stored as param2
@@ -1575,7 +1722,7 @@ void MapblockMeshGenerator::drawNodeboxNode()
 
 		if (cur_node.f->node_box.type == NODEBOX_CONNECTED) {
 			p2 = blockpos_nodes + cur_node.p + nodebox_connection_dirs[dir];
-			n2 = data->m_vmanip.getNodeNoEx(p2);
+			n2 = data->m_vmanip.getNodeNoExNoEmerge(p2);
 			if (nodedef->nodeboxConnects(cur_node.n, n2, flag))
 				neighbors_set |= flag;
 		}
@@ -1763,10 +1910,126 @@ void MapblockMeshGenerator::generate()
 	for (cur_node.p.Z = 0; cur_node.p.Z < data->side_length; cur_node.p.Z++)
 	for (cur_node.p.Y = 0; cur_node.p.Y < data->side_length; cur_node.p.Y++)
 	for (cur_node.p.X = 0; cur_node.p.X < data->side_length; cur_node.p.X++) {
-		cur_node.n = data->m_vmanip.getNodeNoEx(blockpos_nodes + cur_node.p);
+		cur_node.n = data->m_vmanip.getNodeNoExNoEmerge(blockpos_nodes + cur_node.p);
 		cur_node.f = &nodedef->get(cur_node.n);
 		drawNode();
 	}
+	drawMergedSolidFaces();
+}
+
+void MapblockMeshGenerator::generateLod(s16 cell_size, const TileSpec &tile)
+{
+	ZoneScoped;
+
+	assert(cell_size >= MeshMakeData::BORDER && data->side_length % cell_size == 0);
+
+	static const v3s16 face_dirs[6] = {
+		v3s16(0, 1, 0),
+		v3s16(0, -1, 0),
+		v3s16(1, 0, 0),
+		v3s16(-1, 0, 0),
+		v3s16(0, 0, 1),
+		v3s16(0, 0, -1)
+	};
+
+	struct LodCell {
+		u16 known = 0;   // nodes that are not CONTENT_IGNORE
+		u16 visible = 0; // known nodes that are not airlike
+		u8 light_day = 0;
+		u8 light_night = 0;
+
+		bool isFilled() const { return known > 0 && visible * 2 >= known; }
+	};
+
+	// The cells of the mesh plus a layer of neighbor cells around it, of
+	// which only the nodes in the border of the mesh data are known
+	const s16 cells = data->side_length / cell_size;
+	const s16 stride = cells + 2;
+	std::vector<LodCell> grid(stride * stride * stride);
+	auto cell_at = [&] (v3s16 c) -> LodCell & {
+		return grid[(c.Z + 1) * stride * stride + (c.Y + 1) * stride + c.X + 1];
+	};
+
+	const s16 border = MeshMakeData::BORDER;
+	v3s16 p;
+	for (p.Z = -border; p.Z < data->side_length + border; p.Z++)
+	for (p.Y = -border; p.Y < data->side_length + border; p.Y++)
+	for (p.X = -border; p.X < data->side_length + border; p.X++) {
+		MapNode n = data->m_vmanip.getNodeNoExNoEmerge(blockpos_nodes + p);
+		if (n.getContent() == CONTENT_IGNORE)
+			continue;
+		// p >= -cell_size, so the division rounds towards the right cell
+		LodCell &cell = cell_at((p + cell_size) / cell_size - 1);
+		cell.known++;
+		const ContentFeatures &f = nodedef->get(n);
+		if (f.drawtype != NDT_AIRLIKE)
+			cell.visible++;
+		if (f.light_propagates) {
+			cell.light_day = MYMAX(cell.light_day,
+					n.getLight(LIGHTBANK_DAY, f.getLightingFlags()));
+			cell.light_night = MYMAX(cell.light_night,
+					n.getLight(LIGHTBANK_NIGHT, f.getLightingFlags()));
+		}
+	}
+
+	u16 tile_index = getSolidTileIndex(tile);
+	v3s16 c;
+	for (c.Z = 0; c.Z < cells; c.Z++)
+	for (c.Y = 0; c.Y < cells; c.Y++)
+	for (c.X = 0; c.X < cells; c.X++) {
+		const LodCell &cell = cell_at(c);
+		if (!cell.isFilled())
+			continue;
+
+		// Average the colors of the topmost visible node of each column,
+		// like the minimap does
+		u32 sum[3] = {0, 0, 0};
+		u32 count = 0;
+		for (s16 z = 0; z < cell_size; z++)
+		for (s16 x = 0; x < cell_size; x++)
+		for (s16 y = cell_size - 1; y >= 0; y--) {
+			MapNode n = data->m_vmanip.getNodeNoExNoEmerge(
+					blockpos_nodes + c * cell_size + v3s16(x, y, z));
+			const ContentFeatures &f = nodedef->get(n);
+			if (n.getContent() == CONTENT_IGNORE || f.drawtype == NDT_AIRLIKE)
+				continue;
+			video::SColor color;
+			if (f.tiledef[0].has_color)
+				color = f.tiledef[0].color;
+			else
+				n.getColor(f, &color);
+			sum[0] += color.getRed() * f.minimap_color.getRed() / 255;
+			sum[1] += color.getGreen() * f.minimap_color.getGreen() / 255;
+			sum[2] += color.getBlue() * f.minimap_color.getBlue() / 255;
+			count++;
+			break;
+		}
+		if (count == 0)
+			continue;
+
+		for (int face = 0; face < 6; face++) {
+			// Faces between two cells of the mesh are hidden. The faces on
+			// the mesh boundary are always kept: the neighbor mesh may be
+			// drawn at another level, which need not cover this face.
+			const v3s16 nc = c + face_dirs[face];
+			const LodCell &neighbor = cell_at(nc);
+			bool inside = nc.X >= 0 && nc.X < cells && nc.Y >= 0 && nc.Y < cells &&
+					nc.Z >= 0 && nc.Z < cells;
+			if (inside && neighbor.isFilled())
+				continue;
+			LightPair light(
+					decode_light(MYMAX(cell.light_day, neighbor.light_day)),
+					decode_light(MYMAX(cell.light_night, neighbor.light_night)));
+			video::SColor color = encode_light(light, 0);
+			applyFacesShading(color, v3f(face_dirs[face].X,
+					face_dirs[face].Y, face_dirs[face].Z));
+			color.setRed(color.getRed() * sum[0] / count / 255);
+			color.setGreen(color.getGreen() * sum[1] / count / 255);
+			color.setBlue(color.getBlue() * sum[2] / count / 255);
+			solid_faces[face].push_back({c, tile_index, color});
+		}
+	}
+	drawMergedSolidFaces(cell_size);
 }
 
 void MapblockMeshGenerator::renderSingle(content_t node, u8 param2)
@@ -1775,4 +2038,5 @@ void MapblockMeshGenerator::renderSingle(content_t node, u8 param2)
 	cur_node.n = MapNode(node, 0xff, param2);
 	cur_node.f = &nodedef->get(cur_node.n);
 	drawNode();
+	drawMergedSolidFaces();
 }
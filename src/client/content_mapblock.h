@@ -49,6 +49,9 @@ class MapblockMeshGenerator
 	MapblockMeshGenerator(MeshMakeData *input, MeshCollector *output,
 			scene::IMeshManipulator *mm);
 	void generate();
+	// Generates a simplified mesh made of cubes of cell_size^3 nodes, each
+	// drawn with the given tile and the average color of its top nodes
+	void generateLod(s16 cell_size, const TileSpec &tile);
 	void renderSingle(content_t node, u8 param2 = 0x00);
 
 private:
@@ -153,6 +156,19 @@ class MapblockMeshGenerator
 		bool offset_top_only = false);
 	void drawPlantlike(bool is_rooted = false);
 
+// solid-specific
+	// A solid node face lit evenly, which can be merged with its neighbors
+	struct SolidFace {
+		v3s16 p; // in units of the cell size passed to drawMergedSolidFaces
+		u16 tile; // index in solid_tiles
+		video::SColor color;
+	};
+	std::vector<TileSpec> solid_tiles;
+	std::vector<SolidFace> solid_faces[6];
+
+	u16 getSolidTileIndex(const TileSpec &tile);
+	void drawMergedSolidFaces(s16 cell_size = 1);
+
 // firelike-specific
 	void drawFirelikeQuad(float rotation, float opening_angle,
 		float offset_h, float offset_v = 0.0);
@@ -25,22 +25,21 @@
 	MeshMakeData
 */
 
-MeshMakeData::MeshMakeData(const NodeDefManager *ndef, u16 side_length, bool use_shaders):
+MeshMakeData::MeshMakeData(const NodeDefManager *ndef, u16 side_length):
 	side_length(side_length),
-	nodedef(ndef),
-	m_use_shaders(use_shaders)
+	nodedef(ndef)
 {}
 
 void MeshMakeData::fillBlockDataBegin(const v3s16 &blockpos)
 {
 	m_blockpos = blockpos;
+	m_crack_pos_relative = v3s16(-1337,-1337,-1337);
 
 	v3s16 blockpos_nodes = m_blockpos*MAP_BLOCKSIZE;
 
-	m_vmanip.clear();
-	VoxelArea voxel_area(blockpos_nodes - v3s16(1,1,1) * MAP_BLOCKSIZE,
-			blockpos_nodes + v3s16(1,1,1) * (side_length + MAP_BLOCKSIZE /* extra layer of blocks around the mesh */) - v3s16(1,1,1));
-	m_vmanip.addArea(voxel_area);
+	VoxelArea voxel_area(blockpos_nodes - v3s16(1,1,1) * BORDER,
+			blockpos_nodes + v3s16(1,1,1) * (side_length + BORDER) - v3s16(1,1,1));
+	m_vmanip.resetArea(voxel_area);
 }
 
 void MeshMakeData::fillBlockData(const v3s16 &bp, MapNode *data)
@@ -48,8 +47,13 @@ void MeshMakeData::fillBlockData(const v3s16 &bp, MapNode *data)
 	v3s16 data_size(MAP_BLOCKSIZE, MAP_BLOCKSIZE, MAP_BLOCKSIZE);
 	VoxelArea data_area(v3s16(0,0,0), data_size - v3s16(1,1,1));
 
+	// Of the neighbors only a slab of BORDER nodes is needed
 	v3s16 blockpos_nodes = bp * MAP_BLOCKSIZE;
-	m_vmanip.copyFrom(data, data_area, v3s16(0,0,0), blockpos_nodes, data_size);
+	VoxelArea copy_area = (data_area + blockpos_nodes).intersect(m_vmanip.m_area);
+	if (copy_area.hasEmptyExtent())
+		return;
+	m_vmanip.copyFrom(data, data_area, copy_area.MinEdge - blockpos_nodes,
+			copy_area.MinEdge, copy_area.getExtent());
 }
 
 void MeshMakeData::setCrack(int crack_level, v3s16 crack_pos)
@@ -63,6 +67,11 @@ void MeshMakeData::setSmoothLighting(bool smooth_lighting)
 	m_smooth_lighting = smooth_lighting;
 }
 
+void MeshMakeData::setLodTile(const TileSpec *tile)
+{
+	m_lod_tile = tile;
+}
+
 /*
 	Light and vertex color functions
 */
@@ -589,19 +598,34 @@ void PartialMeshBuffer::draw(video::IVideoDriver *driver) const
 	MapBlockMesh
 */
 
-MapBlockMesh::MapBlockMesh(Client *client, MeshMakeData *data, v3s16 camera_offset):
+static video::SMaterial createMaterial(const TileLayer &layer, IShaderSource *shdsrc)
+{
+	video::SMaterial material;
+	material.BackfaceCulling = true;
+	material.FogEnable = true;
+	material.setTexture(0, layer.texture);
+	material.forEachTexture([] (auto &tex) {
+		tex.MinFilter = video::ETMINF_NEAREST_MIPMAP_NEAREST;
+		tex.MagFilter = video::ETMAGF_NEAREST;
+	});
+
+	material.MaterialType = shdsrc->getShaderInfo(layer.shader_id).material;
+	layer.applyMaterialOptionsWithShaders(material);
+	return material;
+}
+
+MapBlockMesh::MapBlockMesh(Client *client, MeshMakeData *data,
+		MeshCollector &collector, v3s16 camera_offset):
 	m_tsrc(client->getTextureSource()),
 	m_shdrsrc(client->getShaderSource()),
 	m_bounding_sphere_center((data->side_length * 0.5f - 0.5f) * BS),
 	m_animation_force_timer(0), // force initial animation
-	m_last_crack(-1),
-	m_last_daynight_ratio((u32) -1)
+	m_last_crack(-1)
 {
 	ZoneScoped;
 
 	for (auto &m : m_mesh)
 		m = make_irr<scene::SMesh>();
-	m_enable_shaders = data->m_use_shaders;
 
 	auto mesh_grid = client->getMeshGrid();
 	v3s16 bp = data->m_blockpos;
@@ -624,7 +648,7 @@ MapBlockMesh::MapBlockMesh(Client *client, MeshMakeData *data, v3s16 camera_offs
 	}
 
 	v3f offset = intToFloat((data->m_blockpos - mesh_grid.getMeshPos(data->m_blockpos)) * MAP_BLOCKSIZE, BS);
-	MeshCollector collector(m_bounding_sphere_center, offset);
+	collector.clear(m_bounding_sphere_center, offset);
 	/*
 		Add special graphics:
 		- torches
@@ -695,50 +719,8 @@ MapBlockMesh::MapBlockMesh(Client *client, MeshMakeData *data, v3s16 camera_offs
 				p.layer.texture = (*p.layer.frames)[0].texture;
 			}
 
-			if (!m_enable_shaders) {
-				// Extract colors for day-night animation
-				// Dummy sunlight to handle non-sunlit areas
-				video::SColorf sunlight;
-				get_sunlight_color(&sunlight, 0);
-
-				std::map<u32, video::SColor> colors;
-				const u32 vertex_count = p.vertices.size();
-				for (u32 j = 0; j < vertex_count; j++) {
-					video::SColor *vc = &p.vertices[j].Color;
-					video::SColor copy = *vc;
-					if (vc->getAlpha() == 0) // No sunlight - no need to animate
-						final_color_blend(vc, copy, sunlight); // Finalize color
-					else // Record color to animate
-						colors[j] = copy;
-
-					// The sunlight ratio has been stored,
-					// delete alpha (for the final rendering).
-					vc->setAlpha(255);
-				}
-				if (!colors.empty())
-					m_daynight_diffs[{layer, i}] = std::move(colors);
-			}
-
-			// Create material
-			video::SMaterial material;
-			material.BackfaceCulling = true;
-			material.FogEnable = true;
-			material.setTexture(0, p.layer.texture);
-			material.forEachTexture([] (auto &tex) {
-				tex.MinFilter = video::ETMINF_NEAREST_MIPMAP_NEAREST;
-				tex.MagFilter = video::ETMAGF_NEAREST;
-			});
-
-			if (m_enable_shaders) {
-				material.MaterialType = m_shdrsrc->getShaderInfo(
-						p.layer.shader_id).material;
-				p.layer.applyMaterialOptionsWithShaders(material);
-			} else {
-				p.layer.applyMaterialOptions(material);
-			}
-
 			scene::SMeshBuffer *buf = new scene::SMeshBuffer();
-			buf->Material = material;
+			buf->Material = createMaterial(p.layer, m_shdrsrc);
 			if (p.layer.isTransparent()) {
 				buf->append(&p.vertices[0], p.vertices.size(), nullptr, 0);
 
@@ -768,10 +750,31 @@ MapBlockMesh::MapBlockMesh(Client *client, MeshMakeData *data, v3s16 camera_offs
 
 	m_bsp_tree.buildTree(&m_transparent_triangles, data->side_length);
 
+	if (data->m_lod_tile) {
+		for (u8 level = 1; level <= LOD_LEVELS; level++) {
+			collector.clear(m_bounding_sphere_center, offset);
+			MapblockMeshGenerator(data, &collector,
+				client->getSceneManager()->getMeshManipulator()).generateLod(
+					1 << level, *data->m_lod_tile);
+
+			// The tile has a single opaque layer without animation
+			auto mesh = make_irr<scene::SMesh>();
+			for (PreMeshBuffer &p : collector.prebuffers[0]) {
+				scene::SMeshBuffer *buf = new scene::SMeshBuffer();
+				buf->Material = createMaterial(p.layer, m_shdrsrc);
+				buf->append(&p.vertices[0], p.vertices.size(),
+					&p.indices[0], p.indices.size());
+				mesh->addMeshBuffer(buf);
+				buf->drop();
+			}
+			mesh->setHardwareMappingHint(scene::EHM_STATIC);
+			m_lod_mesh[level - 1] = std::move(mesh);
+		}
+	}
+
 	// Check if animation is required for this mesh
 	m_has_animation =
 		!m_crack_materials.empty() ||
-		!m_daynight_diffs.empty() ||
 		!m_animation_info.empty();
 }
 
@@ -783,14 +786,45 @@ MapBlockMesh::~MapBlockMesh()
 			sz += m->getMeshBuffer(i)->getSize();
 		m.reset();
 	}
+	for (auto &&m : m_lod_mesh) {
+		if (!m)
+			continue;
+		for (u32 i = 0; i < m->getMeshBufferCount(); i++)
+			sz += m->getMeshBuffer(i)->getSize();
+		m.reset();
+	}
 	for (MinimapMapblock *block : m_minimap_mapblocks)
 		delete block;
 
 	porting::TrackFreedMemory(sz);
 }
 
-bool MapBlockMesh::animate(bool faraway, float time, int crack,
-	u32 daynight_ratio)
+u8 MapBlockMesh::updateLodLevel(f32 distance, f32 lod_distance)
+{
+	if (lod_distance <= 0) {
+		m_lod_level = 0;
+		return m_lod_level;
+	}
+	if (!m_lod_mesh[0]) {
+		// Made while it was near, so a rebuild is needed once it is far
+		if (!m_lod_requested && distance > lod_distance * 1.1f)
+			m_lod_requested = m_lod_missing = true;
+		m_lod_level = 0;
+		return m_lod_level;
+	}
+
+	// Level L is used beyond lod_distance * 2^(L-1)
+	auto threshold = [&] (u8 level) {
+		return lod_distance * (1 << (level - 1));
+	};
+	while (m_lod_level < LOD_LEVELS && distance > threshold(m_lod_level + 1) * 1.1f)
+		m_lod_level++;
+	while (m_lod_level > 0 && distance < threshold(m_lod_level) * 0.9f)
+		m_lod_level--;
+	return m_lod_level;
+}
+
+bool MapBlockMesh::animate(bool faraway, float time, int crack)
 {
 	if (!m_has_animation) {
 		m_animation_force_timer = 100000;
@@ -844,24 +878,6 @@ bool MapBlockMesh::animate(bool faraway, float time, int crack,
 		buf->getMaterial().setTexture(0, frame.texture);
 	}
 
-	// Day-night transition
-	if (!m_enable_shaders && (daynight_ratio != m_last_daynight_ratio)) {
-		video::SColorf day_color;
-		get_sunlight_color(&day_color, daynight_ratio);
-
-		for (auto &daynight_diff : m_daynight_diffs) {
-			auto *mesh = m_mesh[daynight_diff.first.first].get();
-			mesh->setDirty(scene::EBT_VERTEX); // force reload to VBO
-			scene::IMeshBuffer *buf = mesh->
-				getMeshBuffer(daynight_diff.first.second);
-			video::S3DVertex *vertices = (video::S3DVertex *)buf->getVertices();
-			for (const auto &j : daynight_diff.second)
-				final_color_blend(&(vertices[j.first].Color), j.second,
-						day_color);
-		}
-		m_last_daynight_ratio = daynight_ratio;
-	}
-
 	return true;
 }
 
@@ -25,6 +25,7 @@ class ITextureSource;
 
 class MapBlock;
 struct MinimapMapblock;
+struct MeshCollector;
 
 struct MeshMakeData
 {
@@ -32,17 +33,25 @@ struct MeshMakeData
 	v3s16 m_blockpos = v3s16(-1337,-1337,-1337);
 	v3s16 m_crack_pos_relative = v3s16(-1337,-1337,-1337);
 	bool m_smooth_lighting = false;
+	// Tile of the simplified meshes for far terrain, made only if set
+	const TileSpec *m_lod_tile = nullptr;
 	u16 side_length;
 
 	const NodeDefManager *nodedef;
-	bool m_use_shaders;
 
-	MeshMakeData(const NodeDefManager *ndef, u16 side_length, bool use_shaders);
+	// Number of nodes around the mesh that are copied from the neighbors.
+	// Mesh generation never looks further outside.
+	static constexpr s16 BORDER = 2;
+
+	MeshMakeData(const NodeDefManager *ndef, u16 side_length);
 
 	/*
 		Copy block data manually (to allow optimizations by the caller)
+		The same MeshMakeData can be filled again for another block, which
+		reuses its memory.
 	*/
 	void fillBlockDataBegin(const v3s16 &blockpos);
+	// Copies the part of the block that lies within the mesh and its border
 	void fillBlockData(const v3s16 &bp, MapNode *data);
 
 	/*
@@ -54,6 +63,12 @@ struct MeshMakeData
 		Enable or disable smooth lighting
 	*/
 	void setSmoothLighting(bool smooth_lighting);
+
+	/*
+		Set the tile of the simplified meshes for far terrain,
+		or nullptr to not make them
+	*/
+	void setLodTile(const TileSpec *tile);
 };
 
 // represents a triangle as indexes into the vertex buffer in SMeshBuffer
@@ -164,17 +179,23 @@ class PartialMeshBuffer
 class MapBlockMesh
 {
 public:
+	// Number of simplified meshes built for far terrain. Level L (starting
+	// at 1) is made of cubes of 2^L nodes, level 0 is the full mesh.
+	static constexpr u8 LOD_LEVELS = 2;
+
 	// Builds the mesh given
-	MapBlockMesh(Client *client, MeshMakeData *data, v3s16 camera_offset);
+	// collector is cleared and used as scratch space, so that its memory
+	// can be reused by the next mesh
+	MapBlockMesh(Client *client, MeshMakeData *data, MeshCollector &collector,
+			v3s16 camera_offset);
 	~MapBlockMesh();
 
 	// Main animation function, parameters:
 	//   faraway: whether the block is far away from the camera (~50 nodes)
 	//   time: the global animation time, 0 .. 60 (repeats every minute)
-	//   daynight_ratio: 0 .. 1000
 	//   crack: -1 .. CRACK_ANIMATION_LENGTH-1 (-1 for off)
 	// Returns true if anything has been changed.
-	bool animate(bool faraway, float time, int crack, u32 daynight_ratio);
+	bool animate(bool faraway, float time, int crack);
 
 	scene::IMesh *getMesh()
 	{
@@ -186,6 +207,29 @@ class MapBlockMesh
 		return m_mesh[layer].get();
 	}
 
+	// Returns the simplified mesh of a level between 1 and LOD_LEVELS
+	scene::IMesh *getLodMesh(u8 level)
+	{
+		return m_lod_mesh[level - 1].get();
+	}
+
+	// Picks the level of detail to draw the mesh with at the given
+	// distance, with some hysteresis so that meshes near the switching
+	// distance don't flicker while the camera moves.
+	// Distances are in BS-space, lod_distance <= 0 disables simplification.
+	u8 updateLodLevel(f32 distance, f32 lod_distance);
+
+	u8 getLodLevel() const { return m_lod_level; }
+
+	// Returns true once if updateLodLevel() found that the mesh should be
+	// simplified but was made without the simplified meshes
+	bool takeLodMissing()
+	{
+		bool missing = m_lod_missing;
+		m_lod_missing = false;
+		return missing;
+	}
+
 	std::vector<MinimapMapblock*> moveMinimapMapblocks()
 	{
 		std::vector<MinimapMapblock*> minimap_mapblocks;
@@ -228,6 +272,11 @@ class MapBlockMesh
 	};
 
 	irr_ptr<scene::IMesh> m_mesh[MAX_TILE_LAYERS];
+	// Empty unless the mesh was made with MeshMakeData::m_lod_tile
+	irr_ptr<scene::IMesh> m_lod_mesh[LOD_LEVELS];
+	u8 m_lod_level = 0;
+	bool m_lod_requested = false;
+	bool m_lod_missing = false;
 	std::vector<MinimapMapblock*> m_minimap_mapblocks;
 	ITextureSource *m_tsrc;
 	IShaderSource *m_shdrsrc;
@@ -235,8 +284,6 @@ class MapBlockMesh
 	f32 m_bounding_radius;
 	v3f m_bounding_sphere_center;
 
-	bool m_enable_shaders;
-
 	// Must animate() be called before rendering?
 	bool m_has_animation;
 	int m_animation_force_timer;
@@ -252,14 +299,6 @@ class MapBlockMesh
 	// Keys are pairs of (mesh index, buffer index in the mesh)
 	std::map<std::pair<u8, u32>, AnimationInfo> m_animation_info;
 
-	// Animation info: day/night transitions
-	// Last daynight_ratio value passed to animate()
-	u32 m_last_daynight_ratio;
-	// For each mesh and mesh buffer, stores pre-baked colors
-	// of sunlit vertices
-	// Keys are pairs of (mesh index, buffer index in the mesh)
-	std::map<std::pair<u8, u32>, std::map<u32, video::SColor > > m_daynight_diffs;
-
 	// list of all semitransparent triangles in the mapblock
 	std::vector<MeshTriangle> m_transparent_triangles;
 	// Binary Space Partitioning tree for the block
@@ -6,6 +6,7 @@
 #include "settings.h"
 #include "profiler.h"
 #include "client.h"
+#include "camera.h"
 #include "mapblock.h"
 #include "map.h"
 #include "util/directiontables.h"
@@ -23,15 +24,6 @@ static struct BlockPlaceholder {
 
 } block_placeholder;
 
-/*
-	QueuedMeshUpdate
-*/
-
-QueuedMeshUpdate::~QueuedMeshUpdate()
-{
-	delete data;
-}
-
 /*
 	MeshUpdateQueue
 */
@@ -39,8 +31,8 @@ QueuedMeshUpdate::~QueuedMeshUpdate()
 MeshUpdateQueue::MeshUpdateQueue(Client *client):
 	m_client(client)
 {
-	m_cache_enable_shaders = g_settings->getBool("enable_shaders");
 	m_cache_smooth_lighting = g_settings->getBool("smooth_lighting");
+	m_cache_lod_distance = g_settings->getU16("lod_distance");
 }
 
 MeshUpdateQueue::~MeshUpdateQueue()
@@ -87,6 +79,7 @@ bool MeshUpdateQueue::addBlock(Map *map, v3s16 p, bool ack_block_to_server, bool
 			q->crack_level = m_client->getCrackLevel();
 			q->crack_pos = m_client->getCrackPos();
 			q->urgent |= urgent;
+			q->lod = isLodWanted(mesh_position);
 			v3s16 pos;
 			int i = 0;
 			for (pos.X = q->p.X - 1; pos.X <= q->p.X + mesh_grid.cell_size; pos.X++)
@@ -130,6 +123,7 @@ bool MeshUpdateQueue::addBlock(Map *map, v3s16 p, bool ack_block_to_server, bool
 	q->crack_level = m_client->getCrackLevel();
 	q->crack_pos = m_client->getCrackPos();
 	q->urgent = urgent;
+	q->lod = isLodWanted(mesh_position);
 	q->map_blocks = std::move(map_blocks);
 	m_queue.push_back(q);
 
@@ -138,7 +132,7 @@ bool MeshUpdateQueue::addBlock(Map *map, v3s16 p, bool ack_block_to_server, bool
 
 // Returned pointer must be deleted
 // Returns NULL if queue is empty
-QueuedMeshUpdate *MeshUpdateQueue::pop()
+QueuedMeshUpdate *MeshUpdateQueue::pop(MeshMakeData &data)
 {
 	QueuedMeshUpdate *result = NULL;
 	{
@@ -162,7 +156,7 @@ QueuedMeshUpdate *MeshUpdateQueue::pop()
 	}
 
 	if (result)
-		fillDataFromMapBlocks(result);
+		fillDataFromMapBlocks(result, data);
 
 	return result;
 }
@@ -173,14 +167,32 @@ void MeshUpdateQueue::done(v3s16 pos)
 	m_inflight_blocks.erase(pos);
 }
 
+void MeshUpdateQueue::setLodTile(const TileSpec &tile)
+{
+	m_lod_tile = tile;
+}
 
-void MeshUpdateQueue::fillDataFromMapBlocks(QueuedMeshUpdate *q)
+bool MeshUpdateQueue::isLodWanted(v3s16 mesh_position)
 {
+	Camera *camera = m_client->getCamera();
+	if (!m_lod_tile || m_cache_lod_distance == 0 || !camera)
+		return false;
+
 	auto mesh_grid = m_client->getMeshGrid();
-	MeshMakeData *data = new MeshMakeData(m_client->ndef(), MAP_BLOCKSIZE * mesh_grid.cell_size, m_cache_enable_shaders);
-	q->data = data;
+	v3f center = intToFloat(mesh_position * MAP_BLOCKSIZE, BS) +
+			v3f((mesh_grid.cell_size * MAP_BLOCKSIZE - 1) * BS / 2.0f);
+	// Somewhat closer than where they are first drawn, so that they are
+	// ready when the camera moves away. Meshes made without them are
+	// rebuilt by the ClientMap once they need them.
+	return camera->getPosition().getDistanceFrom(center) >=
+			0.75f * m_cache_lod_distance * BS;
+}
 
-	data->fillBlockDataBegin(q->p);
+
+void MeshUpdateQueue::fillDataFromMapBlocks(QueuedMeshUpdate *q, MeshMakeData &data)
+{
+	auto mesh_grid = m_client->getMeshGrid();
+	data.fillBlockDataBegin(q->p);
 
 	v3s16 pos;
 	int i = 0;
@@ -188,11 +200,12 @@ void MeshUpdateQueue::fillDataFromMapBlocks(QueuedMeshUpdate *q)
 	for (pos.Z = q->p.Z - 1; pos.Z <= q->p.Z + mesh_grid.cell_size; pos.Z++)
 	for (pos.Y = q->p.Y - 1; pos.Y <= q->p.Y + mesh_grid.cell_size; pos.Y++) {
 		MapBlock *block = q->map_blocks[i++];
-		data->fillBlockData(pos, block ? block->getData() : block_placeholder.data);
+		data.fillBlockData(pos, block ? block->getData() : block_placeholder.data);
 	}
 
-	data->setCrack(q->crack_level, q->crack_pos);
-	data->setSmoothLighting(m_cache_smooth_lighting);
+	data.setCrack(q->crack_level, q->crack_pos);
+	data.setSmoothLighting(m_cache_smooth_lighting);
+	data.setLodTile(q->lod ? &*m_lod_tile : nullptr);
 }
 
 /*
@@ -200,7 +213,8 @@ void MeshUpdateQueue::fillDataFromMapBlocks(QueuedMeshUpdate *q)
 */
 
 MeshUpdateWorkerThread::MeshUpdateWorkerThread(Client *client, MeshUpdateQueue *queue_in, MeshUpdateManager *manager, v3s16 *camera_offset) :
-		UpdateThread("Mesh"), m_client(client), m_queue_in(queue_in), m_manager(manager), m_camera_offset(camera_offset)
+		UpdateThread("Mesh"), m_client(client), m_queue_in(queue_in), m_manager(manager), m_camera_offset(camera_offset),
+		m_collector(v3f())
 {
 	m_generation_interval = g_settings->getU16("mesh_generation_interval");
 	m_generation_interval = rangelim(m_generation_interval, 0, 50);
@@ -208,8 +222,14 @@ MeshUpdateWorkerThread::MeshUpdateWorkerThread(Client *client, MeshUpdateQueue *
 
 void MeshUpdateWorkerThread::doUpdate()
 {
+	// The mesh grid is only known once the client has been set up
+	if (!m_data) {
+		m_data = std::make_unique<MeshMakeData>(m_client->ndef(),
+				MAP_BLOCKSIZE * m_client->getMeshGrid().cell_size);
+	}
+
 	QueuedMeshUpdate *q;
-	while ((q = m_queue_in->pop())) {
+	while ((q = m_queue_in->pop(*m_data))) {
 		if (m_generation_interval)
 			sleep_ms(m_generation_interval);
 
@@ -217,12 +237,13 @@ void MeshUpdateWorkerThread::doUpdate()
 
 		ScopeProfiler sp(g_profiler, "Client: Mesh making (sum)");
 
-		MapBlockMesh *mesh_new = new MapBlockMesh(m_client, q->data, *m_camera_offset);
+		MapBlockMesh *mesh_new = new MapBlockMesh(m_client, m_data.get(),
+				m_collector, *m_camera_offset);
 
 		MeshUpdateResult r;
 		r.p = q->p;
 		r.mesh = mesh_new;
-		r.solid_sides = get_solid_sides(q->data);
+		r.solid_sides = get_solid_sides(m_data.get());
 		r.ack_list = std::move(q->ack_list);
 		r.urgent = q->urgent;
 		r.map_blocks = q->map_blocks;
@@ -277,6 +298,11 @@ void MeshUpdateManager::updateBlock(Map *map, v3s16 p, bool ack_block_to_server,
 	deferUpdate();
 }
 
+void MeshUpdateManager::setLodTile(const TileSpec &tile)
+{
+	m_queue_in.setLodTile(tile);
+}
+
 void MeshUpdateManager::putResult(const MeshUpdateResult &result)
 {
 	if (result.urgent)
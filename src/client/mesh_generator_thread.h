@@ -6,9 +6,11 @@
 
 #include <ctime>
 #include <mutex>
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
 #include "mapblock_mesh.h"
+#include "meshgen/collector.h"
 #include "threading/mutex_auto_lock.h"
 #include "util/thread.h"
 #include <vector>
@@ -21,12 +23,12 @@ struct QueuedMeshUpdate
 	std::vector<v3s16> ack_list;
 	int crack_level = -1;
 	v3s16 crack_pos;
-	MeshMakeData *data = nullptr; // This is generated in MeshUpdateQueue::pop()
 	std::vector<MapBlock *> map_blocks;
 	bool urgent = false;
+	// Whether to also build the simplified meshes for far terrain
+	bool lod = false;
 
 	QueuedMeshUpdate() = default;
-	~QueuedMeshUpdate();
 };
 
 /*
@@ -51,11 +53,16 @@ class MeshUpdateQueue
 
 	// Returned pointer must be deleted
 	// Returns NULL if queue is empty
-	QueuedMeshUpdate *pop();
+	// Fills data with the nodes of the returned update
+	QueuedMeshUpdate *pop(MeshMakeData &data);
 
 	// Marks a position as finished, unblocking the next update
 	void done(v3s16 pos);
 
+	// Makes the updates also build simplified meshes for far terrain,
+	// drawn with this tile. Must be called before the updates start.
+	void setLodTile(const TileSpec &tile);
+
 	u32 size()
 	{
 		MutexAutoLock lock(m_mutex);
@@ -70,10 +77,15 @@ class MeshUpdateQueue
 	std::mutex m_mutex;
 
 	// TODO: Add callback to update these when g_settings changes
-	bool m_cache_enable_shaders;
 	bool m_cache_smooth_lighting;
+	u16 m_cache_lod_distance;
+	std::optional<TileSpec> m_lod_tile;
+
+	// Whether the mesh at the given position is far enough from the camera
+	// to need the simplified meshes soon
+	bool isLodWanted(v3s16 mesh_position);
 
-	void fillDataFromMapBlocks(QueuedMeshUpdate *q);
+	void fillDataFromMapBlocks(QueuedMeshUpdate *q, MeshMakeData &data);
 	void cleanupCache();
 };
 
@@ -105,6 +117,11 @@ class MeshUpdateWorkerThread : public UpdateThread
 	MeshUpdateManager *m_manager;
 	v3s16 *m_camera_offset;
 
+	// Reused by all updates of this thread, so that meshing doesn't need
+	// to allocate once they have grown large enough
+	std::unique_ptr<MeshMakeData> m_data;
+	MeshCollector m_collector;
+
 	// TODO: Add callback to update these when g_settings changes
 	int m_generation_interval;
 };
@@ -118,6 +135,7 @@ class MeshUpdateManager
 	// update for the block at p
 	void updateBlock(Map *map, v3s16 p, bool ack_block_to_server, bool urgent,
 			bool update_neighbors = false);
+	void setLodTile(const TileSpec &tile);
 	void putResult(const MeshUpdateResult &r);
 	bool getNextResult(MeshUpdateResult &r);
 
@@ -90,6 +90,27 @@ PreMeshBuffer &MeshCollector::findBuffer(
 	for (PreMeshBuffer &p : buffers)
 		if (p.layer == layer && p.vertices.size() + numVertices <= U16_MAX)
 			return p;
-	buffers.emplace_back(layer);
+	if (m_spare_buffers.empty()) {
+		buffers.emplace_back(layer);
+	} else {
+		buffers.push_back(std::move(m_spare_buffers.back()));
+		m_spare_buffers.pop_back();
+		buffers.back().layer = layer;
+	}
 	return buffers.back();
 }
+
+void MeshCollector::clear(const v3f center_pos, v3f offset)
+{
+	for (auto &buffers : prebuffers) {
+		for (PreMeshBuffer &p : buffers) {
+			p.indices.clear();
+			p.vertices.clear();
+			m_spare_buffers.push_back(std::move(p));
+		}
+		buffers.clear();
+	}
+	m_bounding_radius_sq = 0.0f;
+	m_center_pos = center_pos;
+	this->offset = offset;
+}
@@ -32,6 +32,9 @@ struct MeshCollector
 	// offset: offset added to vertices
 	MeshCollector(const v3f center_pos, v3f offset = v3f()) : m_center_pos(center_pos), offset(offset) {}
 
+	// Removes all buffers, keeping their memory for the next mesh
+	void clear(const v3f center_pos, v3f offset = v3f());
+
 	void append(const TileSpec &material,
 			const video::S3DVertex *vertices, u32 numVertices,
 			const u16 *indices, u32 numIndices);
@@ -52,4 +55,7 @@ struct MeshCollector
 			u8 layernum, bool use_scale = false);
 
 	PreMeshBuffer &findBuffer(const TileLayer &layer, u8 layernum, u32 numVertices);
+
+	// Emptied buffers left by clear(), to be reused by findBuffer()
+	std::vector<PreMeshBuffer> m_spare_buffers;
 };
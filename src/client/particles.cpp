@@ -42,16 +42,11 @@ Particle::Particle(
 		ParticleSpawner *parent,
 		std::unique_ptr<ClientParticleTexture> owned_texture
 	) :
-		m_expiration(p.expirationtime),
-
 		m_base_color(color),
 
 		m_texture(texture),
 		m_texpos(texpos),
 		m_texsize(texsize),
-		m_pos(p.pos),
-		m_velocity(p.vel),
-		m_acceleration(p.acc),
 		m_p(p),
 
 		m_parent(parent),
@@ -76,56 +71,14 @@ bool Particle::attachToBuffer(ParticleBuffer *buffer)
 	return false;
 }
 
-void Particle::step(float dtime, ClientEnvironment *env)
+void Particle::step(float dtime, ClientEnvironment *env, ParticleMotion &motion,
+		size_t index, const ParticleBillboard &billboard)
 {
-	m_time += dtime;
-
-	// apply drag (not handled by collisionMoveSimple) and brownian motion
-	v3f av = vecAbsolute(m_velocity);
-	av -= av * (m_p.drag * dtime);
-	m_velocity = av*vecSign(m_velocity) + v3f(m_p.jitter.pickWithin())*dtime;
-
-	if (m_p.collisiondetection) {
-		aabb3f box(v3f(-m_p.size / 2.0f), v3f(m_p.size / 2.0f));
-		v3f p_pos = m_pos * BS;
-		v3f p_velocity = m_velocity * BS;
-		collisionMoveResult r = collisionMoveSimple(env, env->getGameDef(), BS * 0.5f,
-			box, 0.0f, dtime, &p_pos, &p_velocity, m_acceleration * BS, nullptr,
-			m_p.object_collision);
-
-		f32 bounciness = m_p.bounce.pickWithin();
-		if (r.collides && (m_p.collision_removal || bounciness > 0)) {
-			if (m_p.collision_removal) {
-				// force expiration of the particle
-				m_expiration = -1.0f;
-			} else if (bounciness > 0) {
-				/* cheap way to get a decent bounce effect is to only invert the
-				 * largest component of the velocity vector, so e.g. you don't
-				 * have a rock immediately bounce back in your face when you try
-				 * to skip it across the water (as would happen if we simply
-				 * downscaled and negated the velocity vector). this means
-				 * bounciness will work properly for cubic objects, but meshes
-				 * with diagonal angles and entities will not yield the correct
-				 * visual. this is probably unavoidable */
-				if (av.Y > av.X && av.Y > av.Z) {
-					m_velocity.Y = -(m_velocity.Y * bounciness);
-				} else if (av.X > av.Y && av.X > av.Z) {
-					m_velocity.X = -(m_velocity.X * bounciness);
-				} else if (av.Z > av.Y && av.Z > av.X) {
-					m_velocity.Z = -(m_velocity.Z * bounciness);
-				} else { // well now we're in a bit of a pickle
-					m_velocity = -(m_velocity * bounciness);
-				}
-			}
-		} else {
-			m_velocity = p_velocity / BS;
-		}
-		m_pos = p_pos / BS;
+	if (motion.collides[index]) {
+		collide(dtime, env, motion, index);
 	} else {
-		// apply velocity and acceleration to position
-		m_pos += (m_velocity + m_acceleration * 0.5f * dtime) * dtime;
-		// apply acceleration to velocity
-		m_velocity += m_acceleration * dtime;
+		// brownian motion
+		motion.velocity[index] += v3f(m_p.jitter.pickWithin()) * dtime;
 	}
 
 	if (m_p.animation.type != TAT_NONE) {
@@ -141,28 +94,77 @@ void Particle::step(float dtime, ClientEnvironment *env)
 		}
 	}
 
+	const float age = motion.time[index] / (motion.expiration[index] + 0.1f);
+
 	// animate particle alpha in accordance with settings
 	float alpha = 1.f;
 	if (m_texture.tex != nullptr)
-		alpha = m_texture.tex -> alpha.blend(m_time / (m_expiration+0.1f));
+		alpha = m_texture.tex -> alpha.blend(age);
 
 	// Update lighting
-	auto col = updateLight(env);
+	auto col = updateLight(env, motion.pos[index]);
 	col.setAlpha(255 * alpha);
 
 	// Update model
-	updateVertices(env, col);
+	updateVertices(col, motion.pos[index], age, billboard);
 }
 
-video::SColor Particle::updateLight(ClientEnvironment *env)
+void Particle::collide(float dtime, ClientEnvironment *env, ParticleMotion &motion,
+		size_t index)
+{
+	v3f &pos = motion.pos[index];
+	v3f &velocity = motion.velocity[index];
+
+	// drag was already applied, add brownian motion
+	v3f av = vecAbsolute(velocity);
+	velocity += v3f(m_p.jitter.pickWithin()) * dtime;
+
+	aabb3f box(v3f(-m_p.size / 2.0f), v3f(m_p.size / 2.0f));
+	v3f p_pos = pos * BS;
+	v3f p_velocity = velocity * BS;
+	collisionMoveResult r = collisionMoveSimple(env, env->getGameDef(), BS * 0.5f,
+		box, 0.0f, dtime, &p_pos, &p_velocity, motion.acceleration[index] * BS, nullptr,
+		m_p.object_collision);
+
+	f32 bounciness = m_p.bounce.pickWithin();
+	if (r.collides && (m_p.collision_removal || bounciness > 0)) {
+		if (m_p.collision_removal) {
+			// force expiration of the particle
+			motion.expiration[index] = -1.0f;
+		} else if (bounciness > 0) {
+			/* cheap way to get a decent bounce effect is to only invert the
+			 * largest component of the velocity vector, so e.g. you don't
+			 * have a rock immediately bounce back in your face when you try
+			 * to skip it across the water (as would happen if we simply
+			 * downscaled and negated the velocity vector). this means
+			 * bounciness will work properly for cubic objects, but meshes
+			 * with diagonal angles and entities will not yield the correct
+			 * visual. this is probably unavoidable */
+			if (av.Y > av.X && av.Y > av.Z) {
+				velocity.Y = -(velocity.Y * bounciness);
+			} else if (av.X > av.Y && av.X > av.Z) {
+				velocity.X = -(velocity.X * bounciness);
+			} else if (av.Z > av.Y && av.Z > av.X) {
+				velocity.Z = -(velocity.Z * bounciness);
+			} else { // well now we're in a bit of a pickle
+				velocity = -(velocity * bounciness);
+			}
+		}
+	} else {
+		velocity = p_velocity / BS;
+	}
+	pos = p_pos / BS;
+}
+
+video::SColor Particle::updateLight(ClientEnvironment *env, v3f pos)
 {
 	u8 light = 0;
 	bool pos_ok;
 
 	v3s16 p = v3s16(
-		floor(m_pos.X+0.5),
-		floor(m_pos.Y+0.5),
-		floor(m_pos.Z+0.5)
+		floor(pos.X+0.5),
+		floor(pos.Y+0.5),
+		floor(pos.Z+0.5)
 	);
 	MapNode n = env->getClientMap().getNode(p, &pos_ok);
 	if (pos_ok)
@@ -178,7 +180,8 @@ video::SColor Particle::updateLight(ClientEnvironment *env)
 		m_light * m_base_color.getBlue() / 255);
 }
 
-void Particle::updateVertices(ClientEnvironment *env, video::SColor color)
+void Particle::updateVertices(video::SColor color, v3f pos, float age,
+		const ParticleBillboard &billboard)
 {
 	f32 tx0, tx1, ty0, ty1;
 	v2f scale;
@@ -189,7 +192,7 @@ void Particle::updateVertices(ClientEnvironment *env, video::SColor color)
 	video::S3DVertex *vertices = m_buffer->getVertices(m_index);
 
 	if (m_texture.tex != nullptr)
-		scale = m_texture.tex -> scale.blend(m_time / (m_expiration+0.1));
+		scale = m_texture.tex -> scale.blend(age);
 	else
 		scale = v2f(1.f, 1.f);
 
@@ -212,33 +215,102 @@ void Particle::updateVertices(ClientEnvironment *env, video::SColor color)
 		ty1 = m_texpos.Y + m_texsize.Y;
 	}
 
-	auto half = m_p.size * .5f,
-	     hx   = half * scale.X,
-	     hy   = half * scale.Y;
-	vertices[0] = video::S3DVertex(-hx, -hy,
-		0, 0, 0, 0, color, tx0, ty1);
-	vertices[1] = video::S3DVertex(hx, -hy,
-		0, 0, 0, 0, color, tx1, ty1);
-	vertices[2] = video::S3DVertex(hx, hy,
-		0, 0, 0, 0, color, tx1, ty0);
-	vertices[3] = video::S3DVertex(-hx, hy,
-		0, 0, 0, 0, color, tx0, ty0);
+	v3f right = billboard.right;
+	v3f up = billboard.up;
+	if (m_p.vertical) {
+		// turn towards the player around the Y axis only
+		v3f dir = billboard.player_pos - pos;
+		f32 len = std::sqrt(dir.X * dir.X + dir.Z * dir.Z);
+		right = len > 0 ? v3f(-dir.Z / len, 0, dir.X / len) : v3f(0, 0, 1);
+		up = v3f(0, 1, 0);
+	}
+
+	auto half = m_p.size * .5f;
+	right *= half * scale.X;
+	up *= half * scale.Y;
 
 	// Update position -- see #10398
-	auto *player = env->getLocalPlayer();
-	v3s16 camera_offset = env->getCameraOffset();
-
-	for (u16 i = 0; i < 4; i++) {
-		video::S3DVertex &vertex = vertices[i];
-		if (m_p.vertical) {
-			v3f ppos = player->getPosition() / BS;
-			vertex.Pos.rotateXZBy(std::atan2(ppos.Z - m_pos.Z, ppos.X - m_pos.X) /
-				core::DEGTORAD + 90);
-		} else {
-			vertex.Pos.rotateYZBy(player->getPitch());
-			vertex.Pos.rotateXZBy(player->getYaw());
-		}
-		vertex.Pos += m_pos * BS - intToFloat(camera_offset, BS);
+	const v3f center = pos * BS - billboard.camera_offset;
+
+	vertices[0] = video::S3DVertex(center - right - up,
+		v3f(), color, v2f(tx0, ty1));
+	vertices[1] = video::S3DVertex(center + right - up,
+		v3f(), color, v2f(tx1, ty1));
+	vertices[2] = video::S3DVertex(center + right + up,
+		v3f(), color, v2f(tx1, ty0));
+	vertices[3] = video::S3DVertex(center - right + up,
+		v3f(), color, v2f(tx0, ty0));
+}
+
+/*
+	ParticleMotion
+*/
+
+void ParticleMotion::add(const ParticleParameters &p)
+{
+	pos.push_back(p.pos);
+	velocity.push_back(p.vel);
+	acceleration.push_back(p.acc);
+	drag.push_back(p.drag);
+	time.push_back(0.0f);
+	expiration.push_back(p.expirationtime);
+	collides.push_back(p.collisiondetection);
+}
+
+void ParticleMotion::swapRemove(size_t i)
+{
+	auto remove = [i] (auto &v) {
+		v[i] = v.back();
+		v.pop_back();
+	};
+	remove(pos);
+	remove(velocity);
+	remove(acceleration);
+	remove(drag);
+	remove(time);
+	remove(expiration);
+	remove(collides);
+}
+
+void ParticleMotion::reserve(size_t n)
+{
+	pos.reserve(n);
+	velocity.reserve(n);
+	acceleration.reserve(n);
+	drag.reserve(n);
+	time.reserve(n);
+	expiration.reserve(n);
+	collides.reserve(n);
+}
+
+void ParticleMotion::clear()
+{
+	pos.clear();
+	velocity.clear();
+	acceleration.clear();
+	drag.clear();
+	time.clear();
+	expiration.clear();
+	collides.clear();
+}
+
+void ParticleMotion::step(float dtime)
+{
+	const size_t n = size();
+
+	for (size_t i = 0; i < n; i++) {
+		time[i] += dtime;
+		// drag (not handled by collisionMoveSimple)
+		velocity[i] -= velocity[i] * drag[i] * dtime;
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		if (collides[i])
+			continue;
+		// apply velocity and acceleration to position
+		pos[i] += (velocity[i] + acceleration[i] * (0.5f * dtime)) * dtime;
+		// apply acceleration to velocity
+		velocity[i] += acceleration[i] * dtime;
 	}
 }
 
@@ -695,9 +767,8 @@ void ParticleManager::stepParticles(float dtime)
 	MutexAutoLock lock(m_particle_list_lock);
 
 	for (size_t i = 0; i < m_particles.size();) {
-		Particle &p = *m_particles[i];
-		if (p.isExpired()) {
-			ParticleSpawner *parent = p.getParent();
+		if (m_motion.isExpired(i)) {
+			ParticleSpawner *parent = m_particles[i]->getParent();
 			if (parent) {
 				assert(parent->hasActive());
 				parent->decrActive();
@@ -705,11 +776,27 @@ void ParticleManager::stepParticles(float dtime)
 			// delete
 			m_particles[i] = std::move(m_particles.back());
 			m_particles.pop_back();
+			m_motion.swapRemove(i);
 		} else {
-			p.step(dtime, m_env);
 			++i;
 		}
 	}
+
+	m_motion.step(dtime);
+
+	// Same as rotating by the pitch and then the yaw of the player
+	LocalPlayer *player = m_env->getLocalPlayer();
+	const f32 pitch = player->getPitch() * core::DEGTORAD;
+	const f32 yaw = player->getYaw() * core::DEGTORAD;
+	ParticleBillboard billboard;
+	billboard.right = v3f(std::cos(yaw), 0, std::sin(yaw));
+	billboard.up = v3f(-std::sin(pitch) * std::sin(yaw), std::cos(pitch),
+			std::sin(pitch) * std::cos(yaw));
+	billboard.player_pos = player->getPosition() / BS;
+	billboard.camera_offset = intToFloat(m_env->getCameraOffset(), BS);
+
+	for (size_t i = 0; i < m_particles.size(); i++)
+		m_particles[i]->step(dtime, m_env, m_motion, i, billboard);
 }
 
 void ParticleManager::stepBuffers(float dtime)
@@ -750,6 +837,7 @@ void ParticleManager::clearAll()
 	m_dying_particle_spawners.clear();
 
 	m_particles.clear();
+	m_motion.clear();
 
 	// have to remove from scene first because it keeps a reference
 	for (auto &it : m_particle_buffers)
@@ -938,6 +1026,7 @@ void ParticleManager::reserveParticleSpace(size_t max_estimate)
 	MutexAutoLock lock(m_particle_list_lock);
 
 	m_particles.reserve(m_particles.size() + max_estimate);
+	m_motion.reserve(m_particles.capacity());
 }
 
 video::SMaterial ParticleManager::getMaterialForParticle(const ClientParticleTexRef &texture)
@@ -1033,6 +1122,7 @@ bool ParticleManager::addParticle(std::unique_ptr<Particle> toadd)
 		infostream << "ParticleManager: buffer full, dropping particle" << std::endl;
 		return false;
 	}
+	m_motion.add(toadd->getParameters());
 	m_particles.push_back(std::move(toadd));
 	return true;
 }
@@ -51,6 +51,46 @@ struct ClientParticleTexRef
 class ParticleSpawner;
 class ParticleBuffer;
 
+/**
+ * Motion state of all particles, with one array per attribute.
+ * Index i belongs to the i-th particle of the ParticleManager, so that
+ * the particles without collision detection can be moved in bulk loops.
+ */
+struct ParticleMotion
+{
+	std::vector<v3f> pos;
+	std::vector<v3f> velocity;
+	std::vector<v3f> acceleration;
+	std::vector<v3f> drag;
+	std::vector<float> time;
+	std::vector<float> expiration;
+	// moved by the particle itself using collision detection
+	std::vector<u8> collides;
+
+	size_t size() const { return pos.size(); }
+	bool isExpired(size_t i) const { return expiration[i] < time[i]; }
+
+	void add(const ParticleParameters &p);
+	/// Replaces the entry at `i` with the last one
+	void swapRemove(size_t i);
+	void reserve(size_t n);
+	void clear();
+
+	/// Applies drag and moves the particles without collision detection
+	void step(float dtime);
+};
+
+/// Orientation shared by all particles of a step
+struct ParticleBillboard
+{
+	// unit vectors spanning the plane facing the camera
+	v3f right;
+	v3f up;
+	// for vertical particles, in nodes
+	v3f player_pos;
+	v3f camera_offset;
+};
+
 class Particle
 {
 public:
@@ -68,10 +108,12 @@ class Particle
 
 	DISABLE_CLASS_COPY(Particle)
 
-	void step(float dtime, ClientEnvironment *env);
+	/// Moves the particle if it uses collision detection and updates its
+	/// vertices. Everything else about the motion is done by ParticleMotion.
+	void step(float dtime, ClientEnvironment *env, ParticleMotion &motion,
+			size_t index, const ParticleBillboard &billboard);
 
-	bool isExpired () const
-	{ return m_expiration < m_time; }
+	const ParticleParameters &getParameters() const { return m_p; }
 
 	ParticleSpawner *getParent() const { return m_parent; }
 
@@ -81,24 +123,21 @@ class Particle
 	bool attachToBuffer(ParticleBuffer *buffer);
 
 private:
-	video::SColor updateLight(ClientEnvironment *env);
-	void updateVertices(ClientEnvironment *env, video::SColor color);
+	void collide(float dtime, ClientEnvironment *env, ParticleMotion &motion,
+			size_t index);
+	video::SColor updateLight(ClientEnvironment *env, v3f pos);
+	void updateVertices(video::SColor color, v3f pos, float age,
+			const ParticleBillboard &billboard);
 
 	ParticleBuffer *m_buffer = nullptr;
 	u16 m_index; // index in m_buffer
 
-	float m_time = 0.0f;
-	float m_expiration;
-
 	// Color without lighting
 	video::SColor m_base_color;
 
 	ClientParticleTexRef m_texture;
 	v2f m_texpos;
 	v2f m_texsize;
-	v3f m_pos;
-	v3f m_velocity;
-	v3f m_acceleration;
 
 	const ParticleParameters m_p;
 
@@ -246,6 +285,8 @@ class ParticleManager
 	void clearAll();
 
 	std::vector<std::unique_ptr<Particle>> m_particles;
+	// same order as m_particles
+	ParticleMotion m_motion;
 	std::unordered_map<u64, std::unique_ptr<ParticleSpawner>> m_particle_spawners;
 	std::vector<std::unique_ptr<ParticleSpawner>> m_dying_particle_spawners;
 	std::vector<irr_ptr<ParticleBuffer>> m_particle_buffers;
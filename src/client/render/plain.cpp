@@ -87,7 +87,7 @@ void UpscaleStep::run(PipelineContext &context)
 std::unique_ptr<RenderStep> create3DStage(Client *client, v2f scale)
 {
 	RenderStep *step = new Draw3D();
-	if (g_settings->getBool("enable_shaders") && g_settings->getBool("enable_post_processing")) {
+	if (g_settings->getBool("enable_post_processing")) {
 		RenderPipeline *pipeline = new RenderPipeline();
 		pipeline->addStep(pipeline->own(std::unique_ptr<RenderStep>(step)));
 
@@ -111,8 +111,8 @@ RenderStep* addUpscaling(RenderPipeline *pipeline, RenderStep *previousStep, v2f
 	if (downscale_factor.X == 1.0f && downscale_factor.Y == 1.0f)
 		return previousStep;
 
-	// When shaders are enabled, post-processing pipeline takes care of rescaling
-	if (g_settings->getBool("enable_shaders") && g_settings->getBool("enable_post_processing"))
+	// When post-processing is enabled, its pipeline takes care of rescaling
+	if (g_settings->getBool("enable_post_processing"))
 		return previousStep;
 
 
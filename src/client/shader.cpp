@@ -192,11 +192,71 @@ class ShaderCallback : public video::IShaderConstantSetCallBack
 	MainShaderConstantSetter: Set basic constants required for almost everything
 */
 
+u32 getMaxSkinningJoints()
+{
+	if (!g_settings->getBool("enable_gpu_skinning"))
+		return 0;
+
+	// The driver doesn't change while the client runs
+	static const u32 max_joints = [] () -> u32 {
+		video::IVideoDriver *driver = RenderingEngine::get_video_driver();
+		s32 vectors = 0;
+		switch (driver->getDriverType()) {
+		case video::EDT_OGLES2:
+			GL.GetIntegerv(GL.MAX_VERTEX_UNIFORM_VECTORS, &vectors);
+			break;
+		case video::EDT_OPENGL:
+		case video::EDT_OPENGL3: {
+			s32 components = 0;
+			GL.GetIntegerv(GL.MAX_VERTEX_UNIFORM_COMPONENTS, &components);
+			vectors = components / 4;
+			break;
+		}
+		default:
+			return 0;
+		}
+
+		// Each joint takes 4 vectors, the rest of the object shader fewer
+		// than 32. Below 16 joints barely any model could be skinned.
+		s32 joints = std::min<s32>((vectors - 32) / 4, MAX_SKINNING_JOINTS);
+		if (joints < 16) {
+			warningstream << "GPU skinning disabled, the driver supports only "
+				<< vectors << " vertex shader uniform vectors" << std::endl;
+			return 0;
+		}
+		infostream << "GPU skinning meshes with up to " << joints << " joints"
+			<< std::endl;
+		return joints;
+	}();
+	return max_joints;
+}
+
+void SkinningShaderSetting::set(video::IMaterialRendererServices *services)
+{
+	u32 count;
+	const core::matrix4 *matrices = services->getVideoDriver()->getSkinningMatrices(count);
+	count = std::min(count, m_max_joints);
+
+	s32 skinning = count > 0;
+	m_skinning.set(&skinning, services);
+	if (count > 0) {
+		if (!m_joint_matrices_found) {
+			m_joint_matrices_id = services->getVertexShaderConstantID("mJointMatrices");
+			m_joint_matrices_found = true;
+		}
+		services->setVertexShaderConstant(m_joint_matrices_id,
+				matrices[0].pointer(), count * 16);
+	}
+}
+
 class MainShaderConstantSetter : public IShaderConstantSetter
 {
 	CachedVertexShaderSetting<f32, 16> m_world_view_proj{"mWorldViewProj"};
 	CachedVertexShaderSetting<f32, 16> m_world{"mWorld"};
 
+	bool m_gpu_skinning = getMaxSkinningJoints() > 0;
+	SkinningShaderSetting m_skinning;
+
 	// Modelview matrix
 	CachedVertexShaderSetting<float, 16> m_world_view{"mWorldView"};
 	// Texture matrix
@@ -241,6 +301,9 @@ class MainShaderConstantSetter : public IShaderConstantSetter
 
 		video::SColorf colorf(m_material_color);
 		m_material_color_setting.set(colorf, services);
+
+		if (m_gpu_skinning)
+			m_skinning.set(services);
 	}
 };
 
@@ -307,9 +370,6 @@ class ShaderSource : public IWritableShaderSource
 
 private:
 
-	// Are shaders even enabled?
-	bool m_enabled;
-
 	// The id of the thread that is allowed to use irrlicht directly
 	std::thread::id m_main_thread;
 
@@ -348,12 +408,6 @@ ShaderSource::ShaderSource()
 	// Add a dummy ShaderInfo as the first index, named ""
 	m_shaderinfo_cache.emplace_back();
 
-	m_enabled = g_settings->getBool("enable_shaders");
-	if (!m_enabled) {
-		warningstream << "You are running " PROJECT_NAME_C " with shaders disabled, "
-			"this is not a recommended configuration." << std::endl;
-	}
-
 	// Add main global constant setter
 	addShaderConstantSetterFactory(new MainShaderConstantSetterFactory());
 }
@@ -362,9 +416,6 @@ ShaderSource::~ShaderSource()
 {
 	MutexAutoLock lock(m_shaderinfo_cache_mutex);
 
-	if (!m_enabled)
-		return;
-
 	// Delete materials
 	auto *gpu = RenderingEngine::get_video_driver()->getGPUProgrammingServices();
 	for (ShaderInfo &i : m_shaderinfo_cache) {
@@ -495,9 +546,6 @@ void ShaderSource::rebuildShaders()
 {
 	MutexAutoLock lock(m_shaderinfo_cache_mutex);
 
-	if (!m_enabled)
-		return;
-
 	// Delete materials
 	auto *gpu = RenderingEngine::get_video_driver()->getGPUProgrammingServices();
 	for (ShaderInfo &i : m_shaderinfo_cache) {
@@ -546,9 +594,6 @@ ShaderInfo ShaderSource::generateShader(const std::string &name,
 	}
 	shaderinfo.material = shaderinfo.base_material;
 
-	if (!m_enabled)
-		return shaderinfo;
-
 	video::IVideoDriver *driver = RenderingEngine::get_video_driver();
 	auto *gpu = driver->getGPUProgrammingServices();
 	if (!driver->queryFeature(video::EVDF_ARB_GLSL) || !gpu) {
@@ -582,7 +627,7 @@ ShaderInfo ShaderSource::generateShader(const std::string &name,
 			attribute lowp vec4 inVertexColor;
 			attribute mediump vec2 inTexCoord0;
 			attribute mediump vec3 inVertexNormal;
-			attribute mediump vec4 inVertexTangent;
+			attribute highp vec4 inVertexTangent;
 			attribute mediump vec4 inVertexBinormal;
 		)";
 		// Our vertex color has components reversed compared to what OpenGL
@@ -730,6 +775,11 @@ ShaderInfo ShaderSource::generateShader(const std::string &name,
 		shaders_header << "#define VOLUMETRIC_LIGHT 1\n";
 	}
 
+	if (u32 max_joints = getMaxSkinningJoints()) {
+		shaders_header << "#define ENABLE_GPU_SKINNING 1\n";
+		shaders_header << "#define MAX_SKINNING_JOINTS " << max_joints << "\n";
+	}
+
 	shaders_header << "#line 0\n"; // reset the line counter for meaningful diagnostics
 
 	std::string common_header = shaders_header.str();
@@ -194,6 +194,32 @@ using CachedStructVertexShaderSetting = CachedStructShaderSetting<T, count, cach
 template<typename T, std::size_t count, bool cache = true>
 using CachedStructPixelShaderSetting = CachedStructShaderSetting<T, count, cache, true>;
 
+// Most joints a mesh can have to be skinned in the shaders
+constexpr u32 MAX_SKINNING_JOINTS = 64;
+
+/*
+	Returns how many joints a mesh can have to be skinned in the shaders,
+	which is limited by the vertex shader uniforms the driver supports.
+	Returns 0 if GPU skinning is disabled or the driver supports too few.
+	Must be called from the thread owning the video driver.
+*/
+u32 getMaxSkinningJoints();
+
+/*
+	Passes the joint matrices of the mesh being drawn, as set by
+	IVideoDriver::setSkinningMatrices(), to the vertex shader.
+	An instance must only be used with a single shader.
+*/
+class SkinningShaderSetting {
+	CachedVertexShaderSetting<s32> m_skinning{"mSkinning"};
+	u32 m_max_joints = getMaxSkinningJoints();
+	// Looked up on first use
+	s32 m_joint_matrices_id = -1;
+	bool m_joint_matrices_found = false;
+public:
+	void set(video::IMaterialRendererServices *services);
+};
+
 /*
 	ShaderSource creates and caches shaders.
 */
@@ -106,8 +106,7 @@ void ShadowRenderer::disable()
 
 void ShadowRenderer::preInit(IWritableShaderSource *shsrc)
 {
-	if (g_settings->getBool("enable_shaders") &&
-			g_settings->getBool("enable_dynamic_shadows")) {
+	if (g_settings->getBool("enable_dynamic_shadows")) {
 		shsrc->addShaderConstantSetterFactory(new ShadowConstantSetterFactory());
 	}
 }
@@ -588,8 +587,17 @@ void ShadowRenderer::createShaders()
 		}
 		m_shadow_depth_entity_cb = new ShadowDepthShaderCB();
 
+		// entities may be skinned in the vertex shader
+		std::string depth_shader_entities_vs = readShaderFile(depth_shader_vs);
+		if (u32 max_joints = getMaxSkinningJoints()) {
+			depth_shader_entities_vs = "#define ENABLE_GPU_SKINNING 1\n"
+					"#define MAX_SKINNING_JOINTS " + std::to_string(max_joints) + "\n" +
+					depth_shader_entities_vs;
+			m_shadow_depth_entity_cb->Skinning = true;
+		}
+
 		depth_shader_entities = gpu->addHighLevelShaderMaterial(
-				readShaderFile(depth_shader_vs).c_str(), "vertexMain",
+				depth_shader_entities_vs.c_str(), "vertexMain",
 				video::EVST_VS_1_1,
 				readShaderFile(depth_shader_fs).c_str(), "pixelMain",
 				video::EPST_PS_1_2, m_shadow_depth_entity_cb);
@@ -705,14 +713,12 @@ std::string ShadowRenderer::readShaderFile(const std::string &path)
 ShadowRenderer *createShadowRenderer(IrrlichtDevice *device, Client *client)
 {
 	// disable if unsupported
-	if (g_settings->getBool("enable_dynamic_shadows") && (
-		device->getVideoDriver()->getDriverType() != video::EDT_OPENGL ||
-		!g_settings->getBool("enable_shaders"))) {
+	if (g_settings->getBool("enable_dynamic_shadows") &&
+			device->getVideoDriver()->getDriverType() != video::EDT_OPENGL) {
 		g_settings->setBool("enable_dynamic_shadows", false);
 	}
 
-	if (g_settings->getBool("enable_shaders") &&
-			g_settings->getBool("enable_dynamic_shadows")) {
+	if (g_settings->getBool("enable_dynamic_shadows")) {
 		ShadowRenderer *shadow_renderer = new ShadowRenderer(device, client);
 		shadow_renderer->initialize();
 		return shadow_renderer;
@@ -78,4 +78,7 @@ void ShadowDepthShaderCB::OnSetConstants(
 	m_perspective_zbias.set(&zbias, services);
 
 	m_cam_pos_setting.set(cam_pos, services);
+
+	if (Skinning)
+		m_skinning.set(services);
 }
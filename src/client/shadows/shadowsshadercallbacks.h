@@ -61,6 +61,8 @@ class ShadowDepthShaderCB : public video::IShaderConstantSetCallBack
 	f32 MaxFar{2048.0f}, MapRes{1024.0f};
 	f32 PerspectiveBiasXY {0.9f}, PerspectiveBiasZ {0.5f};
 	v3f CameraPos;
+	// whether the shader skins meshes, see enable_gpu_skinning
+	bool Skinning {false};
 
 private:
 	CachedVertexShaderSetting<f32, 16> m_light_mvp_setting{"LightMVP"};
@@ -72,4 +74,5 @@ class ShadowDepthShaderCB : public video::IShaderConstantSetCallBack
 	CachedVertexShaderSetting<f32> m_perspective_bias1{"xyPerspectiveBias1"};
 	CachedVertexShaderSetting<f32> m_perspective_zbias{"zPerspectiveBias"};
 	CachedVertexShaderSetting<f32, 4> m_cam_pos_setting{"CameraPos"};
+	SkinningShaderSetting m_skinning;
 };
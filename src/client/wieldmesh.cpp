@@ -17,7 +17,10 @@
 #include "client/texturesource.h"
 #include "log.h"
 #include "util/numeric.h"
+#include "irr_ptr.h"
 #include <map>
+#include <sstream>
+#include <unordered_map>
 #include <IMeshManipulator.h>
 #include "client/renderingengine.h"
 
@@ -114,6 +117,9 @@ static scene::IMesh *createExtrusionMesh(int resolution_x, int resolution_y)
 	E.g. there is a single extrusion mesh that is used for all
 	16x16 px images, another for all 256x256 px images, and so on.
 
+	The finished meshes of items are cached too, so that e.g. hundreds
+	of dropped items of the same kind share one mesh and vertex buffer.
+
 	WARNING: Not thread safe. This should not be a problem since
 	rendering related classes (such as WieldMeshSceneNode) will be
 	used from the rendering thread only.
@@ -172,9 +178,37 @@ class ExtrusionMeshCache: public IReferenceCounted
 		return m_cube;
 	}
 
+	// Mesh and node materials of an item as set up by WieldMeshSceneNode
+	struct SharedItemMesh
+	{
+		irr_ptr<scene::IMesh> mesh;
+		std::vector<video::SMaterial> materials;
+		std::vector<ItemPartColor> colors;
+		v3f scale;
+	};
+
+	const SharedItemMesh *getItemMesh(const std::string &key) const
+	{
+		auto it = m_item_meshes.find(key);
+		return it == m_item_meshes.end() ? nullptr : &it->second;
+	}
+
+	void addItemMesh(const std::string &key, SharedItemMesh &&item_mesh)
+	{
+		// Forget the meshes that are no longer shown by any scene node
+		for (auto it = m_item_meshes.begin(); it != m_item_meshes.end(); ) {
+			if (it->second.mesh->getReferenceCount() == 1)
+				it = m_item_meshes.erase(it);
+			else
+				++it;
+		}
+		m_item_meshes[key] = std::move(item_mesh);
+	}
+
 private:
 	std::map<int, scene::IMesh*> m_extrusion_meshes;
 	scene::IMesh *m_cube;
+	std::unordered_map<std::string, SharedItemMesh> m_item_meshes;
 };
 
 static ExtrusionMeshCache *g_extrusion_mesh_cache = nullptr;
@@ -184,7 +218,6 @@ WieldMeshSceneNode::WieldMeshSceneNode(scene::ISceneManager *mgr, s32 id):
 	scene::ISceneNode(mgr->getRootSceneNode(), mgr, id),
 	m_material_type(video::EMT_TRANSPARENT_ALPHA_CHANNEL_REF)
 {
-	m_enable_shaders = g_settings->getBool("enable_shaders");
 	m_anisotropic_filter = g_settings->getBool("anisotropic_filter");
 	m_bilinear_filter = g_settings->getBool("bilinear_filter");
 	m_trilinear_filter = g_settings->getBool("trilinear_filter");
@@ -233,7 +266,7 @@ void WieldMeshSceneNode::setCube(const ContentFeatures &f,
 	scene::IMesh *cubemesh = g_extrusion_mesh_cache->createCube();
 	scene::SMesh *copy = cloneMesh(cubemesh);
 	cubemesh->drop();
-	postProcessNodeMesh(copy, f, false, true, &m_material_type, &m_colors, true);
+	postProcessNodeMesh(copy, f, true, &m_material_type, &m_colors, true);
 	changeToMesh(copy);
 	copy->drop();
 	m_meshnode->setScale(wield_scale * WIELD_SCALE_FACTOR);
@@ -297,7 +330,7 @@ void WieldMeshSceneNode::setExtruded(const std::string &imagename,
 static scene::SMesh *createSpecialNodeMesh(Client *client, MapNode n,
 	std::vector<ItemPartColor> *colors, const ContentFeatures &f)
 {
-	MeshMakeData mesh_make_data(client->ndef(), 1, false);
+	MeshMakeData mesh_make_data(client->ndef(), 1);
 	MeshCollector collector(v3f(0.0f * BS), v3f());
 	mesh_make_data.setSmoothLighting(false);
 	MapblockMeshGenerator gen(&mesh_make_data, &collector,
@@ -343,6 +376,42 @@ static scene::SMesh *createSpecialNodeMesh(Client *client, MapNode n,
 }
 
 void WieldMeshSceneNode::setItem(const ItemStack &item, Client *client, bool check_wield_image)
+{
+	// Everything the mesh depends on besides the item definitions
+	std::ostringstream os(std::ios::binary);
+	os << item.name << '\n' << check_wield_image << m_bilinear_filter
+		<< m_trilinear_filter << m_anisotropic_filter << '\n';
+	item.metadata.serialize(os);
+	const std::string key = os.str();
+
+	if (const auto *shared = g_extrusion_mesh_cache->getItemMesh(key)) {
+		changeToMesh(shared->mesh.get());
+		for (u32 i = 0; i < shared->materials.size(); i++)
+			m_meshnode->getMaterial(i) = shared->materials[i];
+		m_colors = shared->colors;
+		m_meshnode->setScale(shared->scale);
+		return;
+	}
+
+	createItemMesh(item, client, check_wield_image);
+
+	// Do not share the placeholder used when there is no mesh
+	scene::IMesh *mesh = m_meshnode->getMesh();
+	scene::IMesh *dummymesh = g_extrusion_mesh_cache->createCube();
+	if (mesh != dummymesh) {
+		ExtrusionMeshCache::SharedItemMesh shared;
+		shared.mesh.grab(mesh);
+		for (u32 i = 0; i < m_meshnode->getMaterialCount(); i++)
+			shared.materials.push_back(m_meshnode->getMaterial(i));
+		shared.colors = m_colors;
+		shared.scale = m_meshnode->getScale();
+		g_extrusion_mesh_cache->addItemMesh(key, std::move(shared));
+	}
+	dummymesh->drop();
+}
+
+void WieldMeshSceneNode::createItemMesh(const ItemStack &item, Client *client,
+		bool check_wield_image)
 {
 	ITextureSource *tsrc = client->getTextureSource();
 	IItemDefManager *idef = client->getItemDefManager();
@@ -354,10 +423,8 @@ void WieldMeshSceneNode::setItem(const ItemStack &item, Client *client, bool che
 
 	scene::SMesh *mesh = nullptr;
 
-	if (m_enable_shaders) {
-		u32 shader_id = shdrsrc->getShader("object_shader", TILE_MATERIAL_BASIC, NDT_NORMAL);
-		m_material_type = shdrsrc->getShaderInfo(shader_id).material;
-	}
+	u32 shader_id = shdrsrc->getShader("object_shader", TILE_MATERIAL_BASIC, NDT_NORMAL);
+	m_material_type = shdrsrc->getShaderInfo(shader_id).material;
 
 	// Color-related
 	m_colors.clear();
@@ -500,10 +567,7 @@ void WieldMeshSceneNode::setColor(video::SColor c)
 
 		if (m_colors[j].needColorize(buffercolor)) {
 			buf->setDirty(scene::EBT_VERTEX);
-			if (m_enable_shaders)
-				setMeshBufferColor(buf, buffercolor);
-			else
-				colorizeMeshBuffer(buf, &buffercolor);
+			setMeshBufferColor(buf, buffercolor);
 		}
 	}
 }
@@ -513,13 +577,9 @@ void WieldMeshSceneNode::setNodeLightColor(video::SColor color)
 	if (!m_meshnode)
 		return;
 
-	if (m_enable_shaders) {
-		for (u32 i = 0; i < m_meshnode->getMaterialCount(); ++i) {
-			video::SMaterial &material = m_meshnode->getMaterial(i);
-			material.ColorParam = color;
-		}
-	} else {
-		setColor(color);
+	for (u32 i = 0; i < m_meshnode->getMaterialCount(); ++i) {
+		video::SMaterial &material = m_meshnode->getMaterial(i);
+		material.ColorParam = color;
 	}
 }
 
@@ -538,12 +598,9 @@ void WieldMeshSceneNode::changeToMesh(scene::IMesh *mesh)
 		dummymesh->drop();  // m_meshnode grabbed it
 	} else {
 		m_meshnode->setMesh(mesh);
-		// without shaders recolored often for lighting
-		// otherwise only once
-		if (m_enable_shaders)
-			mesh->setHardwareMappingHint(scene::EHM_STATIC);
-		else
-			mesh->setHardwareMappingHint(scene::EHM_DYNAMIC);
+		// Lighting is applied by the shader, so the mesh is only recolored
+		// when the item changes
+		mesh->setHardwareMappingHint(scene::EHM_STATIC);
 	}
 
 	m_meshnode->setVisible(true);
@@ -596,7 +653,7 @@ void getItemMesh(Client *client, const ItemStack &item, ItemMesh *result)
 			} else
 				scaleMesh(mesh, v3f(1.2, 1.2, 1.2));
 			// add overlays
-			postProcessNodeMesh(mesh, f, false, false, nullptr,
+			postProcessNodeMesh(mesh, f, false, nullptr,
 				&result->buffer_colors, true);
 			if (f.drawtype == NDT_ALLFACES)
 				scaleMesh(mesh, v3f(f.visual_scale));
@@ -704,7 +761,7 @@ scene::SMesh *getExtrudedMesh(ITextureSource *tsrc,
 }
 
 void postProcessNodeMesh(scene::SMesh *mesh, const ContentFeatures &f,
-	bool use_shaders, bool set_material, const video::E_MATERIAL_TYPE *mattype,
+	bool set_material, const video::E_MATERIAL_TYPE *mattype,
 	std::vector<ItemPartColor> *colors, bool apply_scale)
 {
 	const u32 mc = mesh->getMeshBufferCount();
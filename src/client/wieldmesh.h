@@ -95,13 +95,10 @@ class WieldMeshSceneNode : public scene::ISceneNode
 	void setCube(const ContentFeatures &f, v3f wield_scale);
 	void setExtruded(const std::string &imagename, const std::string &overlay_image,
 			v3f wield_scale, ITextureSource *tsrc, u8 num_frames);
+	// Identical items share their mesh, see ExtrusionMeshCache
 	void setItem(const ItemStack &item, Client *client,
 			bool check_wield_image = true);
 
-	// Sets the vertex color of the wield mesh.
-	// Must only be used if the constructor was called with lighting = false
-	void setColor(video::SColor color);
-
 	void setNodeLightColor(video::SColor color);
 
 	scene::IMesh *getMesh() { return m_meshnode->getMesh(); }
@@ -111,13 +108,19 @@ class WieldMeshSceneNode : public scene::ISceneNode
 	virtual const aabb3f &getBoundingBox() const { return m_bounding_box; }
 
 private:
+	void createItemMesh(const ItemStack &item, Client *client,
+			bool check_wield_image);
+
+	// Sets the vertex color of the wield mesh.
+	// Must only be used while the mesh is not shared yet
+	void setColor(video::SColor color);
+
 	void changeToMesh(scene::IMesh *mesh);
 
 	// Child scene node with the current wield mesh
 	scene::IMeshSceneNode *m_meshnode = nullptr;
 	video::E_MATERIAL_TYPE m_material_type;
 
-	bool m_enable_shaders;
 	bool m_anisotropic_filter;
 	bool m_bilinear_filter;
 	bool m_trilinear_filter;
@@ -152,6 +155,6 @@ scene::SMesh *getExtrudedMesh(ITextureSource *tsrc, const std::string &imagename
  * be NULL to leave the original material.
  * \param colors returns the colors of the mesh buffers in the mesh.
  */
-void postProcessNodeMesh(scene::SMesh *mesh, const ContentFeatures &f, bool use_shaders,
+void postProcessNodeMesh(scene::SMesh *mesh, const ContentFeatures &f,
 		bool set_material, const video::E_MATERIAL_TYPE *mattype,
 		std::vector<ItemPartColor> *colors, bool apply_scale = false);
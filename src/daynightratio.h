@@ -4,7 +4,7 @@
 
 #pragma once
 
-inline u32 time_to_daynight_ratio(float time_of_day, bool smooth)
+inline u32 time_to_daynight_ratio(float time_of_day)
 {
 	float t = time_of_day;
 	if (t < 0.0f)
@@ -26,20 +26,6 @@ inline u32 time_to_daynight_ratio(float time_of_day, bool smooth)
 		{6250.0f + 125.0f, 1000.0f},
 	};
 
-	if (!smooth) {
-		float lastt = values[0][0];
-		for (u32 i = 1; i < 9; i++) {
-			float t0 = values[i][0];
-			float switch_t = (t0 + lastt) / 2.0f;
-			lastt = t0;
-			if (switch_t <= t)
-				continue;
-
-			return values[i][1];
-		}
-		return 1000;
-	}
-
 	if (t <= 4625.0f) // 4500 + 125
 		return values[0][1];
 	else if (t >= 6125.0f) // 6000 + 125
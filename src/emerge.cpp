@@ -56,11 +56,57 @@ EmergeParams::EmergeParams(EmergeManager *parent, const BiomeGen *biomegen,
 	this->biomegen = biomegen->clone(this->biomemgr);
 }
 
+////
+//// SpawnLevelCache
+////
+
+int SpawnLevelCache::get(Mapgen *mapgen, v2s16 p)
+{
+	v2s16 tile_pos, rel;
+	getContainerPosWithOffset(p, TILE_SIZE, tile_pos, rel);
+
+	MutexAutoLock lock(m_mutex);
+
+	auto it = m_tiles.find(tile_pos);
+	if (it == m_tiles.end()) {
+		if (m_tiles.size() >= m_max_tiles) {
+			m_tiles.erase(m_lru.back());
+			m_lru.pop_back();
+		}
+		it = m_tiles.emplace(tile_pos, Tile()).first;
+		std::fill_n(it->second.levels, TILE_SIZE * TILE_SIZE, UNKNOWN);
+		m_lru.push_front(tile_pos);
+	} else {
+		m_lru.splice(m_lru.begin(), m_lru, it->second.lru_it);
+	}
+	Tile &tile = it->second;
+	tile.lru_it = m_lru.begin();
+
+	int &level = tile.levels[rel.Y * TILE_SIZE + rel.X];
+	if (level == UNKNOWN)
+		level = mapgen->getSpawnLevelAtPoint(p);
+	return level;
+}
+
+void SpawnLevelCache::clear()
+{
+	MutexAutoLock lock(m_mutex);
+	m_tiles.clear();
+	m_lru.clear();
+}
+
+size_t SpawnLevelCache::getTileCount()
+{
+	MutexAutoLock lock(m_mutex);
+	return m_tiles.size();
+}
+
 ////
 //// EmergeManager
 ////
 
-EmergeManager::EmergeManager(Server *server, MetricsBackend *mb)
+EmergeManager::EmergeManager(Server *server, MetricsBackend *mb) :
+	m_spawn_level_cache(256)
 {
 	this->ndef      = server->getNodeDefManager();
 	this->biomemgr  = new BiomeManager(server);
@@ -338,7 +384,7 @@ int EmergeManager::getSpawnLevelAtPoint(v2s16 p)
 		return 0;
 	}
 
-	return m_mapgens[0]->getSpawnLevelAtPoint(p);
+	return m_spawn_level_cache.get(m_mapgens[0], p);
 }
 
 
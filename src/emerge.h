@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include <climits>
+#include <list>
 #include <map>
 #include <mutex>
+#include <unordered_map>
 #include "network/networkprotocol.h"
 #include "irr_v3d.h"
 #include "util/container.h"
@@ -114,6 +117,38 @@ class EmergeParams {
 		const SchematicManager *schemmgr);
 };
 
+/*
+	Caches the results of Mapgen::getSpawnLevelAtPoint() in tiles of
+	TILE_SIZE x TILE_SIZE columns. Only the most recently used tiles are kept.
+	Safe to use from multiple threads.
+*/
+class SpawnLevelCache {
+public:
+	static constexpr s16 TILE_SIZE = 16;
+
+	SpawnLevelCache(size_t max_tiles) : m_max_tiles(max_tiles) {}
+
+	int get(Mapgen *mapgen, v2s16 p);
+	void clear();
+
+	size_t getTileCount();
+
+private:
+	// Marks columns which have not been computed yet
+	static constexpr int UNKNOWN = INT_MIN;
+
+	struct Tile {
+		std::list<v2s16>::iterator lru_it;
+		int levels[TILE_SIZE * TILE_SIZE];
+	};
+
+	std::mutex m_mutex;
+	size_t m_max_tiles;
+	std::unordered_map<v2s16, Tile> m_tiles;
+	// Most recently used tile first
+	std::list<v2s16> m_lru;
+};
+
 class EmergeManager {
 	/* The mod API needs unchecked access to allow:
 	 * - using decomgr or oremgr to place decos/ores
@@ -211,6 +246,9 @@ class EmergeManager {
 	// Emerge metrics
 	MetricCounterPtr m_completed_emerge_counter[5];
 
+	// Spawn search and mods query the same columns over and over
+	SpawnLevelCache m_spawn_level_cache;
+
 	// Managers of various map generation-related components
 	// Note that each Mapgen gets a copy(!) of these to work with
 	BiomeGen *biomegen;
@@ -377,6 +377,8 @@ static void set_allowed_options(OptionList *allowed_options)
 			_("Enable ncurses interactive terminal" SERVER_ONLY))));
 	allowed_options->insert(std::make_pair("recompress", ValueSpec(VALUETYPE_FLAG,
 			_("Recompress the blocks of the given map database" SERVER_ONLY))));
+	allowed_options->insert(std::make_pair("profile-lua", ValueSpec(VALUETYPE_FLAG,
+			_("Sample the Lua code until shutdown and save the profile to the world" SERVER_ONLY))));
 #if CHECK_CLIENT_BUILD()
 	allowed_options->insert(std::make_pair("address", ValueSpec(VALUETYPE_STRING,
 			_("Address to connect to ('' = local game)"))));
@@ -1127,6 +1129,7 @@ static bool run_dedicated_server(const GameParams &game_params, const Settings &
 			// Create server
 			Server server(game_params.world_path, game_params.game_spec,
 					false, bind_addr, true, &iface);
+			server.setProfileLua(cmd_args.getFlag("profile-lua"));
 
 			g_term_console.setup(&iface, &kill, admin_nick);
 
@@ -1161,6 +1164,7 @@ static bool run_dedicated_server(const GameParams &game_params, const Settings &
 			// Create server
 			Server server(game_params.world_path, game_params.game_spec, false,
 				bind_addr, true);
+			server.setProfileLua(cmd_args.getFlag("profile-lua"));
 			server.start();
 
 			// Run server
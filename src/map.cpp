@@ -184,10 +184,17 @@ void Map::addNodeAndUpdate(v3s16 p, MapNode n,
 		n.setLight(LIGHTBANK_NIGHT, 0, f);
 		set_node_in_block(m_gamedef->ndef(), block, relpos, n);
 
-		// Update lighting
-		std::vector<std::pair<v3s16, MapNode> > oldnodes;
-		oldnodes.emplace_back(p, oldnode);
-		voxalgo::update_lighting_nodes(this, oldnodes, modified_blocks);
+		if (m_light_batch_depth > 0) {
+			// Only the state before the batch matters for unlighting
+			if (m_light_batch_positions.insert(p).second)
+				m_light_batch_nodes.emplace_back(p, oldnode);
+			modified_blocks[blockpos] = block;
+		} else {
+			// Update lighting
+			std::vector<std::pair<v3s16, MapNode> > oldnodes;
+			oldnodes.emplace_back(p, oldnode);
+			voxalgo::update_lighting_nodes(this, oldnodes, modified_blocks);
+		}
 	}
 
 	if (n.getContent() != oldnode.getContent() &&
@@ -255,6 +262,44 @@ bool Map::removeNodeWithEvent(v3s16 p)
 	return succeeded;
 }
 
+void Map::beginLightUpdateBatch()
+{
+	m_light_batch_depth++;
+}
+
+void Map::endLightUpdateBatch()
+{
+	assert(m_light_batch_depth > 0);
+	if (--m_light_batch_depth == 0)
+		flushLightUpdates();
+}
+
+void Map::flushLightUpdates()
+{
+	if (m_light_batch_nodes.empty())
+		return;
+
+	std::vector<std::pair<v3s16, MapNode>> oldnodes;
+	oldnodes.swap(m_light_batch_nodes);
+	m_light_batch_positions.clear();
+
+	std::map<v3s16, MapBlock*> modified_blocks;
+	voxalgo::update_lighting_nodes(this, oldnodes, modified_blocks);
+
+	for (auto &it : modified_blocks)
+		it.second->raiseModified(MOD_STATE_WRITE_NEEDED, MOD_REASON_SET_NODE);
+
+	// The events of the node changes only listed the blocks of the nodes
+	// themselves. Report the relit blocks too, so that clients which
+	// already have them receive the new light.
+	if (!modified_blocks.empty()) {
+		MapEditEvent event;
+		event.type = MEET_OTHER;
+		event.setModifiedBlocks(modified_blocks);
+		dispatchEvent(event);
+	}
+}
+
 struct TimeOrderedMapBlock {
 	MapSector *sect;
 	MapBlock *block;
@@ -759,6 +804,9 @@ void MMVManip::initialEmerge(v3s16 blockpos_min, v3s16 blockpos_max,
 
 	assert(m_map);
 
+	// Don't copy nodes with outdated light
+	m_map->flushLightUpdates();
+
 	// Units of these are MapBlocks
 	v3s16 p_min = blockpos_min;
 	v3s16 p_max = blockpos_max;
@@ -7,6 +7,8 @@
 #include <iostream>
 #include <set>
 #include <map>
+#include <unordered_set>
+#include <vector>
 
 #include "irrlichttypes_bloated.h"
 #include "mapblock.h"
@@ -159,6 +161,20 @@ class Map /*: public NodeContainer*/
 	bool addNodeWithEvent(v3s16 p, MapNode n, bool remove_metadata = true);
 	bool removeNodeWithEvent(v3s16 p);
 
+	/*
+		Light update batching.
+		Between beginLightUpdateBatch() and endLightUpdateBatch() the lighting
+		changes caused by addNodeAndUpdate() are only recorded. They are then
+		computed by a single voxalgo::update_lighting_nodes() call, which is a
+		lot cheaper than updating after every single node.
+		Batches may be nested; the updates are done when the outermost one ends.
+	*/
+	void beginLightUpdateBatch();
+	void endLightUpdateBatch();
+	// Computes the pending light updates right away.
+	// Needed before light values are read during a batch.
+	void flushLightUpdates();
+
 	// Call these before and after saving of many blocks
 	virtual void beginSave() {}
 	virtual void endSave() {}
@@ -288,6 +304,12 @@ class Map /*: public NodeContainer*/
 	// This stores the properties of the nodes on the map.
 	const NodeDefManager *m_nodedef;
 
+	// Nesting depth of light update batches
+	u32 m_light_batch_depth = 0;
+	// Nodes whose light update is pending, with their state before the batch
+	std::vector<std::pair<v3s16, MapNode>> m_light_batch_nodes;
+	std::unordered_set<v3s16> m_light_batch_positions;
+
 	// Can be implemented by child class
 	virtual void reportMetrics(u64 save_time_us, u32 saved_blocks, u32 all_blocks) {}
 
@@ -298,6 +320,18 @@ class Map /*: public NodeContainer*/
 		u32 needed_count);
 };
 
+// Batches light updates for the lifetime of the object
+class MapLightUpdateBatch
+{
+public:
+	MapLightUpdateBatch(Map *map) : m_map(map) { m_map->beginLightUpdateBatch(); }
+	~MapLightUpdateBatch() { m_map->endLightUpdateBatch(); }
+	DISABLE_CLASS_COPY(MapLightUpdateBatch);
+
+private:
+	Map *m_map;
+};
+
 #define VMANIP_BLOCK_DATA_INEXIST     1
 #define VMANIP_BLOCK_CONTAINS_CIGNORE 2
 
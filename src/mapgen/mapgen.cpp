@@ -429,13 +429,12 @@ void Mapgen::setLighting(u8 light, v3s16 nmin, v3s16 nmax)
 }
 
 
-void Mapgen::lightSpread(VoxelArea &a, std::queue<std::pair<v3s16, u8>> &queue,
-	const v3s16 &p, u8 light)
+void Mapgen::lightSpread(const VoxelArea &a, const v3s16 &p, u32 vi, u8 light,
+	u8 max_level)
 {
 	if (light <= 1 || !a.contains(p))
 		return;
 
-	u32 vi = vm->m_area.index(p);
 	MapNode &n = vm->m_data[vi];
 
 	// Decay light in each of the banks separately
@@ -454,15 +453,20 @@ void Mapgen::lightSpread(VoxelArea &a, std::queue<std::pair<v3s16, u8>> &queue,
 			!ndef->getLightingFlags(n).light_propagates)
 		return;
 
+	// Queue by the brightest bank that actually changed
+	u8 level = 0;
+	if (light_day > (n.param1 & 0x0F))
+		level = light_day;
+	if (light_night > (n.param1 & 0xF0))
+		level = MYMAX(level, light_night >> 4);
+
 	// MYMAX still needed here because we only exit early if both banks have
 	// nothing to propagate anymore.
-	light = MYMAX(light_day, n.param1 & 0x0F) |
+	n.param1 = MYMAX(light_day, n.param1 & 0x0F) |
 			MYMAX(light_night, n.param1 & 0xF0);
 
-	n.param1 = light;
-
-	// add to queue
-	queue.emplace(p, light);
+	if (level > 1)
+		m_light_queue[MYMIN(level, max_level)].push_back(p);
 }
 
 
@@ -481,15 +485,20 @@ void Mapgen::propagateSunlight(v3s16 nmin, v3s16 nmax, bool propagate_shadow)
 	//TimeTaker t("propagateSunlight");
 	VoxelArea a(nmin, nmax);
 	bool block_is_underground = (water_level >= nmax.Y);
-	const v3s16 &em = vm->m_area.getExtent();
 
 	// NOTE: Direct access to the low 4 bits of param1 is okay here because,
 	// by definition, sunlight will never be in the night lightbank.
 
+	// Columns are processed a whole X row at a time so that memory is walked
+	// linearly instead of striding down each column separately.
+	std::vector<s16> columns;
+	columns.reserve(a.getExtent().X);
+
 	for (int z = a.MinEdge.Z; z <= a.MaxEdge.Z; z++) {
-		for (int x = a.MinEdge.X; x <= a.MaxEdge.X; x++) {
-			// see if we can get a light value from the overtop
-			u32 i = vm->m_area.index(x, a.MaxEdge.Y + 1, z);
+		// see if we can get a light value from the overtop
+		columns.clear();
+		u32 i = vm->m_area.index(a.MinEdge.X, a.MaxEdge.Y + 1, z);
+		for (s16 x = 0; x < a.getExtent().X; x++, i++) {
 			if (vm->m_data[i].getContent() == CONTENT_IGNORE) {
 				if (block_is_underground)
 					continue;
@@ -497,15 +506,21 @@ void Mapgen::propagateSunlight(v3s16 nmin, v3s16 nmax, bool propagate_shadow)
 					propagate_shadow) {
 				continue;
 			}
-			VoxelArea::add_y(em, i, -1);
+			columns.push_back(x);
+		}
 
-			for (int y = a.MaxEdge.Y; y >= a.MinEdge.Y; y--) {
-				MapNode &n = vm->m_data[i];
+		for (int y = a.MaxEdge.Y; y >= a.MinEdge.Y && !columns.empty(); y--) {
+			MapNode *row = &vm->m_data[vm->m_area.index(a.MinEdge.X, y, z)];
+			// Drop columns whose sunlight got blocked
+			size_t n_active = 0;
+			for (s16 x : columns) {
+				MapNode &n = row[x];
 				if (!ndef->getLightingFlags(n).sunlight_propagates)
-					break;
+					continue;
 				n.param1 = LIGHT_SUN;
-				VoxelArea::add_y(em, i, -1);
+				columns[n_active++] = x;
 			}
+			columns.resize(n_active);
 		}
 	}
 	//printf("propagateSunlight: %dms\n", t.stop());
@@ -515,8 +530,14 @@ void Mapgen::propagateSunlight(v3s16 nmin, v3s16 nmax, bool propagate_shadow)
 void Mapgen::spreadLight(const v3s16 &nmin, const v3s16 &nmax)
 {
 	//TimeTaker t("spreadLight");
-	std::queue<std::pair<v3s16, u8>> queue;
 	VoxelArea a(nmin, nmax);
+	const v3s16 &em = vm->m_area.getExtent();
+
+	s32 dir_offsets[6];
+	for (size_t i = 0; i < 6; i++) {
+		const v3s16 &dir = g_6dirs[i];
+		dir_offsets[i] = dir.X + dir.Y * em.X + dir.Z * em.X * em.Y;
+	}
 
 	for (int z = a.MinEdge.Z; z <= a.MaxEdge.Z; z++) {
 		for (int y = a.MinEdge.Y; y <= a.MaxEdge.Y; y++) {
@@ -537,23 +558,26 @@ void Mapgen::spreadLight(const v3s16 &nmin, const v3s16 &nmax)
 				if (light_produced)
 					n.param1 = light_produced | (light_produced << 4);
 
-				u8 light = n.param1;
-				if (light) {
-					const v3s16 p(x, y, z);
-					// spread to all 6 neighbor nodes
-					for (const auto &dir : g_6dirs)
-						lightSpread(a, queue, p + dir, light);
-				}
+				u8 level = MYMAX(n.param1 & 0x0F, n.param1 >> 4);
+				if (level > 1)
+					m_light_queue[level].emplace_back(x, y, z);
 			}
 		}
 	}
 
-	while (!queue.empty()) {
-		const auto &i = queue.front();
-		// spread to all 6 neighbor nodes
-		for (const auto &dir : g_6dirs)
-			lightSpread(a, queue, i.first + dir, i.second);
-		queue.pop();
+	// Spread the brightest light first. Spreading only ever adds nodes to lower
+	// levels, so every node is usually visited just once.
+	for (u8 level = LIGHT_SUN; level > 1; level--) {
+		std::vector<v3s16> &queue = m_light_queue[level];
+		for (size_t i = 0; i < queue.size(); i++) {
+			const v3s16 p = queue[i];
+			u32 vi = vm->m_area.index(p);
+			u8 light = vm->m_data[vi].param1;
+			// spread to all 6 neighbor nodes
+			for (size_t d = 0; d < 6; d++)
+				lightSpread(a, p + g_6dirs[d], vi + dir_offsets[d], light, level);
+		}
+		queue.clear();
 	}
 
 	//printf("spreadLight: %lums\n", t.stop());
@@ -250,13 +250,17 @@ class Mapgen {
 	 * Spread light to the node at the given position, add to queue if changed.
 	 * The given light value is diminished once.
 	 * @param a VoxelArea being operated on
-	 * @param queue Queue for later lightSpread() calls
 	 * @param p Node position
+	 * @param vi Index of p in vm
 	 * @param light Light value (contains both banks)
-	 *
+	 * @param max_level Highest light queue the node may be added to
 	 */
-	void lightSpread(VoxelArea &a, std::queue<std::pair<v3s16, u8>> &queue,
-		const v3s16 &p, u8 light);
+	void lightSpread(const VoxelArea &a, const v3s16 &p, u32 vi, u8 light,
+		u8 max_level);
+
+	// Nodes for spreadLight() to spread light from, by light level of the bank
+	// that changed. Kept between calls to avoid reallocations.
+	std::vector<v3s16> m_light_queue[LIGHT_SUN + 1];
 
 	// isLiquidHorizontallyFlowable() is a helper function for updateLiquid()
 	// that checks whether there are floodable nodes without liquid beneath
@@ -147,6 +147,8 @@ BiomeGenOriginal::BiomeGenOriginal(BiomeManager *biomemgr,
 	values.erase(std::unique(values.begin(), values.end()), values.end());
 
 	m_transitions_y = std::move(values);
+
+	buildYRanges();
 }
 
 BiomeGenOriginal::~BiomeGenOriginal()
@@ -166,6 +168,62 @@ s16 BiomeGenOriginal::getNextTransitionY(s16 y) const
 	return (it == m_transitions_y.end()) ? S16_MIN : *it;
 }
 
+void BiomeGenOriginal::buildYRanges()
+{
+	// Collect every Y coordinate at which a biome starts or stops being
+	// applicable, or enters or leaves its vertical blend area.
+	std::vector<s32> bounds;
+	for (size_t i = 1; i < m_bmgr->getNumObjects(); i++) {
+		Biome *b = (Biome *)m_bmgr->getRaw(i);
+		if (!b)
+			continue;
+		bounds.push_back(b->min_pos.Y);
+		bounds.push_back((s32)b->max_pos.Y + 1);
+		bounds.push_back((s32)b->max_pos.Y + b->vertical_blend + 1);
+	}
+	bounds.push_back(S32_MIN);
+
+	std::sort(bounds.begin(), bounds.end());
+	bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+	m_y_range_min = std::move(bounds);
+	m_y_ranges.clear();
+	m_y_ranges.resize(m_y_range_min.size());
+
+	for (size_t r = 0; r < m_y_range_min.size(); r++) {
+		// All Y values within the range behave identically, so test the first
+		const s32 y = m_y_range_min[r];
+		BiomeYRange &range = m_y_ranges[r];
+
+		for (size_t i = 1; i < m_bmgr->getNumObjects(); i++) {
+			Biome *b = (Biome *)m_bmgr->getRaw(i);
+			if (!b || y < b->min_pos.Y || y > b->max_pos.Y + b->vertical_blend)
+				continue;
+
+			BiomeCandidate c;
+			c.heat_point     = b->heat_point;
+			c.humidity_point = b->humidity_point;
+			c.min_x          = b->min_pos.X;
+			c.max_x          = b->max_pos.X;
+			c.min_z          = b->min_pos.Z;
+			c.max_z          = b->max_pos.Z;
+			c.biome          = b;
+
+			if (y <= b->max_pos.Y)
+				range.biomes.push_back(c);
+			else
+				range.biomes_blend.push_back(c);
+		}
+
+		auto by_heat = [] (const BiomeCandidate &a, const BiomeCandidate &b) {
+			return a.heat_point < b.heat_point;
+		};
+		// stable, so equal heat points keep the registration order
+		std::stable_sort(range.biomes.begin(), range.biomes.end(), by_heat);
+		std::stable_sort(range.biomes_blend.begin(), range.biomes_blend.end(), by_heat);
+	}
+}
+
 BiomeGen *BiomeGenOriginal::clone(BiomeManager *biomemgr) const
 {
 	return new BiomeGenOriginal(biomemgr, m_params, m_csize);
@@ -239,36 +297,65 @@ Biome *BiomeGenOriginal::getBiomeAtIndex(size_t index, v3s16 pos) const
 }
 
 
-Biome *BiomeGenOriginal::calcBiomeFromNoise(float heat, float humidity, v3s16 pos) const
+// Finds the candidate closest to (heat, humidity) that contains pos
+// horizontally. Ties are resolved in favour of the biome registered first, so
+// the result is identical to a linear scan over all biomes.
+Biome *BiomeGenOriginal::findClosest(const std::vector<BiomeCandidate> &candidates,
+	float heat, float humidity, v3s16 pos, float *dist_min)
 {
-	Biome *biome_closest = nullptr;
-	Biome *biome_closest_blend = nullptr;
-	float dist_min = FLT_MAX;
-	float dist_min_blend = FLT_MAX;
-
-	for (size_t i = 1; i < m_bmgr->getNumObjects(); i++) {
-		Biome *b = (Biome *)m_bmgr->getRaw(i);
-		if (!b ||
-				pos.Y < b->min_pos.Y || pos.Y > b->max_pos.Y + b->vertical_blend ||
-				pos.X < b->min_pos.X || pos.X > b->max_pos.X ||
-				pos.Z < b->min_pos.Z || pos.Z > b->max_pos.Z)
+	Biome *closest = nullptr;
+	*dist_min = FLT_MAX;
+
+	// Sweep outwards from the query heat, always visiting the candidate with
+	// the smaller heat difference next. Once the heat difference alone exceeds
+	// the best distance found, no remaining candidate can be closer.
+	size_t hi = std::lower_bound(candidates.begin(), candidates.end(), heat,
+		[] (const BiomeCandidate &c, float v) { return c.heat_point < v; })
+		- candidates.begin();
+	size_t lo = hi;
+
+	while (lo > 0 || hi < candidates.size()) {
+		const BiomeCandidate *c;
+		if (hi == candidates.size() || (lo > 0 &&
+				heat - candidates[lo - 1].heat_point < candidates[hi].heat_point - heat))
+			c = &candidates[--lo];
+		else
+			c = &candidates[hi++];
+
+		float d_heat = heat - c->heat_point;
+		if (d_heat * d_heat > *dist_min)
+			break;
+
+		if (pos.X < c->min_x || pos.X > c->max_x ||
+				pos.Z < c->min_z || pos.Z > c->max_z)
 			continue;
 
-		float d_heat = heat - b->heat_point;
-		float d_humidity = humidity - b->humidity_point;
+		float d_humidity = humidity - c->humidity_point;
 		float dist = (d_heat * d_heat) + (d_humidity * d_humidity);
 
-		if (pos.Y <= b->max_pos.Y) { // Within y limits of biome b
-			if (dist < dist_min) {
-				dist_min = dist;
-				biome_closest = b;
-			}
-		} else if (dist < dist_min_blend) { // Blend area above biome b
-			dist_min_blend = dist;
-			biome_closest_blend = b;
+		if (dist < *dist_min || (closest && dist == *dist_min &&
+				c->biome->index < closest->index)) {
+			*dist_min = dist;
+			closest = c->biome;
 		}
 	}
 
+	return closest;
+}
+
+
+Biome *BiomeGenOriginal::calcBiomeFromNoise(float heat, float humidity, v3s16 pos) const
+{
+	size_t r = std::upper_bound(m_y_range_min.begin(), m_y_range_min.end(),
+		(s32)pos.Y) - m_y_range_min.begin() - 1;
+	const BiomeYRange &range = m_y_ranges[r];
+
+	float dist_min, dist_min_blend;
+	Biome *biome_closest = findClosest(range.biomes,
+		heat, humidity, pos, &dist_min);
+	Biome *biome_closest_blend = findClosest(range.biomes_blend,
+		heat, humidity, pos, &dist_min_blend);
+
 	// Carefully tune pseudorandom seed variation to avoid single node dither
 	// and create larger scale blending patterns similar to horizontal biome
 	// blend.
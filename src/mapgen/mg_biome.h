@@ -192,6 +192,33 @@ class BiomeGenOriginal final : public BiomeGen {
 
 	// ordered descending
 	std::vector<s16> m_transitions_y;
+
+	// Biome lookup acceleration structure, built once from the (finalized)
+	// BiomeManager. The Y axis is split into ranges within which the set of
+	// applicable biomes does not change; each range keeps its candidates
+	// sorted by heat point so the closest one can be found without a full scan.
+	struct BiomeCandidate {
+		float heat_point;
+		float humidity_point;
+		s16 min_x, max_x;
+		s16 min_z, max_z;
+		Biome *biome;
+	};
+
+	struct BiomeYRange {
+		// Biomes whose Y limits contain the range
+		std::vector<BiomeCandidate> biomes;
+		// Biomes for which the range lies within the vertical blend area
+		std::vector<BiomeCandidate> biomes_blend;
+	};
+
+	void buildYRanges();
+	static Biome *findClosest(const std::vector<BiomeCandidate> &candidates,
+		float heat, float humidity, v3s16 pos, float *dist_min);
+
+	// ordered ascending, first element is S32_MIN
+	std::vector<s32> m_y_range_min;
+	std::vector<BiomeYRange> m_y_ranges;
 };
 
 
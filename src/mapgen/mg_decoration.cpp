@@ -41,12 +41,14 @@ size_t DecorationManager::placeAllDecos(Mapgen *mg, u32 blockseed,
 {
 	size_t nplaced = 0;
 
+	m_surface_cache.reset(nmin, nmax);
+
 	for (size_t i = 0; i != m_objects.size(); i++) {
 		Decoration *deco = (Decoration *)m_objects[i];
 		if (!deco)
 			continue;
 
-		nplaced += deco->placeDeco(mg, blockseed, nmin, nmax);
+		nplaced += deco->placeDeco(mg, blockseed, nmin, nmax, &m_surface_cache);
 		blockseed++;
 	}
 
@@ -64,6 +66,79 @@ DecorationManager *DecorationManager::clone() const
 ///////////////////////////////////////////////////////////////////////////////
 
 
+void DecoSurfaceCache::reset(v3s16 nmin, v3s16 nmax)
+{
+	m_nmin = nmin;
+	m_nmax = nmax;
+
+	size_t ncolumns = (nmax.X - nmin.X + 1) * (nmax.Z - nmin.Z + 1);
+	if (m_columns.size() != ncolumns)
+		m_columns.assign(ncolumns, Column());
+
+	invalidateAll();
+	m_surfaces.clear();
+}
+
+
+void DecoSurfaceCache::invalidateAll()
+{
+	if (++m_generation == 0) {
+		// Counter wrapped around, stale columns could appear valid again
+		m_columns.assign(m_columns.size(), Column());
+		m_generation = 1;
+	}
+}
+
+
+void DecoSurfaceCache::getSurfaces(Mapgen *mg, v2s16 p2d,
+	const s16 **floors, size_t *num_floors,
+	const s16 **ceilings, size_t *num_ceilings)
+{
+	Column &col = m_columns[(p2d.Y - m_nmin.Z) * (m_nmax.X - m_nmin.X + 1) +
+		(p2d.X - m_nmin.X)];
+
+	if (col.generation != m_generation) {
+		m_floors_tmp.clear();
+		m_ceilings_tmp.clear();
+		mg->getSurfaces(p2d, m_nmin.Y, m_nmax.Y, m_floors_tmp, m_ceilings_tmp);
+
+		col.generation   = m_generation;
+		col.offset       = m_surfaces.size();
+		col.num_floors   = m_floors_tmp.size();
+		col.num_ceilings = m_ceilings_tmp.size();
+		m_surfaces.insert(m_surfaces.end(), m_floors_tmp.begin(), m_floors_tmp.end());
+		m_surfaces.insert(m_surfaces.end(), m_ceilings_tmp.begin(), m_ceilings_tmp.end());
+	}
+
+	*floors       = m_surfaces.data() + col.offset;
+	*num_floors   = col.num_floors;
+	*ceilings     = *floors + col.num_floors;
+	*num_ceilings = col.num_ceilings;
+}
+
+
+void DecoSurfaceCache::invalidate(v2s16 p2d, s16 radius)
+{
+	if (radius < 0) {
+		invalidateAll();
+		return;
+	}
+
+	s16 x_min = MYMAX(p2d.X - radius, m_nmin.X);
+	s16 x_max = MYMIN(p2d.X + radius, m_nmax.X);
+	s16 z_min = MYMAX(p2d.Y - radius, m_nmin.Z);
+	s16 z_max = MYMIN(p2d.Y + radius, m_nmax.Z);
+	s16 xsize = m_nmax.X - m_nmin.X + 1;
+
+	for (s16 z = z_min; z <= z_max; z++)
+	for (s16 x = x_min; x <= x_max; x++)
+		m_columns[(z - m_nmin.Z) * xsize + (x - m_nmin.X)].generation = 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+
 void Decoration::resolveNodeNames()
 {
 	getIdsFromNrBacklog(&c_place_on);
@@ -128,8 +203,11 @@ bool Decoration::canPlaceDecoration(MMVManip *vm, v3s16 p)
 }
 
 
-size_t Decoration::placeDeco(Mapgen *mg, u32 blockseed, v3s16 nmin, v3s16 nmax)
+size_t Decoration::placeDeco(Mapgen *mg, u32 blockseed, v3s16 nmin, v3s16 nmax,
+	DecoSurfaceCache *surfaces)
 {
+	const s16 radius = getPlacementRadius();
+
 	PcgRandom ps(blockseed + 53);
 	int carea_size = nmax.X - nmin.X + 1;
 
@@ -206,35 +284,36 @@ size_t Decoration::placeDeco(Mapgen *mg, u32 blockseed, v3s16 nmin, v3s16 nmax)
 				}
 
 				// Get all floors and ceilings in node column
-				u16 size = (nmax.Y - nmin.Y + 1) / 2;
-				std::vector<s16> floors;
-				std::vector<s16> ceilings;
-				floors.reserve(size);
-				ceilings.reserve(size);
-
-				mg->getSurfaces(v2s16(x, z), nmin.Y, nmax.Y, floors, ceilings);
+				const s16 *floors, *ceilings;
+				size_t num_floors, num_ceilings;
+				surfaces->getSurfaces(mg, v2s16(x, z),
+					&floors, &num_floors, &ceilings, &num_ceilings);
 
 				if (flags & DECO_ALL_FLOORS) {
 					// Floor decorations
-					for (const s16 y : floors) {
+					for (size_t fi = 0; fi < num_floors; fi++) {
+						s16 y = floors[fi];
 						if (y < y_min || y > y_max)
 							continue;
 
 						v3s16 pos(x, y, z);
 						if (generate(mg->vm, &ps, pos, false))
 							mg->gennotify.addDecorationEvent(pos, index);
+						surfaces->invalidate(v2s16(x, z), radius);
 					}
 				}
 
 				if (flags & DECO_ALL_CEILINGS) {
 					// Ceiling decorations
-					for (const s16 y : ceilings) {
+					for (size_t ci = 0; ci < num_ceilings; ci++) {
+						s16 y = ceilings[ci];
 						if (y < y_min || y > y_max)
 							continue;
 
 						v3s16 pos(x, y, z);
 						if (generate(mg->vm, &ps, pos, true))
 							mg->gennotify.addDecorationEvent(pos, index);
+						surfaces->invalidate(v2s16(x, z), radius);
 					}
 				}
 			} else { // Heightmap decorations
@@ -258,6 +337,7 @@ size_t Decoration::placeDeco(Mapgen *mg, u32 blockseed, v3s16 nmin, v3s16 nmax)
 				v3s16 pos(x, y, z);
 				if (generate(mg->vm, &ps, pos, false))
 					mg->gennotify.addDecorationEvent(pos, index);
+				surfaces->invalidate(v2s16(x, z), radius);
 			}
 		}
 	}
@@ -407,6 +487,16 @@ ObjDef *DecoSchematic::clone() const
 }
 
 
+s16 DecoSchematic::getPlacementRadius() const
+{
+	if (schematic == NULL)
+		return 0;
+
+	// Covers every rotation and centering of the schematic
+	return MYMAX(schematic->size.X, schematic->size.Z);
+}
+
+
 size_t DecoSchematic::generate(MMVManip *vm, PcgRandom *pr, v3s16 p, bool ceiling)
 {
 	// Schematic could have been unloaded but not the decoration
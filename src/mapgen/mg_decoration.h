@@ -36,6 +36,46 @@ enum DecorationType {
 extern FlagDesc flagdesc_deco[];
 
 
+// Floor and ceiling positions of the node columns of a chunk, shared by all
+// decorations placed in one DecorationManager::placeAllDecos() call.
+// Columns have to be invalidated whenever a decoration may have modified them.
+class DecoSurfaceCache {
+public:
+	void reset(v3s16 nmin, v3s16 nmax);
+
+	// Returns the floors and ceilings of the column at p2d, in descending
+	// order, as would be found by Mapgen::getSurfaces().
+	// The pointers stay valid until the next call.
+	void getSurfaces(Mapgen *mg, v2s16 p2d,
+		const s16 **floors, size_t *num_floors,
+		const s16 **ceilings, size_t *num_ceilings);
+
+	// Invalidates all columns within radius of p2d, or every column if
+	// radius is negative
+	void invalidate(v2s16 p2d, s16 radius);
+
+private:
+	void invalidateAll();
+
+	struct Column {
+		u32 generation = 0;
+		u32 offset = 0;
+		u16 num_floors = 0;
+		u16 num_ceilings = 0;
+	};
+
+	v3s16 m_nmin;
+	v3s16 m_nmax;
+	// A column is valid if its generation matches this one.
+	// Generation 0 is never valid.
+	u32 m_generation = 0;
+	std::vector<Column> m_columns;
+	std::vector<s16> m_surfaces;
+	std::vector<s16> m_floors_tmp;
+	std::vector<s16> m_ceilings_tmp;
+};
+
+
 class Decoration : public ObjDef, public NodeResolver {
 public:
 	Decoration() = default;
@@ -44,10 +84,15 @@ class Decoration : public ObjDef, public NodeResolver {
 	virtual void resolveNodeNames();
 
 	bool canPlaceDecoration(MMVManip *vm, v3s16 p);
-	size_t placeDeco(Mapgen *mg, u32 blockseed, v3s16 nmin, v3s16 nmax);
+	size_t placeDeco(Mapgen *mg, u32 blockseed, v3s16 nmin, v3s16 nmax,
+		DecoSurfaceCache *surfaces);
 
 	virtual size_t generate(MMVManip *vm, PcgRandom *pr, v3s16 p, bool ceiling) = 0;
 
+	// Horizontal distance from the position passed to generate() within which
+	// nodes may be modified, or -1 if unknown
+	virtual s16 getPlacementRadius() const = 0;
+
 	u32 flags = 0;
 	int mapseed = 0;
 	std::vector<content_t> c_place_on;
@@ -74,6 +119,7 @@ class DecoSimple : public Decoration {
 
 	virtual void resolveNodeNames();
 	virtual size_t generate(MMVManip *vm, PcgRandom *pr, v3s16 p, bool ceiling);
+	virtual s16 getPlacementRadius() const { return 0; }
 
 	std::vector<content_t> c_decos;
 	s16 deco_height;
@@ -91,6 +137,7 @@ class DecoSchematic : public Decoration {
 	virtual ~DecoSchematic();
 
 	virtual size_t generate(MMVManip *vm, PcgRandom *pr, v3s16 p, bool ceiling);
+	virtual s16 getPlacementRadius() const;
 
 	Rotation rotation;
 	Schematic *schematic = nullptr;
@@ -103,6 +150,7 @@ class DecoLSystem : public Decoration {
 	ObjDef *clone() const;
 
 	virtual size_t generate(MMVManip *vm, PcgRandom *pr, v3s16 p, bool ceiling);
+	virtual s16 getPlacementRadius() const { return -1; }
 
 	// In case it gets cloned it uses the same tree def.
 	std::shared_ptr<treegen::TreeDef> tree_def;
@@ -139,4 +187,6 @@ class DecorationManager : public ObjDefManager {
 
 private:
 	DecorationManager() {};
+
+	DecoSurfaceCache m_surface_cache;
 };
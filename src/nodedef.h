@@ -173,6 +173,7 @@ class TextureSettings {
 	bool connected_glass;
 	bool enable_mesh_cache;
 	bool enable_minimap;
+	bool enable_lod_meshes;
 
 	TextureSettings() = default;
 
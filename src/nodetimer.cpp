@@ -45,10 +45,10 @@ void NodeTimerList::serialize(std::ostream &os, u8 map_format_version) const
 		writeU16(os, m_timers.size());
 	}
 
-	for (const auto &timer : m_timers) {
-		NodeTimer t = timer.second;
+	for (const Entry &entry : m_timers) {
+		const NodeTimer &t = entry.timer;
 		NodeTimer nt = NodeTimer(t.timeout,
-			t.timeout - (f32)(timer.first - m_time), t.position);
+			t.timeout - (f32)(entry.trigger_time - m_time), t.position);
 		v3s16 p = t.position;
 
 		u16 p16 = p.Z * MAP_BLOCKSIZE * MAP_BLOCKSIZE + p.Y * MAP_BLOCKSIZE + p.X;
@@ -98,7 +98,7 @@ void NodeTimerList::deSerialize(std::istream &is, u8 map_format_version)
 			continue;
 		}
 
-		if (m_iterators.find(p) != m_iterators.end()) {
+		if (m_indices.find(p) != m_indices.end()) {
 			warningstream<<"NodeTimerList::deSerialize(): "
 					<<"already set data at position"
 					<<"("<<p.X<<","<<p.Y<<","<<p.Z<<"): Ignoring."
@@ -110,26 +110,113 @@ void NodeTimerList::deSerialize(std::istream &is, u8 map_format_version)
 	}
 }
 
+NodeTimer NodeTimerList::get(const v3s16 &p) const
+{
+	auto it = m_indices.find(p);
+	if (it == m_indices.end())
+		return NodeTimer();
+	const Entry &entry = m_timers[it->second];
+	NodeTimer t = entry.timer;
+	t.elapsed = t.timeout - (entry.trigger_time - m_time);
+	return t;
+}
+
+void NodeTimerList::remove(v3s16 p)
+{
+	auto it = m_indices.find(p);
+	if (it != m_indices.end())
+		removeAt(it->second);
+}
+
+void NodeTimerList::insert(const NodeTimer &timer)
+{
+	double trigger_time = m_time + (double)(timer.timeout - timer.elapsed);
+	m_indices[timer.position] = m_timers.size();
+	m_timers.push_back({trigger_time, m_next_seq++, timer});
+	siftUp(m_timers.size() - 1);
+}
+
+void NodeTimerList::set(const NodeTimer &timer)
+{
+	auto it = m_indices.find(timer.position);
+	if (it == m_indices.end()) {
+		insert(timer);
+		return;
+	}
+
+	// Replace the entry in place, it only needs to move up or down
+	u32 i = it->second;
+	m_timers[i].trigger_time = m_time + (double)(timer.timeout - timer.elapsed);
+	m_timers[i].seq = m_next_seq++;
+	m_timers[i].timer = timer;
+	if (siftUp(i) == i)
+		siftDown(i);
+}
+
+void NodeTimerList::place(u32 i, Entry &&entry)
+{
+	m_indices[entry.timer.position] = i;
+	m_timers[i] = std::move(entry);
+}
+
+u32 NodeTimerList::siftUp(u32 i)
+{
+	Entry entry = std::move(m_timers[i]);
+	while (i > 0) {
+		u32 parent = (i - 1) / 2;
+		if (!(entry < m_timers[parent]))
+			break;
+		place(i, std::move(m_timers[parent]));
+		i = parent;
+	}
+	place(i, std::move(entry));
+	return i;
+}
+
+void NodeTimerList::siftDown(u32 i)
+{
+	const u32 count = m_timers.size();
+	Entry entry = std::move(m_timers[i]);
+	while (true) {
+		u32 child = 2 * i + 1;
+		if (child >= count)
+			break;
+		if (child + 1 < count && m_timers[child + 1] < m_timers[child])
+			child++;
+		if (!(m_timers[child] < entry))
+			break;
+		place(i, std::move(m_timers[child]));
+		i = child;
+	}
+	place(i, std::move(entry));
+}
+
+void NodeTimerList::removeAt(u32 i)
+{
+	m_indices.erase(m_timers[i].timer.position);
+
+	const u32 last = m_timers.size() - 1;
+	if (i != last) {
+		m_timers[i] = std::move(m_timers[last]);
+		m_timers.pop_back();
+		if (siftUp(i) == i)
+			siftDown(i);
+	} else {
+		m_timers.pop_back();
+	}
+}
+
 std::vector<NodeTimer> NodeTimerList::step(float dtime)
 {
 	std::vector<NodeTimer> elapsed_timers;
 	m_time += dtime;
-	if (m_next_trigger_time == -1. || m_time < m_next_trigger_time) {
-		return elapsed_timers;
-	}
-	std::multimap<double, NodeTimer>::iterator i = m_timers.begin();
-	// Process timers
-	for (; i != m_timers.end() && i->first <= m_time; ++i) {
-		NodeTimer t = i->second;
-		t.elapsed = t.timeout + (f32)(m_time - i->first);
+	// Process timers, in order of their trigger time
+	while (!m_timers.empty() && m_timers[0].trigger_time <= m_time) {
+		const Entry &entry = m_timers[0];
+		NodeTimer t = entry.timer;
+		t.elapsed = t.timeout + (f32)(m_time - entry.trigger_time);
 		elapsed_timers.push_back(t);
-		m_iterators.erase(t.position);
+		removeAt(0);
 	}
-	// Delete elapsed timers
-	m_timers.erase(m_timers.begin(), i);
-	if (m_timers.empty())
-		m_next_trigger_time = -1.;
-	else
-		m_next_trigger_time = m_timers.begin()->first;
 	return elapsed_timers;
 }
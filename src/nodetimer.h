@@ -6,7 +6,7 @@
 
 #include "irr_v3d.h"
 #include <iostream>
-#include <map>
+#include <unordered_map>
 #include <vector>
 
 /*
@@ -37,6 +37,11 @@ class NodeTimer
 
 /*
 	List of timers of all the nodes of a block
+
+	The timers are kept in a binary heap ordered by their trigger time, so
+	that a step only touches the elapsed timers and setting or removing a
+	timer does not allocate once the storage has grown. Timers with the same
+	trigger time elapse in the order they were set.
 */
 
 class NodeTimerList
@@ -49,61 +54,50 @@ class NodeTimerList
 	void deSerialize(std::istream &is, u8 map_format_version);
 
 	// Get timer
-	NodeTimer get(const v3s16 &p) {
-		std::map<v3s16, std::multimap<double, NodeTimer>::iterator>::iterator n =
-			m_iterators.find(p);
-		if (n == m_iterators.end())
-			return NodeTimer();
-		NodeTimer t = n->second->second;
-		t.elapsed = t.timeout - (n->second->first - m_time);
-		return t;
-	}
+	NodeTimer get(const v3s16 &p) const;
 	// Deletes timer
-	void remove(v3s16 p) {
-		std::map<v3s16, std::multimap<double, NodeTimer>::iterator>::iterator n =
-			m_iterators.find(p);
-		if(n != m_iterators.end()) {
-			double removed_time = n->second->first;
-			m_timers.erase(n->second);
-			m_iterators.erase(n);
-			// Yes, this is float equality, but it is not a problem
-			// since we only test equality of floats as an ordered type
-			// and thus we never lose precision
-			if (removed_time == m_next_trigger_time) {
-				if (m_timers.empty())
-					m_next_trigger_time = -1.;
-				else
-					m_next_trigger_time = m_timers.begin()->first;
-			}
-		}
-	}
+	void remove(v3s16 p);
 	// Undefined behavior if there already is a timer
-	void insert(const NodeTimer &timer) {
-		v3s16 p = timer.position;
-		double trigger_time = m_time + (double)(timer.timeout - timer.elapsed);
-		std::multimap<double, NodeTimer>::iterator it = m_timers.emplace(trigger_time, timer);
-		m_iterators.emplace(p, it);
-		if (m_next_trigger_time == -1. || trigger_time < m_next_trigger_time)
-			m_next_trigger_time = trigger_time;
-	}
+	void insert(const NodeTimer &timer);
 	// Deletes old timer and sets a new one
-	inline void set(const NodeTimer &timer) {
-		remove(timer.position);
-		insert(timer);
-	}
+	void set(const NodeTimer &timer);
 	// Deletes all timers
-	void clear() {
+	void clear()
+	{
 		m_timers.clear();
-		m_iterators.clear();
-		m_next_trigger_time = -1.;
+		m_indices.clear();
+		m_next_seq = 0;
 	}
 
+	size_t size() const { return m_timers.size(); }
+
 	// Move forward in time, returns elapsed timers
 	std::vector<NodeTimer> step(float dtime);
 
 private:
-	std::multimap<double, NodeTimer> m_timers;
-	std::map<v3s16, std::multimap<double, NodeTimer>::iterator> m_iterators;
-	double m_next_trigger_time = -1.0;
+	struct Entry {
+		double trigger_time;
+		// Breaks ties between equal trigger times
+		u64 seq;
+		NodeTimer timer;
+
+		bool operator<(const Entry &other) const
+		{
+			return trigger_time < other.trigger_time ||
+				(trigger_time == other.trigger_time && seq < other.seq);
+		}
+	};
+
+	// Stores the entry at heap index i and updates its index
+	void place(u32 i, Entry &&entry);
+	// Move the entry at i to its place in the heap, returns the new index
+	u32 siftUp(u32 i);
+	void siftDown(u32 i);
+	void removeAt(u32 i);
+
+	std::vector<Entry> m_timers;
+	// Heap index of the timer at every position
+	std::unordered_map<v3s16, u32> m_indices;
 	double m_time = 0.0;
+	u64 m_next_seq = 0;
 };
@@ -2218,14 +2218,11 @@ void push_objectRef(lua_State *L, const u16 id)
 {
 	assert(id != 0);
 	// Get core.object_refs[i]
-	lua_getglobal(L, "core");
-	lua_getfield(L, -1, "object_refs");
+	lua_rawgeti(L, LUA_REGISTRYINDEX, CUSTOM_RIDX_OBJECT_REFS);
 	luaL_checktype(L, -1, LUA_TTABLE);
-	lua_pushinteger(L, id);
-	lua_gettable(L, -2);
+	lua_rawgeti(L, -1, id);
 	assert(!lua_isnoneornil(L, -1));
 	lua_remove(L, -2); // object_refs
-	lua_remove(L, -2); // core
 }
 
 void read_hud_element(lua_State *L, HudElement *elem)
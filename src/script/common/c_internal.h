@@ -44,6 +44,8 @@ enum {
 	CUSTOM_RIDX_ERROR_HANDLER,
 	CUSTOM_RIDX_HTTP_API_LUA,
 	CUSTOM_RIDX_METATABLE_MAP,
+	// core.object_refs, looked up on every push of an ObjectRef
+	CUSTOM_RIDX_OBJECT_REFS,
 
 	// The following functions are implemented in Lua because LuaJIT can
 	// trace them and optimize tables/string better than from the C API.
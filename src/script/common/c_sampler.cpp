@@ -0,0 +1,319 @@
+// Luanti
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (C) 2024 Luanti Authors
+
+#include "c_sampler.h"
+#include <algorithm>
+#include <json/json.h>
+#include "convert_json.h"
+#include "porting.h"
+
+extern "C" {
+#if USE_LUAJIT
+	#include "luajit.h"
+#endif
+}
+
+LuaSampler *LuaSampler::s_running = nullptr;
+
+LuaSampler::LuaSampler(size_t max_samples) :
+	m_max_samples(std::max<size_t>(max_samples, 1))
+{
+}
+
+LuaSampler::~LuaSampler()
+{
+	stop();
+}
+
+bool LuaSampler::start(lua_State *L, u32 interval_us)
+{
+	if (s_running)
+		return false;
+
+	s_running = this;
+	m_L = L;
+	m_interval_us = std::max<u32>(interval_us, 1);
+	m_last_sample_us = porting::getTimeUs();
+
+#if USE_LUAJIT
+	// LuaJIT samples in whole milliseconds
+	std::string mode = "fi" + std::to_string(std::max<u32>(m_interval_us / 1000, 1));
+	luaJIT_profile_start(L, mode.c_str(), profileCallback, this);
+#else
+	// Check the time every few instructions, checking it on every call would
+	// slow down small functions a lot more than large ones.
+	lua_sethook(L, hook, LUA_MASKCOUNT, 1000);
+#endif
+	return true;
+}
+
+void LuaSampler::stop()
+{
+	if (!m_L)
+		return;
+
+#if USE_LUAJIT
+	luaJIT_profile_stop(m_L);
+#else
+	lua_sethook(m_L, nullptr, 0, 0);
+#endif
+	m_L = nullptr;
+	s_running = nullptr;
+}
+
+void LuaSampler::clear()
+{
+	m_samples.clear();
+	m_oldest_sample = 0;
+	m_stacks.clear();
+	m_stack_ids.clear();
+	m_frame_names.clear();
+	m_frame_ids.clear();
+}
+
+void LuaSampler::enterCallback()
+{
+#if !USE_LUAJIT
+	// The hook only notices the time passing while Lua code runs, so the time
+	// spent in the engine since the last callback must not count as sampled.
+	lua_Debug ar;
+	if (m_L && !lua_getstack(m_L, 0, &ar))
+		m_last_sample_us = porting::getTimeUs();
+#endif
+}
+
+#if USE_LUAJIT
+
+void LuaSampler::profileCallback(void *data, lua_State *L, int samples, int vmstate)
+{
+	auto *self = static_cast<LuaSampler *>(data);
+
+	// A negative depth dumps the root frame first
+	size_t len;
+	const char *stack = luaJIT_profile_dumpstack(L, "pFZ;", -MAX_DEPTH, &len);
+
+	self->m_frames.clear();
+	const char *end = stack + len;
+	while (stack < end) {
+		const char *sep = std::find(stack, end, ';');
+		self->m_frames.push_back(self->internFrame(std::string(stack, sep)));
+		stack = sep + 1;
+	}
+	if (vmstate == 'G')
+		self->m_frames.push_back(self->internFrame("[GC]"));
+	else if (vmstate == 'J')
+		self->m_frames.push_back(self->internFrame("[JIT compiler]"));
+
+	if (!self->m_frames.empty())
+		self->record(porting::getTimeUs(), self->internStack(self->m_frames),
+			samples);
+}
+
+#else
+
+static std::string describe_frame(const lua_Debug &ar)
+{
+	std::string name = ar.name ? ar.name : "?";
+	if (ar.what[0] == 'C')
+		return name + " [C]";
+	if (ar.what[0] == 't')
+		return "(tail call)";
+	if (ar.what[0] == 'm')
+		name = "(main chunk)";
+
+	name.append(" @").append(ar.short_src).append(":")
+		.append(std::to_string(ar.linedefined));
+	// ';' separates the frames in the collapsed format
+	std::replace(name.begin(), name.end(), ';', ',');
+	return name;
+}
+
+void LuaSampler::hook(lua_State *L, lua_Debug *)
+{
+	LuaSampler *self = s_running;
+	if (!self)
+		return;
+
+	u64 now = porting::getTimeUs();
+	if (now - self->m_last_sample_us < self->m_interval_us)
+		return;
+	// A long running C function delays the hook by several intervals
+	u32 weight = (now - self->m_last_sample_us) / self->m_interval_us;
+	self->m_last_sample_us = now;
+
+	self->m_frames.clear();
+	lua_Debug ar;
+	for (int level = 0; level < MAX_DEPTH && lua_getstack(L, level, &ar); level++) {
+		lua_getinfo(L, "Sn", &ar);
+		self->m_frames.push_back(self->internFrame(describe_frame(ar)));
+	}
+	std::reverse(self->m_frames.begin(), self->m_frames.end());
+
+	if (!self->m_frames.empty())
+		self->record(now, self->internStack(self->m_frames), weight);
+}
+
+#endif
+
+void LuaSampler::addSample(u64 time_us, const std::vector<std::string> &frames,
+		u32 weight)
+{
+	std::vector<u32> ids;
+	ids.reserve(frames.size());
+	for (const std::string &frame : frames)
+		ids.push_back(internFrame(frame));
+	record(time_us, internStack(ids), weight);
+}
+
+u32 LuaSampler::internFrame(const std::string &name)
+{
+	auto it = m_frame_ids.find(name);
+	if (it != m_frame_ids.end())
+		return it->second;
+
+	u32 id = m_frame_names.size();
+	m_frame_names.push_back(name);
+	m_frame_ids.emplace(name, id);
+	return id;
+}
+
+u32 LuaSampler::internStack(const std::vector<u32> &frames)
+{
+	auto it = m_stack_ids.find(frames);
+	if (it != m_stack_ids.end())
+		return it->second;
+
+	u32 id = m_stacks.size();
+	m_stacks.push_back(frames);
+	m_stack_ids.emplace(frames, id);
+	return id;
+}
+
+void LuaSampler::record(u64 time_us, u32 stack, u32 weight)
+{
+	if (m_samples.size() < m_max_samples) {
+		m_samples.push_back({time_us, stack, weight});
+		return;
+	}
+	m_samples[m_oldest_sample] = {time_us, stack, weight};
+	m_oldest_sample = (m_oldest_sample + 1) % m_max_samples;
+
+	// Keep the interned stacks bounded once old samples are overwritten
+	if (m_stacks.size() >= 2 * m_max_samples)
+		dropUnusedStacks();
+}
+
+void LuaSampler::dropUnusedStacks()
+{
+	std::vector<u32> stack_map(m_stacks.size(), U32_MAX);
+	std::vector<u32> frame_map(m_frame_names.size(), U32_MAX);
+	std::vector<std::vector<u32>> stacks;
+	std::vector<std::string> frame_names;
+
+	// Number them in chronological order, like the original numbering
+	for (size_t i = 0; i < m_samples.size(); i++) {
+		Sample &sample = m_samples[(m_oldest_sample + i) % m_samples.size()];
+		u32 &stack_id = stack_map[sample.stack];
+		if (stack_id == U32_MAX) {
+			stack_id = stacks.size();
+			std::vector<u32> frames = std::move(m_stacks[sample.stack]);
+			for (u32 &frame : frames) {
+				u32 &frame_id = frame_map[frame];
+				if (frame_id == U32_MAX) {
+					frame_id = frame_names.size();
+					frame_names.push_back(std::move(m_frame_names[frame]));
+				}
+				frame = frame_id;
+			}
+			stacks.push_back(std::move(frames));
+		}
+		sample.stack = stack_id;
+	}
+
+	m_stacks = std::move(stacks);
+	m_frame_names = std::move(frame_names);
+	m_stack_ids.clear();
+	for (size_t i = 0; i < m_stacks.size(); i++)
+		m_stack_ids.emplace(m_stacks[i], i);
+	m_frame_ids.clear();
+	for (size_t i = 0; i < m_frame_names.size(); i++)
+		m_frame_ids.emplace(m_frame_names[i], i);
+}
+
+template <typename F>
+void LuaSampler::forEachSample(F func) const
+{
+	for (size_t i = m_oldest_sample; i < m_samples.size(); i++)
+		func(m_samples[i]);
+	for (size_t i = 0; i < m_oldest_sample; i++)
+		func(m_samples[i]);
+}
+
+void LuaSampler::writeCollapsed(std::ostream &os) const
+{
+	std::vector<u64> counts(m_stacks.size(), 0);
+	for (const Sample &sample : m_samples)
+		counts[sample.stack] += sample.weight;
+
+	for (size_t i = 0; i < m_stacks.size(); i++) {
+		if (counts[i] == 0)
+			continue;
+		const char *sep = "";
+		for (u32 frame : m_stacks[i]) {
+			os << sep << m_frame_names[frame];
+			sep = ";";
+		}
+		os << ' ' << counts[i] << '\n';
+	}
+}
+
+void LuaSampler::writeChromeTrace(std::ostream &os) const
+{
+	Json::Value events(Json::arrayValue);
+	const u64 interval = m_interval_us > 0 ? m_interval_us : 1000;
+
+	// Consecutive samples sharing the same frames are merged into one event
+	// per frame. Contains the frames of the last sample and their start times.
+	std::vector<std::pair<u32, u64>> open;
+	u64 start_time = 0, last_time = 0;
+
+	auto close_frames = [&] (size_t keep, u64 end_time) {
+		while (open.size() > keep) {
+			Json::Value event;
+			event["name"] = m_frame_names[open.back().first];
+			event["cat"] = "lua";
+			event["ph"] = "X";
+			event["ts"] = (Json::UInt64)(open.back().second - start_time);
+			event["dur"] = (Json::UInt64)(end_time - open.back().second);
+			event["pid"] = 1;
+			event["tid"] = 1;
+			events.append(std::move(event));
+			open.pop_back();
+		}
+	};
+
+	forEachSample([&] (const Sample &sample) {
+		if (events.empty() && open.empty())
+			start_time = sample.time_us;
+		// No Lua code was running in between
+		if (sample.time_us - last_time > 2 * interval)
+			close_frames(0, last_time + interval);
+
+		const std::vector<u32> &frames = m_stacks[sample.stack];
+		size_t common = 0;
+		while (common < open.size() && common < frames.size() &&
+				open[common].first == frames[common])
+			common++;
+		close_frames(common, sample.time_us);
+		for (size_t i = common; i < frames.size(); i++)
+			open.emplace_back(frames[i], sample.time_us);
+		last_time = sample.time_us;
+	});
+	close_frames(0, last_time + interval);
+
+	Json::Value root;
+	root["traceEvents"] = std::move(events);
+	root["displayTimeUnit"] = "ms";
+	fastWriteJson(root, os);
+}
@@ -0,0 +1,109 @@
+// Luanti
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (C) 2024 Luanti Authors
+
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "irrlichttypes.h"
+#include "util/basic_macros.h"
+#include "config.h"
+
+extern "C" {
+#include <lua.h>
+}
+
+/*
+	Sampling profiler for Lua code.
+
+	While running, the call stack of the executing Lua code (including the
+	C functions on it) is recorded once per sampling interval. This needs no
+	instrumentation of the profiled functions, so it does not skew the results.
+
+	The samples are kept in a fixed size ring buffer: the oldest samples are
+	dropped first, and so are the stacks and frame names only they used.
+	Recording and exporting both happen on the thread running the Lua state,
+	so no locking is needed.
+
+	Only one sampler can run at a time, since LuaJIT supports only a single
+	profiler per process.
+*/
+class LuaSampler
+{
+public:
+	LuaSampler(size_t max_samples = 1 << 18);
+	~LuaSampler();
+	DISABLE_CLASS_COPY(LuaSampler);
+
+	// Returns false if a sampler is already running
+	bool start(lua_State *L, u32 interval_us);
+	void stop();
+	bool isRunning() const { return m_L != nullptr; }
+	// Drops all samples
+	void clear();
+	// Called before the engine runs a script callback
+	void enterCallback();
+
+	size_t getSampleCount() const { return m_samples.size(); }
+
+	// Writes one "frame;frame;...;frame count" line per distinct stack,
+	// root frame first. This is the input format of flamegraph.pl, inferno
+	// and speedscope.
+	void writeCollapsed(std::ostream &os) const;
+	// Writes the samples as a timeline of Chrome trace events, which can be
+	// opened in chrome://tracing or Perfetto.
+	void writeChromeTrace(std::ostream &os) const;
+
+	// Records a sample, root frame first
+	void addSample(u64 time_us, const std::vector<std::string> &frames,
+			u32 weight = 1);
+
+private:
+	struct Sample {
+		u64 time_us;
+		u32 stack;
+		u32 weight;
+	};
+
+	// Deepest stack level that is recorded
+	static constexpr int MAX_DEPTH = 64;
+
+	u32 internFrame(const std::string &name);
+	u32 internStack(const std::vector<u32> &frames);
+	void record(u64 time_us, u32 stack, u32 weight);
+	// Removes the stacks and frames no sample refers to anymore
+	void dropUnusedStacks();
+
+	// Calls func(sample) for all samples in chronological order
+	template <typename F>
+	void forEachSample(F func) const;
+
+#if USE_LUAJIT
+	static void profileCallback(void *data, lua_State *L, int samples, int vmstate);
+#else
+	static void hook(lua_State *L, lua_Debug *ar);
+#endif
+
+	static LuaSampler *s_running;
+
+	lua_State *m_L = nullptr;
+	u32 m_interval_us = 0;
+	u64 m_last_sample_us = 0;
+
+	size_t m_max_samples;
+	std::vector<Sample> m_samples;
+	// Next position to overwrite once the ring buffer is full
+	size_t m_oldest_sample = 0;
+
+	std::vector<std::string> m_frame_names;
+	std::unordered_map<std::string, u32> m_frame_ids;
+	std::vector<std::vector<u32>> m_stacks;
+	std::map<std::vector<u32>, u32> m_stack_ids;
+
+	// Reused when sampling
+	std::vector<u32> m_frames;
+};
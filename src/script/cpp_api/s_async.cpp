@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LGPL-2.1-or-later
 // Copyright (C) 2013 sapier, <sapier AT gmx DOT net>
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 
@@ -45,9 +46,11 @@ AsyncEngine::~AsyncEngine()
 		delete workerThread;
 	}
 
-	jobQueueMutex.lock();
-	jobQueue.clear();
-	jobQueueMutex.unlock();
+	for (auto &queue : jobQueues) {
+		MutexAutoLock autolock(queue->mutex);
+		for (auto &jobs : queue->jobs)
+			jobs.clear();
+	}
 	workerThreads.clear();
 }
 
@@ -70,7 +73,14 @@ void AsyncEngine::initialize(unsigned int numEngines)
 			autoscaleMaxWorkers -= 2;
 		infostream << "AsyncEngine: using at most " << autoscaleMaxWorkers
 			<< " threads with automatic scaling" << std::endl;
+	}
 
+	// pushJob() may have created the first queue already
+	const size_t max_workers = std::max(numEngines, autoscaleMaxWorkers);
+	while (jobQueues.size() < std::max<size_t>(max_workers, 1))
+		jobQueues.emplace_back(std::make_unique<JobQueue>());
+
+	if (numEngines == 0) {
 		addWorkerThread();
 	} else {
 		for (unsigned int i = 0; i < numEngines; i++)
@@ -82,61 +92,121 @@ void AsyncEngine::addWorkerThread()
 {
 	AsyncWorkerThread *toAdd = new AsyncWorkerThread(this,
 		std::string("AsyncWorker-") + itos(workerThreads.size()));
+	toAdd->queueIndex = workerThreads.size() % jobQueues.size();
 	workerThreads.push_back(toAdd);
 	toAdd->start();
 }
 
 /******************************************************************************/
 u32 AsyncEngine::queueAsyncJob(std::string &&func, std::string &&params,
-		const std::string &mod_origin)
+		const std::string &mod_origin, AsyncJobPriority priority)
 {
-	MutexAutoLock autolock(jobQueueMutex);
-	u32 jobId = jobIdCounter++;
-
-	jobQueue.emplace_back();
-	auto &to_add = jobQueue.back();
-	to_add.id = jobId;
+	LuaJobInfo to_add;
+	to_add.id = jobIdCounter++;
 	to_add.function = std::move(func);
 	to_add.params = std::move(params);
 	to_add.mod_origin = mod_origin;
+	to_add.priority = priority;
 
-	jobQueueCounter.post();
+	u32 jobId = to_add.id;
+	pushJob(std::move(to_add));
 	return jobId;
 }
 
 u32 AsyncEngine::queueAsyncJob(std::string &&func, PackedValue *params,
-		const std::string &mod_origin)
+		const std::string &mod_origin, AsyncJobPriority priority)
 {
-	MutexAutoLock autolock(jobQueueMutex);
-	u32 jobId = jobIdCounter++;
-
-	jobQueue.emplace_back();
-	auto &to_add = jobQueue.back();
-	to_add.id = jobId;
+	LuaJobInfo to_add;
+	to_add.id = jobIdCounter++;
 	to_add.function = std::move(func);
 	to_add.params_ext.reset(params);
 	to_add.mod_origin = mod_origin;
+	to_add.priority = priority;
 
-	jobQueueCounter.post();
+	u32 jobId = to_add.id;
+	pushJob(std::move(to_add));
 	return jobId;
 }
 
+void AsyncEngine::pushJob(LuaJobInfo &&job)
+{
+	job.queued_us = porting::getTimeUs();
+	const AsyncJobPriority priority = job.priority;
+
+	// Jobs queued before initialize() wait in the first queue
+	if (jobQueues.empty())
+		jobQueues.emplace_back(std::make_unique<JobQueue>());
+
+	// Spread the jobs over the queues of the running threads
+	const size_t queue_count = std::max<size_t>(workerThreads.size(), 1);
+	JobQueue &queue = *jobQueues[nextJobQueue % queue_count];
+	nextJobQueue++;
+	{
+		MutexAutoLock autolock(queue.mutex);
+		queue.jobs[priority].emplace_back(std::move(job));
+		// Under the lock, so getJob() can't decrement it first
+		jobCounts[priority]++;
+	}
+
+	jobQueueCounter.post();
+}
+
+bool AsyncEngine::cancelAsyncJob(u32 id)
+{
+	for (auto &queue : jobQueues) {
+		MutexAutoLock autolock(queue->mutex);
+		for (u8 priority = 0; priority < ASYNC_PRIORITY_COUNT; priority++) {
+			auto &jobs = queue->jobs[priority];
+			auto it = std::find_if(jobs.begin(), jobs.end(),
+				[id] (const LuaJobInfo &job) { return job.id == id; });
+			if (it == jobs.end())
+				continue;
+			jobs.erase(it);
+			jobCounts[priority]--;
+			// The semaphore still counts the job, getJob() will just return
+			// without one once.
+			return true;
+		}
+	}
+	return false;
+}
+
 /******************************************************************************/
-bool AsyncEngine::getJob(LuaJobInfo *job)
+bool AsyncEngine::getJob(size_t queue_index, LuaJobInfo *job)
 {
 	jobQueueCounter.wait();
-	jobQueueMutex.lock();
 
-	bool retval = false;
+	auto has_jobs = [this] () {
+		for (const auto &count : jobCounts) {
+			if (count > 0)
+				return true;
+		}
+		return false;
+	};
 
-	if (!jobQueue.empty()) {
-		*job = std::move(jobQueue.front());
-		jobQueue.pop_front();
-		retval = true;
+	// While scanning, another worker may take the job this one was woken for
+	// and a new job may be pushed to a queue that was already passed. Its
+	// wakeup was used up by this worker, so don't give up while jobs are left.
+	while (has_jobs()) {
+		for (u8 priority = 0; priority < ASYNC_PRIORITY_COUNT; priority++) {
+			if (jobCounts[priority] == 0)
+				continue;
+			// Start with the own queue, then take jobs from the other ones
+			for (size_t i = 0; i < jobQueues.size(); i++) {
+				JobQueue &queue = *jobQueues[(queue_index + i) % jobQueues.size()];
+				MutexAutoLock autolock(queue.mutex);
+				auto &jobs = queue.jobs[priority];
+				if (jobs.empty())
+					continue;
+				*job = std::move(jobs.front());
+				jobs.pop_front();
+				jobCounts[priority]--;
+				return true;
+			}
+		}
 	}
-	jobQueueMutex.unlock();
 
-	return retval;
+	return false;
 }
 
 /******************************************************************************/
@@ -166,6 +236,9 @@ void AsyncEngine::stepJobResults(lua_State *L)
 		LuaJobInfo j = std::move(resultQueue.front());
 		resultQueue.pop_front();
 
+		if (metricsBackend)
+			reportJobMetrics(j);
+
 		lua_getfield(L, -1, "async_event_handler");
 		if (lua_isnil(L, -1))
 			FATAL_ERROR("Async event handler does not exist!");
@@ -188,20 +261,55 @@ void AsyncEngine::stepJobResults(lua_State *L)
 	lua_pop(L, 2); // Pop core and error handler
 }
 
+void AsyncEngine::reportJobMetrics(const LuaJobInfo &job)
+{
+	auto it = modMetrics.find(job.mod_origin);
+	if (it == modMetrics.end()) {
+		const std::string &mod = job.mod_origin.empty() ? "unknown" : job.mod_origin;
+		ModMetrics metrics;
+		metrics.jobs = metricsBackend->addCounter("minetest_core_async_jobs",
+			"Number of finished async jobs", {{"mod", mod}});
+		metrics.wait_time = metricsBackend->addCounter(
+			"minetest_core_async_job_wait_time",
+			"Time async jobs waited in the queue (in seconds)", {{"mod", mod}});
+		metrics.run_time = metricsBackend->addCounter(
+			"minetest_core_async_job_run_time",
+			"Time async jobs ran (in seconds)", {{"mod", mod}});
+		it = modMetrics.emplace(job.mod_origin, std::move(metrics)).first;
+	}
+
+	it->second.jobs->increment();
+	it->second.wait_time->increment((job.started_us - job.queued_us) / 1.0e6);
+	it->second.run_time->increment((job.finished_us - job.started_us) / 1.0e6);
+}
+
 void AsyncEngine::stepAutoscale()
 {
 	if (workerThreads.size() >= autoscaleMaxWorkers)
 		return;
 
-	MutexAutoLock autolock(jobQueueMutex);
+	// Calls func(job) for every queued job
+	auto for_each_job = [this] (auto func) {
+		for (auto &queue : jobQueues) {
+			MutexAutoLock autolock(queue->mutex);
+			for (const auto &jobs : queue->jobs) {
+				for (const auto &job : jobs)
+					func(job);
+			}
+		}
+	};
+	u32 queued = 0;
+	for (const auto &count : jobCounts)
+		queued += count;
 
 	// 2) If the timer elapsed, check again
 	if (autoscaleTimer && porting::getTimeMs() >= autoscaleTimer) {
 		autoscaleTimer = 0;
 		// Determine overlap with previous snapshot
 		unsigned int n = 0;
-		for (const auto &it : jobQueue)
-			n += autoscaleSeenJobs.count(it.id);
+		for_each_job([&] (const LuaJobInfo &job) {
+			n += autoscaleSeenJobs.count(job.id);
+		});
 		autoscaleSeenJobs.clear();
 		infostream << "AsyncEngine: " << n << " jobs were still waiting after 1s" << std::endl;
 		// Start this many new threads
@@ -213,10 +321,11 @@ void AsyncEngine::stepAutoscale()
 	}
 
 	// 1) Check if there's anything in the queue
-	if (!autoscaleTimer && !jobQueue.empty()) {
+	if (!autoscaleTimer && queued > 0) {
 		// Take a snapshot of all jobs we have seen
-		for (const auto &it : jobQueue)
-			autoscaleSeenJobs.emplace(it.id);
+		for_each_job([&] (const LuaJobInfo &job) {
+			autoscaleSeenJobs.emplace(job.id);
+		});
 		// and set a timer for 1 second
 		autoscaleTimer = porting::getTimeMs() + 1000;
 	}
@@ -319,8 +428,9 @@ void* AsyncWorkerThread::run()
 	LuaJobInfo j;
 	while (!stopRequested()) {
 		// Wait for job
-		if (!jobDispatcher->getJob(&j) || stopRequested())
+		if (!jobDispatcher->getJob(queueIndex, &j) || stopRequested())
 			continue;
+		j.started_us = porting::getTimeUs();
 
 		const bool use_ext = !!j.params_ext;
 
@@ -364,6 +474,7 @@ void* AsyncWorkerThread::run()
 		}
 
 		lua_pop(L, 1);  // Pop retval
+		j.finished_us = porting::getTimeUs();
 
 		// Put job result
 		if (result == 0)
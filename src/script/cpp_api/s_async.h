@@ -6,8 +6,10 @@
 
 #include <vector>
 #include <deque>
+#include <unordered_map>
 #include <unordered_set>
 #include <memory>
+#include <atomic>
 
 #include <lua.h>
 #include "threading/semaphore.h"
@@ -15,6 +17,7 @@
 #include "common/c_packer.h"
 #include "cpp_api/s_base.h"
 #include "cpp_api/s_security.h"
+#include "util/metricsbackend.h"
 
 // Forward declarations
 class AsyncEngine;
@@ -22,6 +25,14 @@ class AsyncEngine;
 
 // Declarations
 
+// Jobs with a higher priority (lower value) are run first
+enum AsyncJobPriority : u8 {
+	ASYNC_PRIORITY_HIGH,
+	ASYNC_PRIORITY_NORMAL,
+	ASYNC_PRIORITY_LOW,
+	ASYNC_PRIORITY_COUNT
+};
+
 // Data required to queue a job
 struct LuaJobInfo
 {
@@ -41,6 +52,11 @@ struct LuaJobInfo
 	std::string mod_origin;
 	// JobID used to identify a job and match it to callback
 	u32 id;
+	AsyncJobPriority priority = ASYNC_PRIORITY_NORMAL;
+	// Times in microseconds, used for the metrics
+	u64 queued_us = 0;
+	u64 started_us = 0;
+	u64 finished_us = 0;
 };
 
 // Asynchronous working environment
@@ -57,6 +73,8 @@ class AsyncWorkerThread : public Thread,
 
 private:
 	AsyncEngine *jobDispatcher = nullptr;
+	// Index of the job queue this thread takes jobs from first
+	size_t queueIndex;
 	bool isErrored = false;
 };
 
@@ -81,6 +99,12 @@ class AsyncEngine {
 	 */
 	void initialize(unsigned int numEngines);
 
+	/**
+	 * Report the wait and run times of the jobs to a metrics backend
+	 * @param backend Metrics backend, must outlive the engine
+	 */
+	void setMetricsBackend(MetricsBackend *backend) { metricsBackend = backend; }
+
 	/**
 	 * Queue an async job
 	 * @param func Serialized lua function
@@ -88,7 +112,8 @@ class AsyncEngine {
 	 * @return jobid The job is queued
 	 */
 	u32 queueAsyncJob(std::string &&func, std::string &&params,
-			const std::string &mod_origin = "");
+			const std::string &mod_origin = "",
+			AsyncJobPriority priority = ASYNC_PRIORITY_NORMAL);
 
 	/**
 	 * Queue an async job
@@ -97,7 +122,15 @@ class AsyncEngine {
 	 * @return ID of queued job
 	 */
 	u32 queueAsyncJob(std::string &&func, PackedValue *params,
-			const std::string &mod_origin = "");
+			const std::string &mod_origin = "",
+			AsyncJobPriority priority = ASYNC_PRIORITY_NORMAL);
+
+	/**
+	 * Remove a job that has not started yet from the queue
+	 * @param id ID of the job
+	 * @return whether the job was removed, its result will never arrive
+	 */
+	bool cancelAsyncJob(u32 id);
 
 	/**
 	 * Engine step to process finished jobs
@@ -109,10 +142,16 @@ class AsyncEngine {
 	/**
 	 * Get a Job from queue to be processed
 	 *  this function blocks until a job is ready
+	 * @param queue_index queue of the calling thread, checked first
 	 * @param job a job to be processed
 	 * @return whether a job was available
 	 */
-	bool getJob(LuaJobInfo *job);
+	bool getJob(size_t queue_index, LuaJobInfo *job);
+
+	/**
+	 * Add a job to the queue of one of the worker threads
+	 */
+	void pushJob(LuaJobInfo &&job);
 
 	/**
 	 * Put a Job result back to result queue
@@ -135,6 +174,11 @@ class AsyncEngine {
 	 */
 	void stepAutoscale();
 
+	/**
+	 * Add the times of a finished job to the metrics
+	 */
+	void reportJobMetrics(const LuaJobInfo &job);
+
 	/**
 	 * Initialize environment with current registred functions
 	 *  this function adds all functions registred by registerFunction to the
@@ -164,10 +208,22 @@ class AsyncEngine {
 	// Internal counter to create job IDs
 	u32 jobIdCounter = 0;
 
-	// Mutex to protect job queue
-	std::mutex jobQueueMutex;
-	// Job queue
-	std::deque<LuaJobInfo> jobQueue;
+	/*
+		Every worker thread has its own queue, so that they do not all
+		contend for the same mutex. A thread whose queue is empty takes jobs
+		from the others. The queues are created by initialize() for the
+		maximum number of threads and never change afterwards, except for
+		the first one which also holds the jobs queued before that.
+	*/
+	struct JobQueue {
+		std::mutex mutex;
+		std::deque<LuaJobInfo> jobs[ASYNC_PRIORITY_COUNT];
+	};
+	std::vector<std::unique_ptr<JobQueue>> jobQueues;
+	// Number of queued jobs per priority, to skip the empty ones quickly
+	std::atomic<u32> jobCounts[ASYNC_PRIORITY_COUNT] = {};
+	// Queue that receives the next job
+	size_t nextJobQueue = 0;
 
 	// Mutex to protect result queue
 	std::mutex resultQueueMutex;
@@ -179,4 +235,13 @@ class AsyncEngine {
 
 	// Counter semaphore for job dispatching
 	Semaphore jobQueueCounter;
+
+	MetricsBackend *metricsBackend = nullptr;
+	struct ModMetrics {
+		MetricCounterPtr jobs;
+		MetricCounterPtr wait_time;
+		MetricCounterPtr run_time;
+	};
+	// Indexed by mod origin
+	std::unordered_map<std::string, ModMetrics> modMetrics;
 };
@@ -11,6 +11,7 @@
 #include "filesys.h"
 #include "content/mods.h"
 #include "porting.h"
+#include "settings.h"
 #include "util/string.h"
 #include "server.h"
 #if CHECK_CLIENT_BUILD()
@@ -30,6 +31,7 @@ extern "C" {
 #endif
 }
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdarg>
 #include "script/common/c_content.h"
@@ -153,13 +155,114 @@ ScriptApiBase::ScriptApiBase(ScriptingType type):
 
 	// Make sure Lua uses the right locale
 	setlocale(LC_NUMERIC, "C");
+
+	setGCParams(g_settings->getS32("lua_gc_pause"),
+		g_settings->getS32("lua_gc_stepmul"));
+	pushGCSentinel();
+	m_gc_heap_base = getHeapSize();
 }
 
 ScriptApiBase::~ScriptApiBase()
 {
+	// Removes the hooks from the state
+	m_sampler.reset();
+	m_gc_closing = true;
+
 	lua_close(m_luastack);
 }
 
+LuaSampler &ScriptApiBase::getSampler()
+{
+	if (!m_sampler)
+		m_sampler = std::make_unique<LuaSampler>();
+	return *m_sampler;
+}
+
+bool ScriptApiBase::startSampler(u32 interval_us)
+{
+	// Hooks must be set on the main thread, coroutines inherit them
+	return getSampler().start(m_luastack, interval_us);
+}
+
+void ScriptApiBase::setGCParams(int pause, int stepmul)
+{
+	lua_State *L = m_luastack;
+	m_gc_pause = std::max(pause, 0);
+	lua_gc(L, LUA_GCSETPAUSE, m_gc_pause);
+	lua_gc(L, LUA_GCSETSTEPMUL, std::max(stepmul, 1));
+}
+
+u64 ScriptApiBase::stepGC(u64 max_us)
+{
+	SCRIPTAPI_PRECHECKHEADER
+
+	// The collector starts a cycle by itself once the heap has reached
+	// pause percent of its size after the last cycle. Start it half way
+	// there, so that it is done before.
+	if (!m_gc_idle_cycle) {
+		size_t threshold = m_gc_heap_base;
+		if (m_gc_pause > 100)
+			threshold += m_gc_heap_base * (m_gc_pause - 100) / 200;
+		if (getHeapSize() < threshold)
+			return 0;
+		m_gc_idle_cycle = true;
+	}
+
+	const u64 start = porting::getTimeUs();
+	u64 now = start;
+	do {
+		// Small steps, to not overshoot the time limit by much
+		if (lua_gc(L, LUA_GCSTEP, 16)) {
+			m_gc_idle_cycle = false;
+			m_gc_heap_base = getHeapSize();
+			break;
+		}
+		now = porting::getTimeUs();
+	} while (now - start < max_us);
+
+	return porting::getTimeUs() - start;
+}
+
+size_t ScriptApiBase::getHeapSize()
+{
+	lua_State *L = m_luastack;
+	return ((size_t)lua_gc(L, LUA_GCCOUNT, 0) << 10) + lua_gc(L, LUA_GCCOUNTB, 0);
+}
+
+void ScriptApiBase::pushGCSentinel()
+{
+	lua_State *L = m_luastack;
+	lua_newuserdata(L, 1);
+	lua_createtable(L, 0, 1);
+#if INDIRECT_SCRIPTAPI_RIDX
+	*(void **)(lua_newuserdata(L, sizeof(void *))) = this;
+#else
+	lua_pushlightuserdata(L, this);
+#endif
+	lua_pushcclosure(L, gcSentinel, 1);
+	lua_setfield(L, -2, "__gc");
+	lua_setmetatable(L, -2);
+	lua_pop(L, 1);
+}
+
+int ScriptApiBase::gcSentinel(lua_State *L)
+{
+#if INDIRECT_SCRIPTAPI_RIDX
+	auto *self = *(ScriptApiBase **)lua_touserdata(L, lua_upvalueindex(1));
+#else
+	auto *self = (ScriptApiBase *)lua_touserdata(L, lua_upvalueindex(1));
+#endif
+	if (self->m_gc_closing)
+		return 0;
+
+	self->m_gc_cycles++;
+	// Also catches the cycles not run by stepGC()
+	if (!self->m_gc_idle_cycle)
+		self->m_gc_heap_base = self->getHeapSize();
+	self->pushGCSentinel();
+	return 0;
+}
+
 int ScriptApiBase::luaPanic(lua_State *L)
 {
 	std::ostringstream oss;
@@ -383,6 +486,9 @@ void ScriptApiBase::realityCheck()
 		std::string traceback = script_get_backtrace(m_luastack);
 		throw LuaError("Stack is over 30 (reality check)\n" + traceback);
 	}
+
+	if (m_sampler)
+		m_sampler->enterCallback();
 }
 
 void ScriptApiBase::scriptError(int result, const char *fxn)
@@ -432,7 +538,8 @@ void ScriptApiBase::setOriginFromTableRaw(int index, const char *fxn)
 /*
  * How ObjectRefs are handled in Lua:
  * When an active object is created, an ObjectRef is created on the Lua side
- * and stored in core.object_refs[id].
+ * and stored in core.object_refs[id]. The table is also kept in the registry
+ * for quick access, since ObjectRefs are pushed very often.
  * Methods that require an ObjectRef to a certain object retrieve it from that
  * table instead of creating their own.(*)
  * When an active object is removed, the existing ObjectRef is invalidated
@@ -453,15 +560,13 @@ void ScriptApiBase::addObjectReference(ServerActiveObject *cobj)
 	int object = lua_gettop(L);
 
 	// Get core.object_refs table
-	lua_getglobal(L, "core");
-	lua_getfield(L, -1, "object_refs");
+	lua_rawgeti(L, LUA_REGISTRYINDEX, CUSTOM_RIDX_OBJECT_REFS);
 	luaL_checktype(L, -1, LUA_TTABLE);
 	int objectstable = lua_gettop(L);
 
 	// object_refs[id] = object
-	lua_pushinteger(L, cobj->getId()); // Push id
 	lua_pushvalue(L, object); // Copy object to top of stack
-	lua_settable(L, objectstable);
+	lua_rawseti(L, objectstable, cobj->getId());
 }
 
 void ScriptApiBase::removeObjectReference(ServerActiveObject *cobj)
@@ -470,22 +575,19 @@ void ScriptApiBase::removeObjectReference(ServerActiveObject *cobj)
 	assert(getType() == ScriptingType::Server);
 
 	// Get core.object_refs table
-	lua_getglobal(L, "core");
-	lua_getfield(L, -1, "object_refs");
+	lua_rawgeti(L, LUA_REGISTRYINDEX, CUSTOM_RIDX_OBJECT_REFS);
 	luaL_checktype(L, -1, LUA_TTABLE);
 	int objectstable = lua_gettop(L);
 
 	// Get object_refs[id]
-	lua_pushinteger(L, cobj->getId()); // Push id
-	lua_gettable(L, objectstable);
+	lua_rawgeti(L, objectstable, cobj->getId());
 	// Set object reference to NULL
 	ObjectRef::set_null(L, cobj);
 	lua_pop(L, 1); // pop object
 
 	// Set object_refs[id] = nil
-	lua_pushinteger(L, cobj->getId()); // Push id
 	lua_pushnil(L);
-	lua_settable(L, objectstable);
+	lua_rawseti(L, objectstable, cobj->getId());
 }
 
 void ScriptApiBase::objectrefGetOrCreate(lua_State *L, ServerActiveObject *cobj)
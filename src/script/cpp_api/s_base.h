@@ -5,6 +5,7 @@
 #pragma once
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <thread>
 #include <mutex>
@@ -20,6 +21,7 @@ extern "C" {
 #include "irrlichttypes.h"
 #include "common/c_types.h"
 #include "common/c_internal.h"
+#include "common/c_sampler.h"
 #include "debug.h"
 #include "config.h"
 
@@ -122,6 +124,24 @@ class ScriptApiBase : protected LuaHelper {
 	// Check things that should be set by the builtin mod.
 	void checkSetByBuiltin();
 
+	// Sampling profiler for this Lua state
+	LuaSampler &getSampler();
+	// Starts sampling the whole state, including coroutines.
+	// Returns false if a sampler is already running.
+	bool startSampler(u32 interval_us);
+
+	/* Garbage collection */
+	// Sets the pause and step multiplier of the incremental collector
+	void setGCParams(int pause, int stepmul);
+	// Does incremental collection steps for up to max_us microseconds if a
+	// cycle is due soon or was started by a previous call.
+	// Returns the time spent in microseconds.
+	u64 stepGC(u64 max_us);
+	// Size of the Lua heap in bytes
+	size_t getHeapSize();
+	// Number of finished collection cycles
+	u32 getGCCycles() const { return m_gc_cycles; }
+
 protected:
 	friend class LuaABM;
 	friend class LuaLBM;
@@ -179,6 +199,11 @@ class ScriptApiBase : protected LuaHelper {
 
 private:
 	static int luaPanic(lua_State *L);
+	// Creates a userdata only the collector knows of, which is finalized at
+	// the end of the next cycle. Its finalizer counts the cycle and creates
+	// the next one.
+	void pushGCSentinel();
+	static int gcSentinel(lua_State *L);
 
 	lua_State      *m_luastack = nullptr;
 
@@ -189,5 +214,15 @@ class ScriptApiBase : protected LuaHelper {
 #endif
 	EmergeThread   *m_emerge = nullptr;
 
+	std::unique_ptr<LuaSampler> m_sampler;
+
+	int            m_gc_pause = 200;
+	u32            m_gc_cycles = 0;
+	bool           m_gc_closing = false;
+	// Heap size at the end of the last cycle
+	size_t         m_gc_heap_base = 0;
+	// A cycle is being run by stepGC()
+	bool           m_gc_idle_cycle = false;
+
 	ScriptingType  m_type;
 };
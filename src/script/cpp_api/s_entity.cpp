@@ -239,6 +239,82 @@ void ScriptApiEntity::luaentity_Step(u16 id, float dtime,
 	lua_pop(L, 2); // Pop object and error handler
 }
 
+void ScriptApiEntity::luaentity_StepBatch(float dtime,
+	const std::vector<std::pair<u16, const collisionMoveResult *>> &steps)
+{
+	SCRIPTAPI_PRECHECKHEADER
+
+	if (steps.empty())
+		return;
+
+	int error_handler = PUSH_ERROR_HANDLER(L);
+
+	lua_getglobal(L, "core");
+	lua_getfield(L, -1, "luaentities");
+	luaL_checktype(L, -1, LUA_TTABLE);
+	int luaentities = lua_gettop(L);
+	lua_getfield(L, -2, "run_entity_steps");
+	luaL_checktype(L, -1, LUA_TFUNCTION);
+	int func = lua_gettop(L);
+
+	auto push_table = [&] (int &ref) {
+		if (ref == LUA_NOREF) {
+			lua_createtable(L, steps.size(), 0);
+			lua_pushvalue(L, -1);
+			ref = luaL_ref(L, LUA_REGISTRYINDEX);
+		} else {
+			lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+		}
+	};
+
+	push_table(m_step_ids_ref);
+	int ids = lua_gettop(L);
+	lua_pushnumber(L, dtime);
+	push_table(m_step_moveresults_ref);
+	int moveresults = lua_gettop(L);
+
+	int i = 1;
+	for (const auto &step : steps) {
+		// Leave out entities without on_step, so that no moveresult is
+		// built for them
+		lua_pushinteger(L, step.first);
+		lua_gettable(L, luaentities);
+		bool has_on_step = false;
+		if (lua_istable(L, -1)) {
+			lua_getfield(L, -1, "on_step");
+			has_on_step = lua_isfunction(L, -1);
+			lua_pop(L, 1);
+		}
+		lua_pop(L, 1);
+		if (!has_on_step)
+			continue;
+
+		lua_pushinteger(L, step.first);
+		lua_rawseti(L, ids, i);
+		if (step.second)
+			push_collision_move_result(L, *step.second);
+		else
+			lua_pushboolean(L, false);
+		lua_rawseti(L, moveresults, i);
+		i++;
+	}
+	const int count = i - 1;
+	// Don't keep the moveresults of the previous step alive
+	for (; i <= (int)m_step_batch_size; i++) {
+		lua_pushnil(L);
+		lua_rawseti(L, ids, i);
+		lua_pushnil(L);
+		lua_rawseti(L, moveresults, i);
+	}
+	m_step_batch_size = count;
+
+	lua_pushinteger(L, count);
+	lua_insert(L, func + 1);
+	PCALL_RES(lua_pcall(L, 4, 0, error_handler));
+
+	lua_pop(L, 3); // Pop luaentities, core and error handler
+}
+
 // Calls entity:on_punch(ObjectRef puncher, time_from_last_punch,
 //                       tool_capabilities, direction, damage)
 bool ScriptApiEntity::luaentity_Punch(u16 id,
@@ -7,6 +7,8 @@
 #include "cpp_api/s_base.h"
 #include "irr_v3d.h"
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 struct ObjectProperties;
 struct ToolCapabilities;
@@ -26,6 +28,10 @@ class ScriptApiEntity
 			ServerActiveObject *self, ObjectProperties *prop, const std::string &entity_name);
 	void luaentity_Step(u16 id, float dtime,
 		const collisionMoveResult *moveresult);
+	// Runs on_step for many entities with a single call into Lua.
+	// The moveresult is nullptr for entities that are not physical.
+	void luaentity_StepBatch(float dtime,
+		const std::vector<std::pair<u16, const collisionMoveResult *>> &steps);
 	bool luaentity_Punch(u16 id,
 			ServerActiveObject *puncher, float time_from_last_punch,
 			const ToolCapabilities *toolcap, v3f dir, s32 damage);
@@ -44,4 +50,11 @@ class ScriptApiEntity
 	 * properties being outside of initial_properties. If an entity's name is in here,
 	 * it won't cause any more of those deprecation warnings. */
 	std::unordered_set<std::string> deprecation_warned_init_properties;
+
+	// Registry references of the tables passed to core.run_entity_steps,
+	// they are reused between server steps.
+	int m_step_ids_ref = LUA_NOREF;
+	int m_step_moveresults_ref = LUA_NOREF;
+	// Number of entries filled in by the previous luaentity_StepBatch()
+	size_t m_step_batch_size = 0;
 };
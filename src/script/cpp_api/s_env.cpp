@@ -12,6 +12,8 @@
 #include "server.h"
 #include "scripting_server.h"
 #include "script/common/c_content.h"
+#include "nodedef.h"
+#include <algorithm>
 
 /*
 	LuaABM & LuaLBM
@@ -88,6 +90,72 @@ class LuaABM : public ActiveBlockModifier {
 	}
 };
 
+/*
+	ABM with a declarative action that runs without calling into Lua:
+	the node (or the air above it) is replaced if the conditions on the
+	node above are met.
+*/
+class NativeABM : public LuaABM {
+public:
+	struct Action {
+		MapNode node;
+		// Use swap_node instead of set_node, no callbacks are run
+		bool swap = false;
+		// Replace the node above instead of the triggering node
+		bool above = false;
+		// Allowed light levels of the node above
+		u8 min_light = 0;
+		u8 max_light = LIGHT_SUN;
+		// Allowed contents of the node above, sorted. Empty = any
+		std::vector<content_t> above_contents;
+	};
+
+	NativeABM(int id,
+			const std::vector<std::string> &trigger_contents,
+			const std::vector<std::string> &required_neighbors,
+			const std::vector<std::string> &without_neighbors,
+			float trigger_interval, u32 trigger_chance, bool simple_catch_up,
+			s16 min_y, s16 max_y, Action &&action):
+		LuaABM(id, trigger_contents, required_neighbors, without_neighbors,
+			trigger_interval, trigger_chance, simple_catch_up, min_y, max_y),
+		m_action(std::move(action))
+	{
+	}
+
+	virtual void trigger(ServerEnvironment *env, v3s16 p, MapNode n,
+			u32 active_object_count, u32 active_object_count_wider)
+	{
+		const Action &a = m_action;
+		const v3s16 p_above = p + v3s16(0, 1, 0);
+
+		if (a.above || !a.above_contents.empty() ||
+				a.min_light > 0 || a.max_light < LIGHT_SUN) {
+			bool pos_ok;
+			MapNode n_above = env->getMap().getNode(p_above, &pos_ok);
+			if (!pos_ok)
+				return;
+			if (!a.above_contents.empty() && !std::binary_search(
+					a.above_contents.begin(), a.above_contents.end(),
+					n_above.getContent()))
+				return;
+			const NodeDefManager *ndef = env->getGameDef()->ndef();
+			u8 light = n_above.getLightBlend(env->getDayNightRatio(),
+				ndef->getLightingFlags(n_above));
+			if (light < a.min_light || light > a.max_light)
+				return;
+		}
+
+		const v3s16 target = a.above ? p_above : p;
+		if (a.swap)
+			env->swapNode(target, a.node);
+		else
+			env->setNode(target, a.node);
+	}
+
+private:
+	Action m_action;
+};
+
 class LuaLBM : public LoadingBlockModifierDef
 {
 private:
@@ -192,6 +260,53 @@ bool ScriptApiEnv::read_nodenames(lua_State *L, int idx, std::vector<std::string
 	return true;
 }
 
+// Reads the `native` table of an ABM definition
+static NativeABM::Action read_native_abm_action(lua_State *L, int idx,
+		const NodeDefManager *ndef, const std::vector<std::string> &above_names)
+{
+	NativeABM::Action action;
+	if (idx < 0)
+		idx = lua_gettop(L) + idx + 1;
+
+	std::string name;
+	lua_getfield(L, idx, "node");
+	if (lua_istable(L, -1)) {
+		getstringfield(L, -1, "name", name);
+		action.node.param1 = getintfield_default(L, -1, "param1", 0);
+		action.node.param2 = getintfield_default(L, -1, "param2", 0);
+	} else if (lua_isstring(L, -1)) {
+		name = lua_tostring(L, -1);
+	}
+	lua_pop(L, 1);
+	content_t c;
+	if (!ndef->getId(name, c))
+		throw LuaError("Native ABM: unknown node \"" + name + "\"");
+	action.node.setContent(c);
+
+	action.swap = getboolfield_default(L, idx, "swap", false);
+	std::string position = "self";
+	getstringfield(L, idx, "position", position);
+	if (position != "self" && position != "above")
+		throw LuaError("Native ABM: invalid position \"" + position + "\"");
+	action.above = position == "above";
+
+	action.min_light = rangelim(getintfield_default(L, idx, "min_light", 0),
+		0, LIGHT_SUN);
+	action.max_light = rangelim(getintfield_default(L, idx, "max_light", LIGHT_SUN),
+		0, LIGHT_SUN);
+	if (action.min_light > action.max_light)
+		throw LuaError("Native ABM: min_light is greater than max_light");
+
+	for (const std::string &above_name : above_names)
+		ndef->getIds(above_name, action.above_contents);
+	std::sort(action.above_contents.begin(), action.above_contents.end());
+	// Nothing to match, e.g. because the nodes are not registered
+	if (!above_names.empty() && action.above_contents.empty())
+		action.above_contents.push_back(CONTENT_IGNORE);
+
+	return action;
+}
+
 void ScriptApiEnv::readABMs()
 {
 	SCRIPTAPI_PRECHECKHEADER
@@ -242,13 +357,30 @@ void ScriptApiEnv::readABMs()
 		s16 max_y = INT16_MAX;
 		getintfield(L, current_abm, "max_y", max_y);
 
-		lua_getfield(L, current_abm, "action");
-		luaL_checktype(L, current_abm + 1, LUA_TFUNCTION);
-		lua_pop(L, 1);
+		LuaABM *abm;
+		lua_getfield(L, current_abm, "native");
+		if (lua_istable(L, -1)) {
+			std::vector<std::string> above_names;
+			lua_getfield(L, -1, "above");
+			read_nodenames(L, -1, above_names);
+			lua_pop(L, 1);
+
+			auto action = read_native_abm_action(L, -1,
+				env->getGameDef()->ndef(), above_names);
+			abm = new NativeABM(id, trigger_contents, required_neighbors,
+				without_neighbors, trigger_interval, trigger_chance,
+				simple_catch_up, min_y, max_y, std::move(action));
+			lua_pop(L, 1);
+		} else {
+			lua_pop(L, 1);
+			lua_getfield(L, current_abm, "action");
+			luaL_checktype(L, current_abm + 1, LUA_TFUNCTION);
+			lua_pop(L, 1);
 
-		LuaABM *abm = new LuaABM(id, trigger_contents, required_neighbors,
-			without_neighbors, trigger_interval, trigger_chance,
-			simple_catch_up, min_y, max_y);
+			abm = new LuaABM(id, trigger_contents, required_neighbors,
+				without_neighbors, trigger_interval, trigger_chance,
+				simple_catch_up, min_y, max_y);
+		}
 
 		env->addActiveBlockModifier(abm);
 
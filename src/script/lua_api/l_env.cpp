@@ -9,6 +9,7 @@
 #include "lua_api/l_nodetimer.h"
 #include "lua_api/l_noise.h"
 #include "lua_api/l_vmanip.h"
+#include "lua_api/l_shareddata.h"
 #include "lua_api/l_object.h"
 #include "common/c_converter.h"
 #include "common/c_content.h"
@@ -192,6 +193,7 @@ int ModApiEnv::l_bulk_set_node(lua_State *L)
 	MapNode n = readnode(L, 2);
 
 	// Do it
+	MapLightUpdateBatch light_batch(&env->getMap());
 	bool succeeded = true;
 	for (s32 i = 1; i <= len; i++) {
 		lua_rawgeti(L, 1, i);
@@ -251,6 +253,7 @@ int ModApiEnv::l_bulk_swap_node(lua_State *L)
 	MapNode n = readnode(L, 2);
 
 	// Do it
+	MapLightUpdateBatch light_batch(&env->getMap());
 	bool succeeded = true;
 	for (s32 i = 1; i <= len; i++) {
 		lua_rawgeti(L, 1, i);
@@ -298,8 +301,9 @@ int ModApiEnv::l_get_node_light(lua_State *L)
 	if(lua_isnumber(L, 2))
 		time_of_day = 24000.0 * lua_tonumber(L, 2);
 	time_of_day %= 24000;
-	u32 dnr = time_to_daynight_ratio(time_of_day, true);
+	u32 dnr = time_to_daynight_ratio(time_of_day);
 
+	env->getMap().flushLightUpdates();
 	bool is_position_ok;
 	MapNode n = env->getMap().getNode(pos, &is_position_ok);
 	if (is_position_ok) {
@@ -321,6 +325,7 @@ int ModApiEnv::l_get_natural_light(lua_State *L)
 
 	v3s16 pos = read_v3s16(L, 1);
 
+	env->getMap().flushLightUpdates();
 	bool is_position_ok;
 	MapNode n = env->getMap().getNode(pos, &is_position_ok);
 	if (!is_position_ok)
@@ -340,7 +345,7 @@ int ModApiEnv::l_get_natural_light(lua_State *L)
 	} else {
 		time_of_day = env->getTimeOfDay();
 	}
-	u32 dnr = time_to_daynight_ratio(time_of_day, true);
+	u32 dnr = time_to_daynight_ratio(time_of_day);
 
 	// If it's the same as the artificial light, the sunlight needs to be
 	// searched for because the value may not emanate from the sun
@@ -964,12 +969,10 @@ int ModApiEnv::l_find_nodes_in_area(lua_State *L)
 	return findNodesInArea(L, ndef, filter, grouped, iterate);
 }
 
-template <typename F>
-int ModApiEnvBase::findNodesInAreaUnderAir(lua_State *L, v3s16 minp, v3s16 maxp,
-	const std::vector<content_t> &filter, F &&getNode)
+template <typename F, typename G>
+void ModApiEnvBase::forEachNodeUnderAir(v3s16 minp, v3s16 maxp,
+	const std::vector<content_t> &filter, F &&getNode, G &&found)
 {
-	lua_newtable(L);
-	u32 i = 0;
 	v3s16 p;
 	for (p.X = minp.X; p.X <= maxp.X; p.X++)
 	for (p.Z = minp.Z; p.Z <= maxp.Z; p.Z++) {
@@ -979,13 +982,84 @@ int ModApiEnvBase::findNodesInAreaUnderAir(lua_State *L, v3s16 minp, v3s16 maxp,
 			v3s16 psurf(p.X, p.Y + 1, p.Z);
 			content_t csurf = getNode(psurf).getContent();
 			if (c != CONTENT_AIR && csurf == CONTENT_AIR &&
-					CONTAINS(filter, c)) {
-				push_v3s16(L, p);
-				lua_rawseti(L, -2, ++i);
-			}
+					CONTAINS(filter, c))
+				found(p);
 			c = csurf;
 		}
 	}
+}
+
+template <typename F>
+int ModApiEnvBase::findNodesInAreaUnderAir(lua_State *L, v3s16 minp, v3s16 maxp,
+	const std::vector<content_t> &filter, F &&getNode)
+{
+	lua_newtable(L);
+	u32 i = 0;
+	forEachNodeUnderAir(minp, maxp, filter, getNode, [&] (v3s16 p) {
+		push_v3s16(L, p);
+		lua_rawseti(L, -2, ++i);
+	});
+	return 1;
+}
+
+static void push_buffer(lua_State *L, int buffer_idx, int narr)
+{
+	if (lua_istable(L, buffer_idx))
+		lua_pushvalue(L, buffer_idx);
+	else
+		lua_createtable(L, narr, 0);
+}
+
+template <typename F>
+int ModApiEnvBase::findNodeIndicesInArea(lua_State *L, int buffer_idx,
+	const VoxelArea &area, const std::vector<content_t> &filter, F &&iterate)
+{
+	push_buffer(L, buffer_idx, 0);
+	u32 i = 0;
+	iterate([&](v3s16 p, MapNode n) -> bool {
+		if (CONTAINS(filter, n.getContent())) {
+			lua_pushinteger(L, area.index(p) + 1);
+			lua_rawseti(L, -2, ++i);
+		}
+		return true;
+	});
+	lua_pushinteger(L, i);
+	return 2;
+}
+
+template <typename F>
+int ModApiEnvBase::findNodeIndicesInAreaUnderAir(lua_State *L, int buffer_idx,
+	const VoxelArea &area, v3s16 minp, v3s16 maxp,
+	const std::vector<content_t> &filter, F &&getNode)
+{
+	push_buffer(L, buffer_idx, 0);
+	u32 i = 0;
+	forEachNodeUnderAir(minp, maxp, filter, getNode, [&] (v3s16 p) {
+		lua_pushinteger(L, area.index(p) + 1);
+		lua_rawseti(L, -2, ++i);
+	});
+	lua_pushinteger(L, i);
+	return 2;
+}
+
+template <typename F>
+int ModApiEnvBase::getNodeContentIdsInArea(lua_State *L, int buffer_idx,
+	const VoxelArea &area, F &&iterate)
+{
+	// Collected first, since iterate goes through the area block by block
+	// while Lua tables should be filled in order.
+	const u32 volume = area.getVolume();
+	std::vector<content_t> ids(volume, CONTENT_IGNORE);
+	iterate([&](v3s16 p, MapNode n) -> bool {
+		ids[area.index(p)] = n.getContent();
+		return true;
+	});
+
+	push_buffer(L, buffer_idx, volume);
+	for (u32 i = 0; i < volume; i++) {
+		lua_pushinteger(L, ids[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
 	return 1;
 }
 
@@ -1024,6 +1098,72 @@ int ModApiEnv::l_find_nodes_in_area_under_air(lua_State *L)
 	return findNodesInAreaUnderAir(L, minp, maxp, filter, getNode);
 }
 
+// find_nodes_in_area_indices(minp, maxp, nodenames, [buffer])
+int ModApiEnv::l_find_nodes_in_area_indices(lua_State *L)
+{
+	GET_ENV_PTR;
+
+	v3s16 minp = read_v3s16(L, 1);
+	v3s16 maxp = read_v3s16(L, 2);
+	sortBoxVerticies(minp, maxp);
+	// Indices refer to the area as requested, before clamping
+	const VoxelArea area(minp, maxp);
+	checkArea(minp, maxp);
+
+	const NodeDefManager *ndef = env->getGameDef()->ndef();
+	Map &map = env->getMap();
+
+	std::vector<content_t> filter;
+	collectNodeIds(L, 3, ndef, filter);
+
+	auto iterate = [&] (auto &&callback) {
+		map.forEachNodeInArea(minp, maxp, callback);
+	};
+	return findNodeIndicesInArea(L, 4, area, filter, iterate);
+}
+
+// find_nodes_in_area_under_air_indices(minp, maxp, nodenames, [buffer])
+int ModApiEnv::l_find_nodes_in_area_under_air_indices(lua_State *L)
+{
+	GET_ENV_PTR;
+
+	v3s16 minp = read_v3s16(L, 1);
+	v3s16 maxp = read_v3s16(L, 2);
+	sortBoxVerticies(minp, maxp);
+	const VoxelArea area(minp, maxp);
+	checkArea(minp, maxp);
+
+	const NodeDefManager *ndef = env->getGameDef()->ndef();
+	Map &map = env->getMap();
+
+	std::vector<content_t> filter;
+	collectNodeIds(L, 3, ndef, filter);
+
+	auto getNode = [&map] (v3s16 p) -> MapNode {
+		return map.getNode(p);
+	};
+	return findNodeIndicesInAreaUnderAir(L, 4, area, minp, maxp, filter, getNode);
+}
+
+// get_node_content_ids_in_area(minp, maxp, [buffer])
+int ModApiEnv::l_get_node_content_ids_in_area(lua_State *L)
+{
+	GET_ENV_PTR;
+
+	v3s16 minp = read_v3s16(L, 1);
+	v3s16 maxp = read_v3s16(L, 2);
+	sortBoxVerticies(minp, maxp);
+	const VoxelArea area(minp, maxp);
+	checkArea(minp, maxp);
+
+	Map &map = env->getMap();
+
+	auto iterate = [&] (auto &&callback) {
+		map.forEachNodeInArea(minp, maxp, callback);
+	};
+	return getNodeContentIdsInArea(L, 3, area, iterate);
+}
+
 // get_perlin(seeddiff, octaves, persistence, scale)
 // returns world-specific PerlinNoise
 int ModApiEnv::l_get_perlin(lua_State *L)
@@ -1076,6 +1216,12 @@ int ModApiEnv::l_get_voxel_manip(lua_State *L)
 	return LuaVoxelManip::create_object(L);
 }
 
+// get_map_snapshot(p1, p2)
+int ModApiEnv::l_get_map_snapshot(lua_State *L)
+{
+	return LuaMapSnapshot::create_object(L);
+}
+
 // clear_objects([options])
 // clear all objects in the environment
 // where options = {mode = "full" or "quick"}
@@ -1416,6 +1562,9 @@ void ModApiEnv::Initialize(lua_State *L, int top)
 	API_FCT(find_node_near);
 	API_FCT(find_nodes_in_area);
 	API_FCT(find_nodes_in_area_under_air);
+	API_FCT(find_nodes_in_area_indices);
+	API_FCT(find_nodes_in_area_under_air_indices);
+	API_FCT(get_node_content_ids_in_area);
 	API_FCT(fix_light);
 	API_FCT(load_area);
 	API_FCT(emerge_area);
@@ -1423,6 +1572,7 @@ void ModApiEnv::Initialize(lua_State *L, int top)
 	API_FCT(get_perlin);
 	API_FCT(get_perlin_map);
 	API_FCT(get_voxel_manip);
+	API_FCT(get_map_snapshot);
 	API_FCT(clear_objects);
 	API_FCT(spawn_tree);
 	API_FCT(find_path);
@@ -1538,6 +1688,30 @@ int ModApiEnvVM::l_find_node_near(lua_State *L)
 	return findNodeNear(L, pos, radius, filter, start_radius, getNode);
 }
 
+// Behaves like Map::forEachNodeInArea, but only visits the part of the area
+// that is inside the VoxelManipulator.
+template <typename F>
+static void vm_for_each_node_in_area(MMVManip *vm, v3s16 minp, v3s16 maxp,
+		F &&callback)
+{
+	// avoid the loop going out-of-bounds
+	VoxelArea cropped = VoxelArea(minp, maxp).intersect(vm->m_area);
+	minp = cropped.MinEdge;
+	maxp = cropped.MaxEdge;
+
+	for (s16 z = minp.Z; z <= maxp.Z; z++)
+	for (s16 y = minp.Y; y <= maxp.Y; y++) {
+		u32 vi = vm->m_area.index(minp.X, y, z);
+		for (s16 x = minp.X; x <= maxp.X; x++) {
+			v3s16 pos(x, y, z);
+			MapNode n = vm->m_data[vi];
+			if (!callback(pos, n))
+				return;
+			++vi;
+		}
+	}
+}
+
 // find_nodes_in_area(minp, maxp, nodenames, [grouped])
 int ModApiEnvVM::l_find_nodes_in_area(lua_State *L)
 {
@@ -1550,12 +1724,6 @@ int ModApiEnvVM::l_find_nodes_in_area(lua_State *L)
 	sortBoxVerticies(minp, maxp);
 
 	checkArea(minp, maxp);
-	// avoid the loop going out-of-bounds
-	{
-		VoxelArea cropped = VoxelArea(minp, maxp).intersect(vm->m_area);
-		minp = cropped.MinEdge;
-		maxp = cropped.MaxEdge;
-	}
 
 	std::vector<content_t> filter;
 	collectNodeIds(L, 3, ndef, filter);
@@ -1563,17 +1731,7 @@ int ModApiEnvVM::l_find_nodes_in_area(lua_State *L)
 	bool grouped = lua_isboolean(L, 4) && readParam<bool>(L, 4);
 
 	auto iterate = [&] (auto callback) {
-		for (s16 z = minp.Z; z <= maxp.Z; z++)
-		for (s16 y = minp.Y; y <= maxp.Y; y++) {
-			u32 vi = vm->m_area.index(minp.X, y, z);
-			for (s16 x = minp.X; x <= maxp.X; x++) {
-				v3s16 pos(x, y, z);
-				MapNode n = vm->m_data[vi];
-				if (!callback(pos, n))
-					return;
-				++vi;
-			}
-		}
+		vm_for_each_node_in_area(vm, minp, maxp, callback);
 	};
 	return findNodesInArea(L, ndef, filter, grouped, iterate);
 }
@@ -1599,6 +1757,67 @@ int ModApiEnvVM::l_find_nodes_in_area_under_air(lua_State *L)
 	return findNodesInAreaUnderAir(L, minp, maxp, filter, getNode);
 }
 
+// find_nodes_in_area_indices(minp, maxp, nodenames, [buffer])
+int ModApiEnvVM::l_find_nodes_in_area_indices(lua_State *L)
+{
+	GET_VM_PTR;
+
+	const NodeDefManager *ndef = getGameDef(L)->ndef();
+
+	v3s16 minp = read_v3s16(L, 1);
+	v3s16 maxp = read_v3s16(L, 2);
+	sortBoxVerticies(minp, maxp);
+	const VoxelArea area(minp, maxp);
+	checkArea(minp, maxp);
+
+	std::vector<content_t> filter;
+	collectNodeIds(L, 3, ndef, filter);
+
+	auto iterate = [&] (auto callback) {
+		vm_for_each_node_in_area(vm, minp, maxp, callback);
+	};
+	return findNodeIndicesInArea(L, 4, area, filter, iterate);
+}
+
+// find_nodes_in_area_under_air_indices(minp, maxp, nodenames, [buffer])
+int ModApiEnvVM::l_find_nodes_in_area_under_air_indices(lua_State *L)
+{
+	GET_VM_PTR;
+
+	const NodeDefManager *ndef = getGameDef(L)->ndef();
+
+	v3s16 minp = read_v3s16(L, 1);
+	v3s16 maxp = read_v3s16(L, 2);
+	sortBoxVerticies(minp, maxp);
+	const VoxelArea area(minp, maxp);
+	checkArea(minp, maxp);
+
+	std::vector<content_t> filter;
+	collectNodeIds(L, 3, ndef, filter);
+
+	auto getNode = [&vm] (v3s16 p) -> MapNode {
+		return vm->getNodeNoExNoEmerge(p);
+	};
+	return findNodeIndicesInAreaUnderAir(L, 4, area, minp, maxp, filter, getNode);
+}
+
+// get_node_content_ids_in_area(minp, maxp, [buffer])
+int ModApiEnvVM::l_get_node_content_ids_in_area(lua_State *L)
+{
+	GET_VM_PTR;
+
+	v3s16 minp = read_v3s16(L, 1);
+	v3s16 maxp = read_v3s16(L, 2);
+	sortBoxVerticies(minp, maxp);
+	const VoxelArea area(minp, maxp);
+	checkArea(minp, maxp);
+
+	auto iterate = [&] (auto callback) {
+		vm_for_each_node_in_area(vm, minp, maxp, callback);
+	};
+	return getNodeContentIdsInArea(L, 3, area, iterate);
+}
+
 // spawn_tree(pos, treedef)
 int ModApiEnvVM::l_spawn_tree(lua_State *L)
 {
@@ -1644,6 +1863,9 @@ void ModApiEnvVM::InitializeEmerge(lua_State *L, int top)
 	API_FCT(find_node_near);
 	API_FCT(find_nodes_in_area);
 	API_FCT(find_nodes_in_area_under_air);
+	API_FCT(find_nodes_in_area_indices);
+	API_FCT(find_nodes_in_area_under_air_indices);
+	API_FCT(get_node_content_ids_in_area);
 	API_FCT(spawn_tree);
 }
 
@@ -8,6 +8,7 @@
 #include "raycast.h"
 
 class ServerScripting;
+class VoxelArea;
 
 // base class containing helpers
 class ModApiEnvBase : public ModApiBase {
@@ -35,6 +36,36 @@ class ModApiEnvBase : public ModApiBase {
 	static int findNodesInAreaUnderAir(lua_State *L, v3s16 minp, v3s16 maxp,
 		const std::vector<content_t> &filter, F &&getNode);
 
+	// F must be (v3s16 pos) -> MapNode
+	// G must be (v3s16 pos) -> void, called for every node found
+	template <typename F, typename G>
+	static void forEachNodeUnderAir(v3s16 minp, v3s16 maxp,
+		const std::vector<content_t> &filter, F &&getNode, G &&found);
+
+	/*
+		The *Indices variants push the found nodes as 1-based indices into area
+		(like VoxelArea:index), followed by the number of nodes found.
+		A table at buffer_idx is reused, its entries after the count are not
+		cleared.
+	*/
+
+	// F like in findNodesInArea
+	template <typename F>
+	static int findNodeIndicesInArea(lua_State *L, int buffer_idx,
+		const VoxelArea &area, const std::vector<content_t> &filter, F &&iterate);
+
+	// F must be (v3s16 pos) -> MapNode
+	template <typename F>
+	static int findNodeIndicesInAreaUnderAir(lua_State *L, int buffer_idx,
+		const VoxelArea &area, v3s16 minp, v3s16 maxp,
+		const std::vector<content_t> &filter, F &&getNode);
+
+	// Pushes the content ids of all nodes in area, ignore where iterate
+	// doesn't reach. F like in findNodesInArea.
+	template <typename F>
+	static int getNodeContentIdsInArea(lua_State *L, int buffer_idx,
+		const VoxelArea &area, F &&iterate);
+
 	static const EnumString es_ClearObjectsMode[];
 	static const EnumString es_BlockStatusType[];
 
@@ -167,6 +198,17 @@ class ModApiEnv : public ModApiEnvBase {
 	// nodenames: eg. {"ignore", "group:tree"} or "default:dirt"
 	static int l_find_nodes_in_area_under_air(lua_State *L);
 
+	// find_nodes_in_area_indices(minp, maxp, nodenames, [buffer])
+	// -> list of indices, count
+	static int l_find_nodes_in_area_indices(lua_State *L);
+
+	// find_nodes_in_area_under_air_indices(minp, maxp, nodenames, [buffer])
+	// -> list of indices, count
+	static int l_find_nodes_in_area_under_air_indices(lua_State *L);
+
+	// get_node_content_ids_in_area(minp, maxp, [buffer]) -> list of content ids
+	static int l_get_node_content_ids_in_area(lua_State *L);
+
 	// fix_light(p1, p2) -> true/false
 	static int l_fix_light(lua_State *L);
 
@@ -191,6 +233,10 @@ class ModApiEnv : public ModApiEnvBase {
 	// returns world-specific voxel manipulator
 	static int l_get_voxel_manip(lua_State *L);
 
+	// get_map_snapshot(p1, p2)
+	// returns a read-only copy of the area that can be shared with async jobs
+	static int l_get_map_snapshot(lua_State *L);
+
 	// clear_objects()
 	// clear all objects in the environment
 	static int l_clear_objects(lua_State *L);
@@ -261,6 +307,15 @@ class ModApiEnvVM : public ModApiEnvBase {
 	// find_surface_nodes_in_area(minp, maxp, nodenames)
 	static int l_find_nodes_in_area_under_air(lua_State *L);
 
+	// find_nodes_in_area_indices(minp, maxp, nodenames, [buffer])
+	static int l_find_nodes_in_area_indices(lua_State *L);
+
+	// find_nodes_in_area_under_air_indices(minp, maxp, nodenames, [buffer])
+	static int l_find_nodes_in_area_under_air_indices(lua_State *L);
+
+	// get_node_content_ids_in_area(minp, maxp, [buffer])
+	static int l_get_node_content_ids_in_area(lua_State *L);
+
 	// spawn_tree(pos, treedef)
 	static int l_spawn_tree(lua_State *L);
 
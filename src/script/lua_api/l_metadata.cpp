@@ -189,6 +189,77 @@ int MetaDataRef::l_set_float(lua_State *L)
 	return 0;
 }
 
+// get_many(self, names, [buffer])
+int MetaDataRef::l_get_many(lua_State *L)
+{
+	MAP_LOCK_REQUIRED;
+
+	MetaDataRef *ref = checkAnyMetadata(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+	const int count = lua_objlen(L, 2);
+
+	if (lua_istable(L, 3))
+		lua_pushvalue(L, 3);
+	else
+		lua_createtable(L, 0, count);
+	const int result = lua_gettop(L);
+
+	IMetadata *meta = ref->getmeta(false);
+	std::string str_;
+	for (int i = 1; i <= count; i++) {
+		lua_rawgeti(L, 2, i);
+		std::string name = luaL_checkstring(L, -1);
+		if (meta) {
+			const std::string &str = meta->getString(name, &str_);
+			lua_pushlstring(L, str.c_str(), str.size());
+		} else {
+			lua_pushlstring(L, "", 0);
+		}
+		// Set result[name] = value, the name is still on the stack
+		lua_rawset(L, result);
+	}
+	return 1;
+}
+
+// set_many(self, fields)
+int MetaDataRef::l_set_many(lua_State *L)
+{
+	MAP_LOCK_REQUIRED;
+
+	MetaDataRef *ref = checkAnyMetadata(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	IMetadata *meta = nullptr;
+	std::string changed_name;
+	u32 changed = 0;
+	bool all_private = true;
+
+	lua_pushnil(L);
+	while (lua_next(L, 2)) {
+		// key at index -2 and value at index -1
+		auto str = readParam<std::string_view>(L, -1);
+		// Convert a copy, converting the key itself would confuse lua_next
+		lua_pushvalue(L, -2);
+		std::string name = luaL_checkstring(L, -1);
+		lua_pop(L, 1);
+		if (!meta)
+			meta = ref->getmeta(!str.empty());
+		if (meta && meta->setString(name, str)) {
+			all_private = all_private && ref->isPrivate(name);
+			changed_name = std::move(name);
+			changed++;
+		}
+		lua_pop(L, 1);
+	}
+
+	// Report once. The name tells whether the change is private, any of
+	// them does if all changed keys are.
+	if (changed > 0)
+		ref->reportMetadataChange(changed == 1 || all_private ?
+			&changed_name : nullptr);
+	return 0;
+}
+
 // get_keys(self)
 int MetaDataRef::l_get_keys(lua_State *L)
 {
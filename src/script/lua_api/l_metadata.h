@@ -23,6 +23,8 @@ class MetaDataRef : public ModApiBase
 
 protected:
 	virtual void reportMetadataChange(const std::string *name = nullptr) {}
+	// Whether changes of this key are hidden from clients
+	virtual bool isPrivate(const std::string &name) { return false; }
 	virtual IMetadata *getmeta(bool auto_create) = 0;
 	virtual void clearMeta() = 0;
 
@@ -59,6 +61,12 @@ class MetaDataRef : public ModApiBase
 	// set_float(self, name, var)
 	static int l_set_float(lua_State *L);
 
+	// get_many(self, names, [buffer])
+	static int l_get_many(lua_State *L);
+
+	// set_many(self, fields)
+	static int l_set_many(lua_State *L);
+
 	// get_keys(self)
 	static int l_get_keys(lua_State *L);
 
@@ -37,6 +37,12 @@ void NodeMetaRef::clearMeta()
 	m_env->getMap().removeNodeMetadata(m_p);
 }
 
+bool NodeMetaRef::isPrivate(const std::string &name)
+{
+	NodeMetadata *meta = dynamic_cast<NodeMetadata*>(getmeta(false));
+	return meta && meta->isPrivate(name);
+}
+
 void NodeMetaRef::reportMetadataChange(const std::string *name)
 {
 	SANITY_CHECK(!m_is_local);
@@ -199,6 +205,8 @@ const luaL_Reg NodeMetaRef::methodsServer[] = {
 	luamethod(MetaDataRef, set_int),
 	luamethod(MetaDataRef, get_float),
 	luamethod(MetaDataRef, set_float),
+	luamethod(MetaDataRef, get_many),
+	luamethod(MetaDataRef, set_many),
 	luamethod(MetaDataRef, get_keys),
 	luamethod(MetaDataRef, to_table),
 	luamethod(MetaDataRef, from_table),
@@ -221,6 +229,7 @@ const luaL_Reg NodeMetaRef::methodsClient[] = {
 	luamethod(MetaDataRef, get_string),
 	luamethod(MetaDataRef, get_int),
 	luamethod(MetaDataRef, get_float),
+	luamethod(MetaDataRef, get_many),
 	luamethod(MetaDataRef, get_keys),
 	luamethod(MetaDataRef, to_table),
 	{0,0}
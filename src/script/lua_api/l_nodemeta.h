@@ -45,6 +45,7 @@ class NodeMetaRef : public MetaDataRef {
 	virtual void clearMeta();
 
 	virtual void reportMetadataChange(const std::string *name = nullptr);
+	virtual bool isPrivate(const std::string &name);
 
 	virtual void handleToTable(lua_State *L, IMetadata *_meta);
 	virtual bool handleFromTable(lua_State *L, int table, IMetadata *_meta);
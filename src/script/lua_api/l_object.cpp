@@ -113,6 +113,22 @@ int ObjectRef::l_get_pos(lua_State *L)
 	return 1;
 }
 
+// get_pos_xyz(self)
+int ObjectRef::l_get_pos_xyz(lua_State *L)
+{
+	NO_MAP_LOCK_REQUIRED;
+	ObjectRef *ref = checkObject<ObjectRef>(L, 1);
+	ServerActiveObject *sao = getobject(ref);
+	if (sao == nullptr)
+		return 0;
+
+	v3f pos = sao->getBasePosition() / BS;
+	lua_pushnumber(L, pos.X);
+	lua_pushnumber(L, pos.Y);
+	lua_pushnumber(L, pos.Z);
+	return 3;
+}
+
 // set_pos(self, pos)
 int ObjectRef::l_set_pos(lua_State *L)
 {
@@ -1028,6 +1044,21 @@ int ObjectRef::l_add_velocity(lua_State *L)
 	return 0;
 }
 
+// Gets the velocity of an entity or player in nodes per second
+static bool get_object_velocity(ServerActiveObject *sao, v3f *vel)
+{
+	if (sao->getType() == ACTIVEOBJECT_TYPE_LUAENTITY) {
+		LuaEntitySAO *entitysao = dynamic_cast<LuaEntitySAO*>(sao);
+		*vel = entitysao->getVelocity() / BS;
+		return true;
+	} else if (sao->getType() == ACTIVEOBJECT_TYPE_PLAYER) {
+		RemotePlayer *player = dynamic_cast<PlayerSAO*>(sao)->getPlayer();
+		*vel = player->getSpeed() / BS;
+		return true;
+	}
+	return false;
+}
+
 // get_velocity(self)
 int ObjectRef::l_get_velocity(lua_State *L)
 {
@@ -1037,21 +1068,30 @@ int ObjectRef::l_get_velocity(lua_State *L)
 	if (sao == nullptr)
 		return 0;
 
-	if (sao->getType() == ACTIVEOBJECT_TYPE_LUAENTITY) {
-		LuaEntitySAO *entitysao = dynamic_cast<LuaEntitySAO*>(sao);
-		v3f vel = entitysao->getVelocity();
-		pushFloatPos(L, vel);
-		return 1;
-	} else if (sao->getType() == ACTIVEOBJECT_TYPE_PLAYER) {
-		RemotePlayer *player = dynamic_cast<PlayerSAO*>(sao)->getPlayer();
-		push_v3f(L, player->getSpeed() / BS);
-		return 1;
-	}
-
-	lua_pushnil(L);
+	v3f vel;
+	if (get_object_velocity(sao, &vel))
+		push_v3f(L, vel);
+	else
+		lua_pushnil(L);
 	return 1;
 }
 
+// get_velocity_xyz(self)
+int ObjectRef::l_get_velocity_xyz(lua_State *L)
+{
+	NO_MAP_LOCK_REQUIRED;
+	ObjectRef *ref = checkObject<ObjectRef>(L, 1);
+	ServerActiveObject *sao = getobject(ref);
+	v3f vel;
+	if (sao == nullptr || !get_object_velocity(sao, &vel))
+		return 0;
+
+	lua_pushnumber(L, vel.X);
+	lua_pushnumber(L, vel.Y);
+	lua_pushnumber(L, vel.Z);
+	return 3;
+}
+
 // set_acceleration(self, acceleration)
 int ObjectRef::l_set_acceleration(lua_State *L)
 {
@@ -2784,6 +2824,7 @@ luaL_Reg ObjectRef::methods[] = {
 	luamethod(ObjectRef, remove),
 	luamethod(ObjectRef, is_valid),
 	luamethod_aliased(ObjectRef, get_pos, getpos),
+	luamethod(ObjectRef, get_pos_xyz),
 	luamethod_aliased(ObjectRef, set_pos, setpos),
 	luamethod(ObjectRef, add_pos),
 	luamethod_aliased(ObjectRef, move_to, moveto),
@@ -2821,6 +2862,7 @@ luaL_Reg ObjectRef::methods[] = {
 	luamethod_aliased(ObjectRef, set_velocity, setvelocity),
 	luamethod_aliased(ObjectRef, add_velocity, add_player_velocity),
 	luamethod_aliased(ObjectRef, get_velocity, getvelocity),
+	luamethod(ObjectRef, get_velocity_xyz),
 	luamethod_dep(ObjectRef, get_velocity, get_player_velocity),
 
 	// LuaEntitySAO-only
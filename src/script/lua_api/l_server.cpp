@@ -7,6 +7,7 @@
 #include "common/c_converter.h"
 #include "common/c_content.h"
 #include "common/c_packer.h"
+#include "common/c_sampler.h"
 #include "cpp_api/s_base.h"
 #include "cpp_api/s_security.h"
 #include "scripting_server.h"
@@ -15,6 +16,7 @@
 #include "remoteplayer.h"
 #include "log.h"
 #include "filesys.h"
+#include "settings.h"
 #include <algorithm>
 
 // request_shutdown()
@@ -489,6 +491,46 @@ int ModApiServer::l_get_worldpath(lua_State *L)
 	return 1;
 }
 
+// lua_sampler_start([interval_us])
+int ModApiServer::l_lua_sampler_start(lua_State *L)
+{
+	NO_MAP_LOCK_REQUIRED;
+	u32 interval_us = lua_isnoneornil(L, 1) ?
+		g_settings->getU32("profiler.sampling_interval") :
+		std::max<lua_Integer>(luaL_checkinteger(L, 1), 1);
+	lua_pushboolean(L, getScriptApiBase(L)->startSampler(interval_us));
+	return 1;
+}
+
+// lua_sampler_stop() -> number of samples
+int ModApiServer::l_lua_sampler_stop(lua_State *L)
+{
+	NO_MAP_LOCK_REQUIRED;
+	LuaSampler &sampler = getScriptApiBase(L)->getSampler();
+	sampler.stop();
+	lua_pushinteger(L, sampler.getSampleCount());
+	return 1;
+}
+
+// lua_sampler_clear()
+int ModApiServer::l_lua_sampler_clear(lua_State *L)
+{
+	NO_MAP_LOCK_REQUIRED;
+	getScriptApiBase(L)->getSampler().clear();
+	return 0;
+}
+
+// lua_sampler_save(format) -> path or nil
+int ModApiServer::l_lua_sampler_save(lua_State *L)
+{
+	NO_MAP_LOCK_REQUIRED;
+	std::string path = getServer(L)->saveLuaProfile(luaL_checkstring(L, 1));
+	if (path.empty())
+		return 0;
+	lua_pushstring(L, path.c_str());
+	return 1;
+}
+
 // get_mod_data_path()
 int ModApiServer::l_get_mod_data_path(lua_State *L)
 {
@@ -625,7 +667,7 @@ int ModApiServer::l_notify_authentication_modified(lua_State *L)
 	return 0;
 }
 
-// do_async_callback(func, params, mod_origin)
+// do_async_callback(func, params, mod_origin, [priority])
 int ModApiServer::l_do_async_callback(lua_State *L)
 {
 	NO_MAP_LOCK_REQUIRED;
@@ -642,16 +684,28 @@ int ModApiServer::l_do_async_callback(lua_State *L)
 	PackedValue *param = script_pack(L, 2);
 
 	std::string mod_origin = readParam<std::string>(L, 3);
+	int priority = luaL_optinteger(L, 4, ASYNC_PRIORITY_NORMAL);
+	priority = rangelim(priority, 0, ASYNC_PRIORITY_COUNT - 1);
 
 	u32 jobId = script->queueAsync(
 		std::string(serialized_func_raw, func_length),
-		param, mod_origin);
+		param, mod_origin, (AsyncJobPriority)priority);
 
 	lua_settop(L, 0);
 	lua_pushinteger(L, jobId);
 	return 1;
 }
 
+// cancel_async_callback(jobid)
+int ModApiServer::l_cancel_async_callback(lua_State *L)
+{
+	NO_MAP_LOCK_REQUIRED;
+	ServerScripting *script = getScriptApi<ServerScripting>(L);
+
+	lua_pushboolean(L, script->cancelAsync(luaL_checkinteger(L, 1)));
+	return 1;
+}
+
 // register_async_dofile(path)
 int ModApiServer::l_register_async_dofile(lua_State *L)
 {
@@ -718,6 +772,10 @@ void ModApiServer::Initialize(lua_State *L, int top)
 	API_FCT(get_server_max_lag);
 	API_FCT(get_mod_data_path);
 	API_FCT(get_worldpath);
+	API_FCT(lua_sampler_start);
+	API_FCT(lua_sampler_stop);
+	API_FCT(lua_sampler_clear);
+	API_FCT(lua_sampler_save);
 	API_FCT(is_singleplayer);
 
 	API_FCT(get_current_modname);
@@ -748,6 +806,7 @@ void ModApiServer::Initialize(lua_State *L, int top)
 	API_FCT(notify_authentication_modified);
 
 	API_FCT(do_async_callback);
+	API_FCT(cancel_async_callback);
 	API_FCT(register_async_dofile);
 	API_FCT(serialize_roundtrip);
 
@@ -24,6 +24,18 @@ class ModApiServer : public ModApiBase
 	// get_worldpath()
 	static int l_get_worldpath(lua_State *L);
 
+	// lua_sampler_start([interval_us])
+	static int l_lua_sampler_start(lua_State *L);
+
+	// lua_sampler_stop()
+	static int l_lua_sampler_stop(lua_State *L);
+
+	// lua_sampler_clear()
+	static int l_lua_sampler_clear(lua_State *L);
+
+	// lua_sampler_save(format)
+	static int l_lua_sampler_save(lua_State *L);
+
 	// get_mod_data_path()
 	static int l_get_mod_data_path(lua_State *L);
 
@@ -100,9 +112,12 @@ class ModApiServer : public ModApiBase
 	// notify_authentication_modified(name)
 	static int l_notify_authentication_modified(lua_State *L);
 
-	// do_async_callback(func, params, mod_origin)
+	// do_async_callback(func, params, mod_origin, [priority])
 	static int l_do_async_callback(lua_State *L);
 
+	// cancel_async_callback(jobid)
+	static int l_cancel_async_callback(lua_State *L);
+
 	// register_async_dofile(path)
 	static int l_register_async_dofile(lua_State *L);
 
@@ -0,0 +1,269 @@
+// Luanti
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (C) 2024 Luanti Authors
+
+#include "lua_api/l_shareddata.h"
+#include "lua_api/l_internal.h"
+#include "common/c_converter.h"
+#include "common/c_content.h"
+#include "common/c_packer.h"
+#include "serverenvironment.h"
+#include "map.h"
+#include <algorithm>
+
+///////////////////////////////////////
+/*
+  LuaSharedBuffer
+*/
+
+LuaSharedBuffer::LuaSharedBuffer(std::shared_ptr<const Data> data) :
+	data(std::move(data))
+{
+}
+
+int LuaSharedBuffer::gc_object(lua_State *L)
+{
+	LuaSharedBuffer *o = *(LuaSharedBuffer **)(lua_touserdata(L, 1));
+	delete o;
+	return 0;
+}
+
+int LuaSharedBuffer::mt_len(lua_State *L)
+{
+	NO_MAP_LOCK_REQUIRED;
+	LuaSharedBuffer *o = checkObject<LuaSharedBuffer>(L, 1);
+	lua_pushinteger(L, o->data->size());
+	return 1;
+}
+
+// size(self)
+int LuaSharedBuffer::l_size(lua_State *L)
+{
+	return mt_len(L);
+}
+
+// get(self, index)
+int LuaSharedBuffer::l_get(lua_State *L)
+{
+	NO_MAP_LOCK_REQUIRED;
+	LuaSharedBuffer *o = checkObject<LuaSharedBuffer>(L, 1);
+	lua_Integer i = luaL_checkinteger(L, 2);
+
+	if (i < 1 || i > (lua_Integer)o->data->size())
+		return 0;
+	lua_pushnumber(L, (*o->data)[i - 1]);
+	return 1;
+}
+
+// to_table(self, [first, last, buffer])
+int LuaSharedBuffer::l_to_table(lua_State *L)
+{
+	NO_MAP_LOCK_REQUIRED;
+	LuaSharedBuffer *o = checkObject<LuaSharedBuffer>(L, 1);
+	const Data &data = *o->data;
+
+	lua_Integer first = luaL_optinteger(L, 2, 1);
+	lua_Integer last = luaL_optinteger(L, 3, data.size());
+	first = std::max<lua_Integer>(first, 1);
+	last = std::min<lua_Integer>(last, data.size());
+	const int count = last >= first ? last - first + 1 : 0;
+
+	if (lua_istable(L, 4))
+		lua_pushvalue(L, 4);
+	else
+		lua_createtable(L, count, 0);
+
+	for (int i = 0; i < count; i++) {
+		lua_pushnumber(L, data[first - 1 + i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+	return 1;
+}
+
+int LuaSharedBuffer::create_object(lua_State *L)
+{
+	NO_MAP_LOCK_REQUIRED;
+	luaL_checktype(L, 1, LUA_TTABLE);
+
+	const size_t count = lua_objlen(L, 1);
+	auto data = std::make_shared<Data>();
+	data->reserve(count);
+	for (size_t i = 1; i <= count; i++) {
+		lua_rawgeti(L, 1, i);
+		if (!lua_isnumber(L, -1))
+			throw LuaError("SharedBuffer: element " + std::to_string(i) +
+				" is not a number");
+		data->push_back(lua_tonumber(L, -1));
+		lua_pop(L, 1);
+	}
+
+	create(L, std::move(data));
+	return 1;
+}
+
+void LuaSharedBuffer::create(lua_State *L, std::shared_ptr<const Data> data)
+{
+	LuaSharedBuffer *o = new LuaSharedBuffer(std::move(data));
+	*(void **)(lua_newuserdata(L, sizeof(void *))) = o;
+	luaL_getmetatable(L, className);
+	lua_setmetatable(L, -2);
+}
+
+void *LuaSharedBuffer::packIn(lua_State *L, int idx)
+{
+	LuaSharedBuffer *o = checkObject<LuaSharedBuffer>(L, idx);
+	// Only the reference is copied
+	return new std::shared_ptr<const Data>(o->data);
+}
+
+void LuaSharedBuffer::packOut(lua_State *L, void *ptr)
+{
+	auto *data = reinterpret_cast<std::shared_ptr<const Data> *>(ptr);
+	if (L)
+		create(L, std::move(*data));
+	delete data;
+}
+
+void LuaSharedBuffer::Register(lua_State *L)
+{
+	static const luaL_Reg metamethods[] = {
+		{"__len", mt_len},
+		{"__gc", gc_object},
+		{0, 0}
+	};
+	registerClass(L, className, methods, metamethods);
+
+	lua_register(L, className, create_object);
+
+	script_register_packer(L, className, packIn, packOut);
+}
+
+const char LuaSharedBuffer::className[] = "SharedBuffer";
+const luaL_Reg LuaSharedBuffer::methods[] = {
+	luamethod(LuaSharedBuffer, size),
+	luamethod(LuaSharedBuffer, get),
+	luamethod(LuaSharedBuffer, to_table),
+	{0,0}
+};
+
+///////////////////////////////////////
+/*
+  LuaMapSnapshot
+*/
+
+LuaMapSnapshot::LuaMapSnapshot(std::shared_ptr<const MMVManip> vm) :
+	vm(std::move(vm))
+{
+}
+
+int LuaMapSnapshot::gc_object(lua_State *L)
+{
+	LuaMapSnapshot *o = *(LuaMapSnapshot **)(lua_touserdata(L, 1));
+	delete o;
+	return 0;
+}
+
+// get_node(self, pos)
+int LuaMapSnapshot::l_get_node(lua_State *L)
+{
+	NO_MAP_LOCK_REQUIRED;
+	LuaMapSnapshot *o = checkObject<LuaMapSnapshot>(L, 1);
+	v3s16 pos = check_v3s16(L, 2);
+
+	pushnode(L, o->vm->getNodeNoExNoEmerge(pos));
+	return 1;
+}
+
+// get_content_id(self, pos)
+int LuaMapSnapshot::l_get_content_id(lua_State *L)
+{
+	NO_MAP_LOCK_REQUIRED;
+	LuaMapSnapshot *o = checkObject<LuaMapSnapshot>(L, 1);
+	v3s16 pos = check_v3s16(L, 2);
+
+	lua_pushinteger(L, o->vm->getNodeNoExNoEmerge(pos).getContent());
+	return 1;
+}
+
+// get_area(self) -> minp, maxp
+int LuaMapSnapshot::l_get_area(lua_State *L)
+{
+	NO_MAP_LOCK_REQUIRED;
+	LuaMapSnapshot *o = checkObject<LuaMapSnapshot>(L, 1);
+
+	push_v3s16(L, o->vm->m_area.MinEdge);
+	push_v3s16(L, o->vm->m_area.MaxEdge);
+	return 2;
+}
+
+int LuaMapSnapshot::create_object(lua_State *L)
+{
+	MAP_LOCK_REQUIRED;
+
+	// The async and mapgen environments have no map to copy from
+	ServerEnvironment *env = (ServerEnvironment *)getEnv(L);
+	if (!env)
+		throw LuaError("MapSnapshot can only be created in the server environment");
+
+	v3s16 bp1 = getNodeBlockPos(check_v3s16(L, 1));
+	v3s16 bp2 = getNodeBlockPos(check_v3s16(L, 2));
+	sortBoxVerticies(bp1, bp2);
+
+	// Same limit as for the other area functions, applied to the whole
+	// blocks that are copied
+	VoxelArea area(bp1 * MAP_BLOCKSIZE, (bp2 + 1) * MAP_BLOCKSIZE - v3s16(1, 1, 1));
+	if (area.getVolume() > 4096000)
+		throw LuaError("MapSnapshot area volume exceeds allowed value of 4096000");
+
+	auto vm = std::make_shared<MMVManip>(&env->getMap());
+	vm->initialEmerge(bp1, bp2);
+
+	// Only the const methods are reachable from here on, so the map is not
+	// accessed again even if the snapshot outlives it in an async worker.
+	create(L, std::move(vm));
+	return 1;
+}
+
+void LuaMapSnapshot::create(lua_State *L, std::shared_ptr<const MMVManip> vm)
+{
+	LuaMapSnapshot *o = new LuaMapSnapshot(std::move(vm));
+	*(void **)(lua_newuserdata(L, sizeof(void *))) = o;
+	luaL_getmetatable(L, className);
+	lua_setmetatable(L, -2);
+}
+
+void *LuaMapSnapshot::packIn(lua_State *L, int idx)
+{
+	LuaMapSnapshot *o = checkObject<LuaMapSnapshot>(L, idx);
+	// Only the reference is copied
+	return new std::shared_ptr<const MMVManip>(o->vm);
+}
+
+void LuaMapSnapshot::packOut(lua_State *L, void *ptr)
+{
+	auto *vm = reinterpret_cast<std::shared_ptr<const MMVManip> *>(ptr);
+	if (L)
+		create(L, std::move(*vm));
+	delete vm;
+}
+
+void LuaMapSnapshot::Register(lua_State *L)
+{
+	static const luaL_Reg metamethods[] = {
+		{"__gc", gc_object},
+		{0, 0}
+	};
+	registerClass(L, className, methods, metamethods);
+
+	lua_register(L, className, create_object);
+
+	script_register_packer(L, className, packIn, packOut);
+}
+
+const char LuaMapSnapshot::className[] = "MapSnapshot";
+const luaL_Reg LuaMapSnapshot::methods[] = {
+	luamethod(LuaMapSnapshot, get_node),
+	luamethod(LuaMapSnapshot, get_content_id),
+	luamethod(LuaMapSnapshot, get_area),
+	{0,0}
+};
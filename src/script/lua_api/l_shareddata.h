@@ -0,0 +1,92 @@
+// Luanti
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (C) 2024 Luanti Authors
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "irr_v3d.h"
+#include "lua_api/l_base.h"
+
+class MMVManip;
+
+/*
+	Immutable data that is shared between Lua states instead of being copied
+	when passed to or returned from async jobs.
+*/
+
+/*
+	LuaSharedBuffer
+*/
+class LuaSharedBuffer : public ModApiBase
+{
+public:
+	typedef std::vector<lua_Number> Data;
+
+private:
+	std::shared_ptr<const Data> data;
+
+	static const luaL_Reg methods[];
+
+	// garbage collector
+	static int gc_object(lua_State *L);
+	// #buffer
+	static int mt_len(lua_State *L);
+
+	static int l_size(lua_State *L);
+	static int l_get(lua_State *L);
+	static int l_to_table(lua_State *L);
+
+public:
+	LuaSharedBuffer(std::shared_ptr<const Data> data);
+	~LuaSharedBuffer() = default;
+
+	// SharedBuffer(list)
+	// Creates a LuaSharedBuffer and leaves it on top of stack
+	static int create_object(lua_State *L);
+	// Not callable from Lua
+	static void create(lua_State *L, std::shared_ptr<const Data> data);
+
+	static void *packIn(lua_State *L, int idx);
+	static void packOut(lua_State *L, void *ptr);
+
+	static void Register(lua_State *L);
+
+	static const char className[];
+};
+
+/*
+	LuaMapSnapshot
+*/
+class LuaMapSnapshot : public ModApiBase
+{
+private:
+	std::shared_ptr<const MMVManip> vm;
+
+	static const luaL_Reg methods[];
+
+	// garbage collector
+	static int gc_object(lua_State *L);
+
+	static int l_get_node(lua_State *L);
+	static int l_get_content_id(lua_State *L);
+	static int l_get_area(lua_State *L);
+
+public:
+	LuaMapSnapshot(std::shared_ptr<const MMVManip> vm);
+	~LuaMapSnapshot() = default;
+
+	// MapSnapshot(p1, p2)
+	// Copies the area from the map and leaves the snapshot on top of stack
+	static int create_object(lua_State *L);
+	// Not callable from Lua
+	static void create(lua_State *L, std::shared_ptr<const MMVManip> vm);
+
+	static void *packIn(lua_State *L, int idx);
+	static void packOut(lua_State *L, void *ptr);
+
+	static void Register(lua_State *L);
+
+	static const char className[];
+};
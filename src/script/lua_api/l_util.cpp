@@ -640,7 +640,7 @@ int ModApiUtil::l_time_to_day_night_ratio(lua_State *L)
 	NO_MAP_LOCK_REQUIRED;
 
 	float time_of_day = lua_tonumber(L, 1) * 24000;
-	u32 dnr = time_to_daynight_ratio(time_of_day, true);
+	u32 dnr = time_to_daynight_ratio(time_of_day);
 	lua_pushnumber(L, dnr / 1000.0f);
 	return 1;
 }
@@ -20,6 +20,7 @@
 #include "lua_api/l_util.h"
 #include "lua_api/l_vmanip.h"
 #include "lua_api/l_settings.h"
+#include "lua_api/l_shareddata.h"
 #include "lua_api/l_ipc.h"
 
 extern "C" {
@@ -67,6 +68,8 @@ void EmergeScripting::InitializeModApi(lua_State *L, int top)
 	LuaSecureRandom::Register(L);
 	LuaVoxelManip::Register(L);
 	LuaSettings::Register(L);
+	LuaSharedBuffer::Register(L);
+	LuaMapSnapshot::Register(L);
 
 	// Initialize mod api modules
 	ModApiCraft::InitializeAsync(L, top);
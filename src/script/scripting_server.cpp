@@ -29,6 +29,7 @@
 #include "lua_api/l_util.h"
 #include "lua_api/l_vmanip.h"
 #include "lua_api/l_settings.h"
+#include "lua_api/l_shareddata.h"
 #include "lua_api/l_http.h"
 #include "lua_api/l_storage.h"
 #include "lua_api/l_ipc.h"
@@ -60,6 +61,8 @@ ServerScripting::ServerScripting(Server* server):
 	int top = lua_gettop(L);
 
 	lua_newtable(L);
+	lua_pushvalue(L, -1);
+	lua_rawseti(L, LUA_REGISTRYINDEX, CUSTOM_RIDX_OBJECT_REFS);
 	lua_setfield(L, -2, "object_refs");
 
 	lua_newtable(L);
@@ -99,7 +102,7 @@ void ServerScripting::saveGlobals()
 	lua_pop(L, 2); // pop 'core', return value
 }
 
-void ServerScripting::initAsync()
+void ServerScripting::initAsync(MetricsBackend *metrics)
 {
 	infostream << "SCRIPTAPI: Initializing async engine" << std::endl;
 	asyncEngine.registerStateInitializer(InitializeAsync);
@@ -112,6 +115,7 @@ void ServerScripting::initAsync()
 	// not added: ModApiHttp async api can't really work together with our jobs
 	// not added: ModApiStorage is probably not thread safe(?)
 
+	asyncEngine.setMetricsBackend(metrics);
 	asyncEngine.initialize(0);
 }
 
@@ -121,10 +125,16 @@ void ServerScripting::stepAsync()
 }
 
 u32 ServerScripting::queueAsync(std::string &&serialized_func,
-	PackedValue *param, const std::string &mod_origin)
+	PackedValue *param, const std::string &mod_origin,
+	AsyncJobPriority priority)
 {
 	return asyncEngine.queueAsyncJob(std::move(serialized_func),
-			param, mod_origin);
+			param, mod_origin, priority);
+}
+
+bool ServerScripting::cancelAsync(u32 id)
+{
+	return asyncEngine.cancelAsyncJob(id);
 }
 
 void ServerScripting::InitializeModApi(lua_State *L, int top)
@@ -146,6 +156,8 @@ void ServerScripting::InitializeModApi(lua_State *L, int top)
 	ObjectRef::Register(L);
 	PlayerMetaRef::Register(L);
 	LuaSettings::Register(L);
+	LuaSharedBuffer::Register(L);
+	LuaMapSnapshot::Register(L);
 	StorageRef::Register(L);
 	ModChannelRef::Register(L);
 
@@ -179,6 +191,8 @@ void ServerScripting::InitializeAsync(lua_State *L, int top)
 	LuaSecureRandom::Register(L);
 	LuaVoxelManip::Register(L);
 	LuaSettings::Register(L);
+	LuaSharedBuffer::Register(L);
+	LuaMapSnapshot::Register(L);
 
 	// globals data
 	auto *data = ModApiBase::getServer(L)->m_lua_globals_data.get();
@@ -41,14 +41,18 @@ class ServerScripting:
 	void saveGlobals();
 
 	// Initialize async engine, call this AFTER loading all mods
-	void initAsync();
+	void initAsync(MetricsBackend *metrics = nullptr);
 
 	// Global step handler to collect async results
 	void stepAsync();
 
 	// Pass job to async threads
 	u32 queueAsync(std::string &&serialized_func,
-		PackedValue *param, const std::string &mod_origin);
+		PackedValue *param, const std::string &mod_origin,
+		AsyncJobPriority priority = ASYNC_PRIORITY_NORMAL);
+
+	// Remove a job that has not started yet
+	bool cancelAsync(u32 id);
 
 private:
 	void InitializeModApi(lua_State *L, int top);
@@ -25,6 +25,7 @@
 #include "profiler.h"
 #include "log.h"
 #include "scripting_server.h"
+#include "script/common/c_sampler.h"
 #include "nodedef.h"
 #include "itemdef.h"
 #include "craftdef.h"
@@ -59,6 +60,7 @@
 #include "database/database-files.h"
 #include "database/database-dummy.h"
 #include "gameparams.h"
+#include "gettime.h"
 #include "particles.h"
 #include "gettext.h"
 #include "util/tracy_wrapper.h"
@@ -323,6 +325,18 @@ Server::Server(
 			"minetest_core_map_edit_events",
 			"Number of map edit events");
 
+	m_lua_heap_gauge = m_metrics_backend->addGauge(
+			"minetest_core_lua_heap_size",
+			"Size of the server Lua heap (in bytes)");
+
+	m_lua_gc_cycles_counter = m_metrics_backend->addCounter(
+			"minetest_core_lua_gc_cycles",
+			"Lua garbage collection cycles finished");
+
+	m_lua_gc_idle_time_counter = m_metrics_backend->addCounter(
+			"minetest_core_lua_gc_idle_time",
+			"Time spent collecting Lua garbage between server steps (in seconds)");
+
 	m_lag_gauge->set(g_settings->getFloat("dedicated_server_step"));
 
 	m_path_mod_data = porting::path_user + DIR_DELIM "mod_data";
@@ -389,6 +403,15 @@ Server::~Server()
 		infostream << "Server: Saving environment metadata" << std::endl;
 		m_env->saveMeta();
 
+		if (m_profile_lua) {
+			m_script->getSampler().stop();
+			for (const char *format : {"folded", "trace"}) {
+				std::string path = saveLuaProfile(format);
+				if (!path.empty())
+					actionstream << "Lua profile saved to " << path << std::endl;
+			}
+		}
+
 		// Delete classes that depend on the environment
 		m_inventory_mgr.reset();
 		m_script.reset();
@@ -478,6 +501,8 @@ void Server::init()
 	infostream << "Server: Initializing Lua" << std::endl;
 
 	m_script = std::make_unique<ServerScripting>(this);
+	if (m_profile_lua)
+		m_script->startSampler(g_settings->getU32("profiler.sampling_interval"));
 
 	// Must be created before mod loading because we have some inventory creation
 	m_inventory_mgr = std::make_unique<ServerInventoryManager>();
@@ -539,7 +564,7 @@ void Server::init()
 	m_script->initializeEnvironment(m_env);
 
 	// Do this after regular script init is done
-	m_script->initAsync();
+	m_script->initAsync(m_metrics_backend.get());
 
 	// Register us to receive map edit events
 	servermap.addEventReceiver(this);
@@ -549,6 +574,7 @@ void Server::init()
 	// Those settings can be overwritten in world.mt, they are
 	// intended to be cached after environment loading.
 	m_liquid_transform_every = g_settings->getFloat("liquid_update");
+	m_lua_gc_idle_time = g_settings->getFloat("lua_gc_idle_time");
 	m_max_chatmessage_length = g_settings->getU16("chat_message_max_size");
 	m_csm_restriction_flags = g_settings->getU64("csm_restriction_flags");
 	m_csm_restriction_noderange = g_settings->getU32("csm_restriction_noderange");
@@ -623,6 +649,7 @@ void Server::AsyncRunStep(float dtime, bool initial_step)
 {
 	ZoneScoped;
 	auto framemarker = FrameMarker("Server::AsyncRunStep()-frame").started();
+	const u64 step_start = porting::getTimeUs();
 
 	{
 		// Send blocks to clients
@@ -1067,6 +1094,26 @@ void Server::AsyncRunStep(float dtime, bool initial_step)
 		}
 	}
 
+	/*
+		Collect Lua garbage in the time left of this step, so that less of
+		it has to be done while running the next one.
+	*/
+	{
+		const s64 remaining = getStepSettings().steplen * 1e6f -
+				(porting::getTimeUs() - step_start);
+		const s64 budget = std::min<s64>(m_lua_gc_idle_time * 1000.0f, remaining);
+		EnvAutoLock lock(this);
+		if (budget > 0) {
+			u64 spent = m_script->stepGC(budget);
+			m_lua_gc_idle_time_counter->increment(spent * 1e-6);
+		}
+
+		m_lua_heap_gauge->set(m_script->getHeapSize());
+		u32 cycles = m_script->getGCCycles();
+		m_lua_gc_cycles_counter->increment(cycles - m_lua_gc_cycles_reported);
+		m_lua_gc_cycles_reported = cycles;
+	}
+
 	m_shutdown_state.tick(dtime, this);
 }
 
@@ -3867,6 +3914,42 @@ void Server::addShutdownError(const ModError &e)
 	}
 }
 
+std::string Server::saveLuaProfile(const std::string &format)
+{
+	LuaSampler &sampler = m_script->getSampler();
+	std::ostringstream os(std::ios::binary);
+	std::string extension;
+	if (format == "folded") {
+		sampler.writeCollapsed(os);
+		extension = "folded";
+	} else if (format == "trace") {
+		sampler.writeChromeTrace(os);
+		extension = "json";
+	} else {
+		return "";
+	}
+
+	std::string dir = m_path_world;
+	const std::string report_path = g_settings->get("profiler.report_path");
+	if (!report_path.empty()) {
+		dir += DIR_DELIM + report_path;
+		fs::CreateAllDirs(dir);
+	}
+
+	const struct tm tm = mt_localtime();
+	char timestamp[16];
+	strftime(timestamp, sizeof(timestamp), "%Y%m%dT%H%M%S", &tm);
+
+	// Don't overwrite profiles saved within the same second
+	std::string base = dir + DIR_DELIM "lua-profile-" + timestamp;
+	std::string path = base + "." + extension;
+	for (u32 i = 1; fs::PathExists(path); i++)
+		path = base + "-" + std::to_string(i) + "." + extension;
+	if (!fs::safeWriteToFile(path, os.str()))
+		return "";
+	return path;
+}
+
 v3f Server::findSpawnPos()
 {
 	ServerMap &map = m_env->getServerMap();
@@ -335,6 +335,14 @@ class Server : public con::PeerHandler, public MapEventReceiver,
 	inline bool isSingleplayer() const
 			{ return m_simple_singleplayer_mode; }
 
+	// Samples the Lua code from startup until shutdown, when the profile is
+	// saved into the world directory. Must be called before start().
+	void setProfileLua(bool enable) { m_profile_lua = enable; }
+	// Writes the samples of the Lua sampling profiler into the world directory.
+	// format: "folded" (collapsed stacks) or "trace" (Chrome trace events)
+	// Returns the path of the written file or "" on failure.
+	std::string saveLuaProfile(const std::string &format);
+
 	struct StepSettings {
 		float steplen;
 		bool pause;
@@ -644,6 +652,8 @@ class Server : public con::PeerHandler, public MapEventReceiver,
 	// If true, do not allow multiple players and hide some multiplayer
 	// functionality
 	bool m_simple_singleplayer_mode;
+	// Lua sampling profiler runs for the whole lifetime of the server
+	bool m_profile_lua = false;
 	u16 m_max_chatmessage_length;
 	// For "dedicated" server list flag
 	bool m_dedicated;
@@ -782,6 +792,12 @@ class Server : public con::PeerHandler, public MapEventReceiver,
 	MetricCounterPtr m_packet_recv_counter;
 	MetricCounterPtr m_packet_recv_processed_counter;
 	MetricCounterPtr m_map_edit_event_counter;
+	MetricGaugePtr m_lua_heap_gauge;
+	MetricCounterPtr m_lua_gc_cycles_counter;
+	MetricCounterPtr m_lua_gc_idle_time_counter;
+	u32 m_lua_gc_cycles_reported = 0;
+	// Time in ms that Lua garbage collection may take at the end of a step
+	float m_lua_gc_idle_time = 0.0f;
 };
 
 /*
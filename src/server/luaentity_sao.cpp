@@ -119,6 +119,21 @@ void LuaEntitySAO::dispatchScriptDeactivate(bool removal)
 
 void LuaEntitySAO::step(float dtime, bool send_recommended)
 {
+	collisionMoveResult moveresult;
+	bool physical = stepBeforeScript(dtime, moveresult);
+
+	if (m_registered) {
+		m_env->getScriptIface()->luaentity_Step(m_id, dtime,
+				physical ? &moveresult : nullptr);
+	}
+
+	stepAfterScript(send_recommended);
+}
+
+bool LuaEntitySAO::stepBeforeScript(float dtime, collisionMoveResult &moveresult)
+{
+	bool physical = false;
+
 	if (!m_properties_sent) {
 		m_properties_sent = true;
 		std::string str = getPropertyPacket();
@@ -142,8 +157,6 @@ void LuaEntitySAO::step(float dtime, bool send_recommended)
 
 	m_last_sent_position_timer += dtime;
 
-	collisionMoveResult moveresult, *moveresult_p = nullptr;
-
 	// Each frame, parent position is copied if the object is attached, otherwise it's calculated normally
 	// If the object gets detached this comes into effect automatically from the last known origin
 	if (auto *parent = getParent()) {
@@ -163,7 +176,7 @@ void LuaEntitySAO::step(float dtime, bool send_recommended)
 					pos_max_d, box, m_prop.stepheight, dtime,
 					&p_pos, &p_velocity, p_acceleration,
 					this, m_prop.collideWithObjects);
-			moveresult_p = &moveresult;
+			physical = true;
 
 			// Apply results
 			m_base_position = p_pos;
@@ -197,10 +210,11 @@ void LuaEntitySAO::step(float dtime, bool send_recommended)
 				m_prop.automatic_rotate);
 	}
 
-	if(m_registered) {
-		m_env->getScriptIface()->luaentity_Step(m_id, dtime, moveresult_p);
-	}
+	return physical;
+}
 
+void LuaEntitySAO::stepAfterScript(bool send_recommended)
+{
 	if (!send_recommended)
 		return;
 
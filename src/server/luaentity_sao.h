@@ -7,6 +7,8 @@
 
 #include "unit_sao.h"
 
+struct collisionMoveResult;
+
 class LuaEntitySAO : public UnitSAO
 {
 public:
@@ -26,6 +28,15 @@ class LuaEntitySAO : public UnitSAO
 	ActiveObjectType getSendType() const { return ACTIVEOBJECT_TYPE_GENERIC; }
 	virtual void addedToEnvironment(u32 dtime_s);
 	void step(float dtime, bool send_recommended);
+	/*
+		step() split in two, so that the environment can run the on_step
+		callbacks of all entities in one go in between.
+		stepBeforeScript() returns false if the entity was not moved physically,
+		i.e. on_step gets no moveresult.
+	*/
+	bool stepBeforeScript(float dtime, collisionMoveResult &moveresult);
+	void stepAfterScript(bool send_recommended);
+	bool isRegistered() const { return m_registered; }
 	std::string getClientInitializationData(u16 protocol_version);
 
 	bool isStaticAllowed() const { return m_prop.static_save; }
@@ -1616,11 +1616,25 @@ void ServerEnvironment::step(float dtime)
 
 		u32 object_count = 0;
 
+		// The on_step callbacks of Lua entities are run all at once after
+		// the other parts of their step, saving a call into Lua per entity.
+		m_entity_steps.clear();
+
 		auto cb_state = [&](ServerActiveObject *obj) {
 			if (obj->isGone())
 				return;
 			object_count++;
 
+			if (obj->getType() == ACTIVEOBJECT_TYPE_LUAENTITY) {
+				auto *entity = static_cast<LuaEntitySAO *>(obj);
+				if (entity->isRegistered()) {
+					EntityStep &step = m_entity_steps.emplace_back();
+					step.id = entity->getId();
+					step.physical = entity->stepBeforeScript(dtime, step.moveresult);
+					return;
+				}
+			}
+
 			// Step object
 			obj->step(dtime, send_recommended);
 			// Read messages from object
@@ -1628,6 +1642,24 @@ void ServerEnvironment::step(float dtime)
 		};
 		m_ao_manager.step(dtime, cb_state);
 
+		m_entity_step_args.clear();
+		for (const EntityStep &step : m_entity_steps) {
+			m_entity_step_args.emplace_back(step.id,
+					step.physical ? &step.moveresult : nullptr);
+		}
+		m_script->luaentity_StepBatch(dtime, m_entity_step_args);
+
+		for (const EntityStep &step : m_entity_steps) {
+			// The callbacks may have removed it, e.g. by clearing all objects
+			ServerActiveObject *obj = m_ao_manager.getActiveObject(step.id);
+			if (!obj || obj->isGone() ||
+					obj->getType() != ACTIVEOBJECT_TYPE_LUAENTITY)
+				continue;
+			auto *entity = static_cast<LuaEntitySAO *>(obj);
+			entity->stepAfterScript(send_recommended);
+			entity->dumpAOMessagesToQueue(m_active_object_messages);
+		}
+
 		m_active_object_gauge->set(object_count);
 	}
 
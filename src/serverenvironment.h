@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "activeobject.h"
+#include "collision.h"
 #include "environment.h"
 #include "servermap.h"
 #include "settings.h"
@@ -21,6 +22,7 @@ class RemotePlayer;
 class PlayerDatabase;
 class AuthDatabase;
 class PlayerSAO;
+class LuaEntitySAO;
 class ServerEnvironment;
 class ActiveBlockModifier;
 struct StaticObject;
@@ -466,6 +468,15 @@ class ServerEnvironment final : public Environment
 	OnMapblocksChangedReceiver m_on_mapblocks_changed_receiver;
 	// Outgoing network message buffer for active objects
 	std::queue<ActiveObjectMessage> m_active_object_messages;
+	// Lua entities whose on_step is run by the current step(), reused.
+	// Only the id is kept since on_step may delete any object.
+	struct EntityStep {
+		u16 id;
+		bool physical;
+		collisionMoveResult moveresult;
+	};
+	std::vector<EntityStep> m_entity_steps;
+	std::vector<std::pair<u16, const collisionMoveResult *>> m_entity_step_args;
 	// Some timers
 	float m_send_recommended_timer = 0.0f;
 	IntervalLimiter m_object_management_interval;
@@ -828,6 +828,8 @@ fake_function() {
 	gettext("The default format in which profiles are being saved,\nwhen calling `/profiler save [format]` without format.");
 	gettext("Report path");
 	gettext("The file path relative to your world path in which profiles will be saved to.");
+	gettext("Lua sampling interval");
+	gettext("Time between two samples of the Lua sampling profiler, in microseconds.\nThe sampling profiler is controlled with the /lua_profiler chat command\nand works without loading the game profiler.");
 	gettext("Entity methods");
 	gettext("Instrument the methods of entities on registration.");
 	gettext("Active Block Modifiers");
@@ -995,6 +997,12 @@ fake_function() {
 	gettext("If enabled, the server will perform map block occlusion culling based on\non the eye position of the player. This can reduce the number of blocks\nsent to the client by 50-80%. Clients will no longer receive most\ninvisible blocks, so that the utility of noclip mode is reduced.");
 	gettext("Block cull optimize distance");
 	gettext("At this distance the server will perform a simpler and cheaper occlusion check.\nSmaller values potentially improve performance, at the expense of temporarily visible\nrendering glitches (missing blocks).\nThis is especially useful for very large viewing range (upwards of 500).\nStated in MapBlocks (16 nodes).");
+	gettext("Lua GC pause");
+	gettext("How much the Lua heap has to grow after a garbage collection cycle before\nthe next one is started, in percent. Lower values use less memory, but\nspend more time collecting garbage.\nApplies to all Lua environments (server, async, mapgen and client).");
+	gettext("Lua GC step multiplier");
+	gettext("Speed of the Lua garbage collector relative to memory allocation, in percent.\nHigher values make collection cycles shorter but each step longer.\nApplies to all Lua environments (server, async, mapgen and client).");
+	gettext("Lua GC idle time");
+	gettext("Maximum time the server spends on Lua garbage collection at the end of\neach server step if there is time left, stated in milliseconds.\nCollecting garbage there reduces the lag spikes caused by it during\nthe following steps. 0 disables this.");
 	gettext("Mapgen");
 	gettext("Chunk size");
 	gettext("Size of mapchunks generated by mapgen, stated in mapblocks (16 nodes).\nWARNING: There is no benefit, and there are several dangers, in\nincreasing this value above 5.\nReducing this value increases cave and dungeon density.\nAltering this value is for special usage, leaving it unchanged is\nrecommended.");
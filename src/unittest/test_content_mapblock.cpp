@@ -12,6 +12,7 @@
 #include "client/content_mapblock.h"
 #include "client/mapblock_mesh.h"
 #include "client/meshgen/collector.h"
+#include "mapblock.h"
 #include "mesh_compare.h"
 #include "util/directiontables.h"
 
@@ -36,14 +37,19 @@ class MockGameDef : public DummyGameDef {
 		node_mgr()->resolveCrossrefs();
 	}
 
-	MeshMakeData makeSingleNodeMMD(bool smooth_lighting = true, bool for_shaders = true)
+	MeshMakeData makeSingleNodeMMD(bool smooth_lighting = true)
 	{
-		MeshMakeData data{ndef(), 1, for_shaders};
+		return makeMMD(1, smooth_lighting);
+	}
+
+	MeshMakeData makeMMD(u16 side_length, bool smooth_lighting = true)
+	{
+		MeshMakeData data{ndef(), side_length};
 		data.setSmoothLighting(smooth_lighting);
 		data.m_blockpos = {0, 0, 0};
-		for (s16 x = -1; x <= 1; x++)
-		for (s16 y = -1; y <= 1; y++)
-		for (s16 z = -1; z <= 1; z++)
+		for (s16 x = -1; x <= side_length; x++)
+		for (s16 y = -1; y <= side_length; y++)
+		for (s16 z = -1; z <= side_length; z++)
 			data.m_vmanip.setNode({x, y, z}, {CONTENT_AIR, 0, 0});
 		return data;
 	}
@@ -142,6 +148,9 @@ class TestMapblockMeshGenerator : public TestBase {
 	void testSurroundedNode();
 	void testInterliquidSame();
 	void testInterliquidDifferent();
+	void testMergedFaces();
+	void testFillBlockData();
+	void testGenerateLod();
 };
 
 static TestMapblockMeshGenerator g_test_instance;
@@ -153,6 +162,9 @@ void TestMapblockMeshGenerator::runTests(IGameDef *gamedef)
 	TEST(testSurroundedNode);
 	TEST(testInterliquidSame);
 	TEST(testInterliquidDifferent);
+	TEST(testMergedFaces);
+	TEST(testFillBlockData);
+	TEST(testGenerateLod);
 }
 
 namespace quad {
@@ -163,6 +175,14 @@ namespace quad {
 	const Quad zn{{{{-h, -h, -h}, {0, 0, -1}, 0, {0, 1}}, {{-h, h, -h}, {0, 0, -1}, 0, {0, 0}}, {{h, h, -h}, {0, 0, -1}, 0, {1, 0}}, {{h, -h, -h}, {0, 0, -1}, 0, {1, 1}}}};
 	const Quad yn{{{{-h, -h, -h}, {0, -1, 0}, 0, {0, 0}}, {{h, -h, -h}, {0, -1, 0}, 0, {1, 0}}, {{h, -h, h}, {0, -1, 0}, 0, {1, 1}}, {{-h, -h, h}, {0, -1, 0}, 0, {0, 1}}}};
 	const Quad xn{{{{-h, -h, -h}, {-1, 0, 0}, 0, {1, 1}}, {{-h, -h, h}, {-1, 0, 0}, 0, {0, 1}}, {{-h, h, h}, {-1, 0, 0}, 0, {0, 0}}, {{-h, h, -h}, {-1, 0, 0}, 0, {1, 0}}}};
+
+	// Faces of two nodes at (0, 0, 0) and (1, 0, 0) merged together
+	constexpr float h3 = 3 * h;
+	const Quad merged_zp{{{{-h, -h, h}, {0, 0, 1}, 0, {1, 1}}, {{h3, -h, h}, {0, 0, 1}, 0, {-1, 1}}, {{h3, h, h}, {0, 0, 1}, 0, {-1, 0}}, {{-h, h, h}, {0, 0, 1}, 0, {1, 0}}}};
+	const Quad merged_yp{{{{-h, h, -h}, {0, 1, 0}, 0, {0, 1}}, {{-h, h, h}, {0, 1, 0}, 0, {0, 0}}, {{h3, h, h}, {0, 1, 0}, 0, {2, 0}}, {{h3, h, -h}, {0, 1, 0}, 0, {2, 1}}}};
+	const Quad merged_xp{{{{h3, -h, -h}, {1, 0, 0}, 0, {0, 1}}, {{h3, h, -h}, {1, 0, 0}, 0, {0, 0}}, {{h3, h, h}, {1, 0, 0}, 0, {1, 0}}, {{h3, -h, h}, {1, 0, 0}, 0, {1, 1}}}};
+	const Quad merged_zn{{{{-h, -h, -h}, {0, 0, -1}, 0, {0, 1}}, {{-h, h, -h}, {0, 0, -1}, 0, {0, 0}}, {{h3, h, -h}, {0, 0, -1}, 0, {2, 0}}, {{h3, -h, -h}, {0, 0, -1}, 0, {2, 1}}}};
+	const Quad merged_yn{{{{-h, -h, -h}, {0, -1, 0}, 0, {0, 0}}, {{h3, -h, -h}, {0, -1, 0}, 0, {2, 0}}, {{h3, -h, h}, {0, -1, 0}, 0, {2, 1}}, {{-h, -h, h}, {0, -1, 0}, 0, {0, 1}}}};
 }
 
 void TestMapblockMeshGenerator::testSimpleNode()
@@ -250,4 +270,120 @@ void TestMapblockMeshGenerator::testInterliquidDifferent()
 	UASSERT(checkMeshEqual(buf.vertices, buf.indices, {quad::xn, quad::xp, quad::yn, quad::yp, quad::zn, quad::zp}));
 }
 
+void TestMapblockMeshGenerator::testMergedFaces()
+{
+	MockGameDef gamedef;
+	content_t stone = gamedef.addSimpleNode("stone", 42);
+	gamedef.finalize();
+
+	for (bool smooth_lighting : {false, true}) {
+		MeshMakeData data = gamedef.makeMMD(2, smooth_lighting);
+		data.m_vmanip.setNode({0, 0, 0}, {stone, 0, 0});
+		data.m_vmanip.setNode({1, 0, 0}, {stone, 0, 0});
+
+		MeshCollector col{{}};
+		MapblockMeshGenerator mg{&data, &col, nullptr};
+		mg.generate();
+		UASSERTEQ(std::size_t, col.prebuffers[0].size(), 1);
+		UASSERTEQ(std::size_t, col.prebuffers[1].size(), 0);
+
+		auto &&buf = col.prebuffers[0][0];
+		UASSERTEQ(u32, buf.layer.texture_id, 42);
+		UASSERT(checkMeshEqual(buf.vertices, buf.indices, {quad::xn, quad::merged_xp,
+				quad::merged_yn, quad::merged_yp, quad::merged_zn, quad::merged_zp}));
+	}
+}
+
+void TestMapblockMeshGenerator::testFillBlockData()
+{
+	MockGameDef gamedef;
+	content_t stone = gamedef.addSimpleNode("stone", 42);
+	gamedef.finalize();
+
+	// A block of air with a stone at its corner, surrounded by stone blocks
+	MapNode air_block[MapBlock::nodecount];
+	MapNode stone_block[MapBlock::nodecount];
+	std::fill_n(air_block, MapBlock::nodecount, MapNode(CONTENT_AIR));
+	std::fill_n(stone_block, MapBlock::nodecount, MapNode(stone));
+	air_block[0] = MapNode(stone);
+
+	MeshMakeData data{gamedef.ndef(), MAP_BLOCKSIZE};
+	MeshCollector col{{}};
+	const MapNode *vmanip_data = nullptr;
+	// The second round reuses the memory of the first one
+	for (s16 y : {0, 5}) {
+		v3s16 blockpos(0, y, 0);
+		data.fillBlockDataBegin(blockpos);
+		v3s16 bp;
+		for (bp.Z = -1; bp.Z <= 1; bp.Z++)
+		for (bp.Y = -1; bp.Y <= 1; bp.Y++)
+		for (bp.X = -1; bp.X <= 1; bp.X++) {
+			data.fillBlockData(blockpos + bp,
+					bp == v3s16(0, 0, 0) ? air_block : stone_block);
+		}
+
+		// Only the border of the neighbors is copied
+		v3s16 origin = blockpos * MAP_BLOCKSIZE;
+		UASSERT(data.m_vmanip.m_area == VoxelArea(
+				origin - v3s16(1, 1, 1) * MeshMakeData::BORDER,
+				origin + v3s16(1, 1, 1) * (MAP_BLOCKSIZE + MeshMakeData::BORDER - 1)));
+		UASSERT(data.m_vmanip.exists(origin - v3s16(1, 1, 1) * MeshMakeData::BORDER));
+		UASSERTEQ(content_t, data.m_vmanip.getNodeNoExNoEmerge(origin + v3s16(-1, 0, 0)).getContent(), stone);
+		UASSERTEQ(content_t, data.m_vmanip.getNodeNoExNoEmerge(origin + v3s16(1, 0, 0)).getContent(), CONTENT_AIR);
+		if (vmanip_data)
+			UASSERT(data.m_vmanip.m_data == vmanip_data);
+		vmanip_data = data.m_vmanip.m_data;
+
+		col.clear({});
+		MapblockMeshGenerator mg{&data, &col, nullptr};
+		mg.generate();
+		UASSERTEQ(std::size_t, col.prebuffers[0].size(), 1);
+		UASSERTEQ(std::size_t, col.prebuffers[1].size(), 0);
+
+		auto &&buf = col.prebuffers[0][0];
+		UASSERTEQ(u32, buf.layer.texture_id, 42);
+		UASSERT(checkMeshEqual(buf.vertices, buf.indices, {quad::xp, quad::yp, quad::zp}));
+	}
+}
+
+void TestMapblockMeshGenerator::testGenerateLod()
+{
+	MockGameDef gamedef;
+	content_t stone = gamedef.addSimpleNode("stone", 42);
+	gamedef.finalize();
+
+	TileSpec tile;
+	tile.layers[0].texture_id = 7;
+
+	// Stone ground two nodes high, on top of the stone of the block below
+	MeshMakeData data = gamedef.makeMMD(4, false);
+	for (s16 x = -1; x <= 4; x++)
+	for (s16 y = -1; y <= 1; y++)
+	for (s16 z = -1; z <= 4; z++) {
+		if (y == -1 || (x >= 0 && x < 4 && z >= 0 && z < 4))
+			data.m_vmanip.setNode({x, y, z}, {stone, 0, 0});
+	}
+
+	// Cells that are at least half filled become cubes
+	for (s16 cell_size : {2, 4}) {
+		MeshCollector col{{}};
+		MapblockMeshGenerator mg{&data, &col, nullptr};
+		mg.generateLod(cell_size, tile);
+		UASSERTEQ(std::size_t, col.prebuffers[0].size(), 1);
+		UASSERTEQ(std::size_t, col.prebuffers[1].size(), 0);
+
+		auto &&buf = col.prebuffers[0][0];
+		UASSERTEQ(u32, buf.layer.texture_id, 7);
+		// The faces between the cells are hidden and the others merged.
+		// The bottom is kept although the stone below hides it, since the
+		// mesh below may be drawn at another level.
+		UASSERTEQ(std::size_t, buf.vertices.size(), 6 * 4);
+		const f32 top = (cell_size - 0.5f) * BS;
+		for (auto &vertex : buf.vertices) {
+			UASSERT(vertex.Pos.Y == top || vertex.Pos.Y == -0.5f * BS);
+			UASSERT(vertex.Pos.X == 3.5f * BS || vertex.Pos.X == -0.5f * BS);
+		}
+	}
+}
+
 }
@@ -0,0 +1,84 @@
+// Luanti
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (C) 2024 Luanti Authors
+
+#include "test.h"
+
+#include "emerge.h"
+
+class TestEmerge : public TestBase {
+public:
+	TestEmerge() { TestManager::registerTestModule(this); }
+	const char *getName() { return "TestEmerge"; }
+
+	void runTests(IGameDef *gamedef);
+
+	void testSpawnLevelCache();
+	void testSpawnLevelCacheEviction();
+};
+
+static TestEmerge g_test_instance;
+
+namespace {
+
+// Deterministic terrain that counts how often it was asked
+class CountingMapgen : public Mapgen {
+public:
+	int getSpawnLevelAtPoint(v2s16 p) override
+	{
+		calls++;
+		return p.X * 3 - p.Y;
+	}
+
+	u32 calls = 0;
+};
+
+}
+
+void TestEmerge::runTests(IGameDef *gamedef)
+{
+	TEST(testSpawnLevelCache);
+	TEST(testSpawnLevelCacheEviction);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestEmerge::testSpawnLevelCache()
+{
+	CountingMapgen mg;
+	SpawnLevelCache cache(16);
+
+	for (int i = 0; i < 2; i++)
+	for (s16 z = -20; z <= 20; z++)
+	for (s16 x = -20; x <= 20; x++)
+		UASSERTEQ(int, cache.get(&mg, v2s16(x, z)), x * 3 - z);
+
+	// Every column is only computed once
+	UASSERTEQ(u32, mg.calls, 41 * 41);
+	UASSERTEQ(size_t, cache.getTileCount(), 16);
+
+	cache.clear();
+	UASSERTEQ(size_t, cache.getTileCount(), 0);
+	UASSERTEQ(int, cache.get(&mg, v2s16(-20, -20)), -40);
+	UASSERTEQ(u32, mg.calls, 41 * 41 + 1);
+}
+
+void TestEmerge::testSpawnLevelCacheEviction()
+{
+	const s16 ts = SpawnLevelCache::TILE_SIZE;
+	CountingMapgen mg;
+	SpawnLevelCache cache(2);
+
+	cache.get(&mg, v2s16(0, 0));
+	cache.get(&mg, v2s16(ts, 0));
+	// Touch the first tile so the second one is the least recently used
+	cache.get(&mg, v2s16(0, 0));
+	cache.get(&mg, v2s16(2 * ts, 0));
+	UASSERTEQ(size_t, cache.getTileCount(), 2);
+	UASSERTEQ(u32, mg.calls, 3);
+
+	cache.get(&mg, v2s16(0, 0));
+	UASSERTEQ(u32, mg.calls, 3);
+	cache.get(&mg, v2s16(ts, 0));
+	UASSERTEQ(u32, mg.calls, 4);
+}
@@ -459,6 +459,57 @@ SECTION("simple skin")
 		});
 		CHECK(other->Weights.empty());
 	}
+
+	SECTION("hardware skinning matches software skinning")
+	{
+		auto skinned = dynamic_cast<ISkinnedMesh*>(mesh);
+		const auto frame = skinned->getMaxFrameNumber() / 2;
+		skinned->animateMesh(frame, 1.0f);
+		skinned->skinMesh();
+
+		auto *buffer = skinned->getMeshBuffer(0);
+		std::vector<v3f> expected;
+		for (irr::u32 i = 0; i < buffer->getVertexCount(); ++i)
+			expected.push_back(buffer->getPosition(i));
+
+		REQUIRE(skinned->setHardwareSkinning(true));
+		REQUIRE(buffer->getVertexType() == irr::video::EVT_TANGENTS);
+		skinned->skinMesh();
+		std::vector<irr::core::matrix4> matrices;
+		skinned->getSkinningMatrices(matrices);
+		REQUIRE(matrices.size() == joints.size());
+
+		auto box = skinned->getBoundingBox();
+		box.MinEdge -= v3f(1e-4f);
+		box.MaxEdge += v3f(1e-4f);
+
+		// Do what the vertex shaders do
+		const auto *vertices = static_cast<const irr::video::S3DVertexTangents*>(
+				buffer->getVertices());
+		for (irr::u32 i = 0; i < buffer->getVertexCount(); ++i) {
+			const auto &vertex = vertices[i];
+			const irr::u32 packed[2] = {
+				static_cast<irr::u32>(vertex.Tangent.X),
+				static_cast<irr::u32>(vertex.Tangent.Y),
+			};
+			const irr::u32 ids[4] = {
+				packed[0] / 256, packed[0] % 256, packed[1] / 256, packed[1] % 256,
+			};
+			const irr::f32 weights[4] = {
+				vertex.Binormal.X, vertex.Binormal.Y, vertex.Binormal.Z, vertex.Tangent.Z,
+			};
+
+			v3f pos = vertex.Pos * (1.0f - weights[0] - weights[1] - weights[2] - weights[3]);
+			for (int j = 0; j < 4; ++j) {
+				REQUIRE(ids[j] < matrices.size());
+				v3f pulled;
+				matrices[ids[j]].transformVect(pulled, vertex.Pos);
+				pos += pulled * weights[j];
+			}
+			CHECK(pos.getDistanceFrom(expected[i]) < 1e-5f);
+			CHECK(box.isPointInside(expected[i]));
+		}
+	}
 }
 
 driver->closeDevice();
@@ -5,7 +5,12 @@
 
 #include "test.h"
 #include "config.h"
+#include "porting.h"
+#include "script/common/c_sampler.h"
+#include "script/cpp_api/s_async.h"
+#include "mock_server.h"
 
+#include <sstream>
 #include <stdexcept>
 
 extern "C" {
@@ -15,6 +20,7 @@ extern "C" {
 	#include <lua.h>
 #endif
 #include <lauxlib.h>
+#include <lualib.h>
 }
 
 /*
@@ -35,6 +41,10 @@ class TestLua : public TestBase
 
 	void testLuaDestructors();
 	void testCxxExceptions();
+	void testSampler();
+	void testSamplerExport();
+	void testGCSteps();
+	void testAsyncJobBeforeInit();
 };
 
 static TestLua g_test_instance;
@@ -43,6 +53,10 @@ void TestLua::runTests(IGameDef *gamedef)
 {
 	TEST(testLuaDestructors);
 	TEST(testCxxExceptions);
+	TEST(testSampler);
+	TEST(testSamplerExport);
+	TEST(testGCSteps);
+	TEST(testAsyncJobBeforeInit);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -138,3 +152,138 @@ void TestLua::testCxxExceptions()
 	UASSERTEQ(int, caught, 2);
 	UASSERT(errmsg.find("example") != std::string::npos);
 }
+
+void TestLua::testSampler()
+{
+	lua_State *L = luaL_newstate();
+	luaL_openlibs(L);
+	UASSERT(luaL_dostring(L,
+		"local function busy()\n"
+		"	local x = 0\n"
+		"	for i = 1, 100000 do x = x + i % 7 end\n"
+		"	return x\n"
+		"end\n"
+		"local function outer() return busy() + 1 end\n"
+		// Functions called from C have no name
+		"function run() return outer() + 1 end\n") == 0);
+
+	LuaSampler sampler;
+	UASSERT(sampler.start(L, 100));
+	// Only one sampler can run at a time
+	LuaSampler other;
+	UASSERT(!other.start(L, 100));
+
+	const u64 end_time = porting::getTimeMs() + 5000;
+	while (sampler.getSampleCount() < 10 && porting::getTimeMs() < end_time) {
+		lua_getglobal(L, "run");
+		UASSERT(lua_pcall(L, 0, 1, 0) == 0);
+		lua_pop(L, 1);
+	}
+	sampler.stop();
+	UASSERT(!sampler.isRunning());
+	UASSERT(sampler.getSampleCount() >= 10);
+
+	// Stopped samplers don't record anything
+	size_t count = sampler.getSampleCount();
+	lua_getglobal(L, "run");
+	UASSERT(lua_pcall(L, 0, 1, 0) == 0);
+	UASSERTEQ(size_t, sampler.getSampleCount(), count);
+	lua_close(L);
+
+	std::ostringstream os;
+	sampler.writeCollapsed(os);
+	const std::string collapsed = os.str();
+	size_t outer = collapsed.find("outer");
+	UASSERT(outer != std::string::npos);
+	UASSERT(collapsed.find("busy", outer) != std::string::npos);
+}
+
+void TestLua::testSamplerExport()
+{
+	LuaSampler sampler(3);
+	sampler.addSample(0, {"x"});
+	sampler.addSample(1000, {"a", "b"});
+	sampler.addSample(2000, {"a", "b"});
+	sampler.addSample(3000, {"a", "c"});
+	// The oldest sample was dropped
+	UASSERTEQ(size_t, sampler.getSampleCount(), 3);
+
+	std::ostringstream collapsed;
+	sampler.writeCollapsed(collapsed);
+	UASSERTEQ(std::string, collapsed.str(), "a;b 2\na;c 1\n");
+
+	std::ostringstream trace;
+	sampler.writeChromeTrace(trace);
+	const std::string json = trace.str();
+	UASSERT(json.find("\"dur\":2000,\"name\":\"b\"") != std::string::npos);
+	UASSERT(json.find("\"dur\":1000,\"name\":\"c\"") != std::string::npos);
+	UASSERT(json.find("\"dur\":3000,\"name\":\"a\"") != std::string::npos);
+	UASSERT(json.find("\"name\":\"x\"") == std::string::npos);
+
+	// Stacks of dropped samples are forgotten without breaking the others
+	for (int i = 0; i < 10; i++)
+		sampler.addSample(4000 + i * 1000, {"a", "f" + std::to_string(i)});
+	collapsed.str("");
+	sampler.writeCollapsed(collapsed);
+	UASSERTEQ(std::string, collapsed.str(), "a;f7 1\na;f8 1\na;f9 1\n");
+
+	sampler.clear();
+	UASSERTEQ(size_t, sampler.getSampleCount(), 0);
+}
+
+void TestLua::testGCSteps()
+{
+	MockServer server(getTestTempDirectory());
+	server.createScripting();
+	ServerScripting *script = server.getScriptIface();
+
+	const auto path = getTestTempFile();
+	{
+		std::ofstream ofs(path, std::ios::out | std::ios::binary);
+		ofs << "garbage = {}\n"
+			"for i = 1, 100000 do garbage[i] = {i} end\n"
+			"garbage = nil\n";
+	}
+	script->loadScript(path);
+	const size_t heap_size = script->getHeapSize();
+	const u32 cycles = script->getGCCycles();
+
+	// Start the idle cycle right away
+	script->setGCParams(0, 200);
+	// A cycle that was already running might have marked the garbage as
+	// reachable, so wait for the next one too
+	for (int i = 0; i < 1000 && script->getGCCycles() < cycles + 2; i++)
+		script->stepGC(1000);
+	UASSERT(script->getGCCycles() >= cycles + 2);
+	UASSERT(script->getHeapSize() < heap_size);
+
+	// With the default pause the collector starts by itself once the heap
+	// has doubled, the idle cycle must start well before that
+	script->setGCParams(200, 200);
+	while (script->stepGC(1000) > 0)
+		;
+	const size_t base = script->getHeapSize();
+	{
+		std::ofstream ofs(path, std::ios::out | std::ios::binary);
+		ofs << "kept = kept or {}\n"
+			"for i = 1, 100 do kept[#kept + 1] = {} end\n";
+	}
+	while (script->getHeapSize() < base * 17 / 10)
+		script->loadScript(path);
+	UASSERT(script->getHeapSize() < base * 2);
+	const u32 idle_cycles = script->getGCCycles();
+	for (int i = 0; i < 1000 && script->getGCCycles() == idle_cycles; i++)
+		script->stepGC(1000);
+	UASSERT(script->getGCCycles() > idle_cycles);
+}
+
+void TestLua::testAsyncJobBeforeInit()
+{
+	// Mods can queue jobs while they load, before there are any workers
+	AsyncEngine engine;
+	u32 first = engine.queueAsyncJob("", "");
+	u32 second = engine.queueAsyncJob("", "", "", ASYNC_PRIORITY_LOW);
+	UASSERT(engine.cancelAsyncJob(second));
+	UASSERT(engine.cancelAsyncJob(first));
+	UASSERT(!engine.cancelAsyncJob(first));
+}
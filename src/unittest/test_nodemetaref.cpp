@@ -0,0 +1,97 @@
+// Luanti
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (C) 2024 Minetest core developers & community
+
+#include "test.h"
+
+#include "mock_server.h"
+#include "emerge.h"
+
+/*
+ * Tests the map edit events reported by node metadata changes from Lua.
+ */
+
+class TestNodeMetaRef : public TestBase, public MapEventReceiver
+{
+public:
+	TestNodeMetaRef() { TestManager::registerTestModule(this); }
+	const char *getName() { return "TestNodeMetaRef"; }
+
+	void runTests(IGameDef *gamedef);
+
+	void onMapEditEvent(const MapEditEvent &event) override
+	{
+		m_events.push_back(event);
+	}
+
+	void testSetManyPrivate(ServerScripting *script);
+
+private:
+	void runLua(ServerScripting *script, const char *src);
+
+	std::vector<MapEditEvent> m_events;
+};
+
+static TestNodeMetaRef g_test_instance;
+
+void TestNodeMetaRef::runTests(IGameDef *gamedef)
+{
+	MockServer server(getTestTempDirectory());
+	{
+		std::ofstream ofs(server.getWorldPath() + DIR_DELIM "world.mt",
+			std::ios::out | std::ios::binary);
+		ofs << "backend = dummy\n";
+	}
+
+	server.createScripting();
+	try {
+		server.getScriptIface()->loadBuiltin();
+	} catch (ModError &e) {
+		rawstream << e.what() << std::endl;
+		num_tests_failed = 1;
+		return;
+	}
+
+	MetricsBackend mb;
+	EmergeManager emerge(&server, &mb);
+	auto map = std::make_unique<ServerMap>(server.getWorldPath(), gamedef, &emerge, &mb);
+	ServerEnvironment env(std::move(map), &server, &mb);
+	env.loadMeta();
+	server.getScriptIface()->initializeEnvironment(&env);
+	// The metadata needs a block to live in
+	env.getServerMap().emergeBlock(v3s16(0, 0, 0));
+	env.getMap().addEventReceiver(this);
+
+	TEST(testSetManyPrivate, server.getScriptIface());
+
+	env.getMap().removeEventReceiver(this);
+}
+
+void TestNodeMetaRef::runLua(ServerScripting *script, const char *src)
+{
+	const auto path = getTestTempFile();
+	{
+		std::ofstream ofs(path, std::ios::out | std::ios::binary);
+		ofs << src;
+	}
+	m_events.clear();
+	script->loadScript(path);
+}
+
+void TestNodeMetaRef::testSetManyPrivate(ServerScripting *script)
+{
+	// Empty metadata is removed along with the private marks
+	runLua(script, "local meta = core.get_meta(vector.zero())\n"
+		"meta:set_many({a = '0', b = '0'})\n"
+		"meta:mark_as_private({'a', 'b'})\n");
+	runLua(script, "local meta = core.get_meta(vector.zero())\n"
+		"meta:set_many({a = '1', b = '2'})\n");
+	UASSERTEQ(size_t, m_events.size(), 1);
+	UASSERT(m_events[0].type == MEET_BLOCK_NODE_METADATA_CHANGED);
+	UASSERT(m_events[0].is_private_change);
+
+	runLua(script, "local meta = core.get_meta(vector.zero())\n"
+		"meta:set_many({a = '3', c = '4'})\n");
+	UASSERTEQ(size_t, m_events.size(), 1);
+	UASSERT(!m_events[0].is_private_change);
+}
@@ -0,0 +1,149 @@
+// Luanti
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (C) 2024 Luanti Authors
+
+#include "test.h"
+
+#include <sstream>
+#include "nodetimer.h"
+
+class TestNodeTimer : public TestBase {
+public:
+	TestNodeTimer() { TestManager::registerTestModule(this); }
+	const char *getName() { return "TestNodeTimer"; }
+
+	void runTests(IGameDef *gamedef);
+
+	void testSetGet();
+	void testRemove();
+	void testStep();
+	void testStepSameTime();
+	void testSerialize();
+};
+
+static TestNodeTimer g_test_instance;
+
+void TestNodeTimer::runTests(IGameDef *gamedef)
+{
+	TEST(testSetGet);
+	TEST(testRemove);
+	TEST(testStep);
+	TEST(testStepSameTime);
+	TEST(testSerialize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestNodeTimer::testSetGet()
+{
+	NodeTimerList list;
+	UASSERTEQ(f32, list.get(v3s16(1, 2, 3)).timeout, 0.0f);
+
+	list.set(NodeTimer(5.0f, 1.0f, v3s16(1, 2, 3)));
+	list.set(NodeTimer(2.0f, 0.0f, v3s16(4, 5, 6)));
+	UASSERTEQ(size_t, list.size(), 2);
+	UASSERTEQ(f32, list.get(v3s16(1, 2, 3)).timeout, 5.0f);
+	UASSERTEQ(f32, list.get(v3s16(1, 2, 3)).elapsed, 1.0f);
+
+	// Replaces the existing timer
+	list.set(NodeTimer(10.0f, 0.0f, v3s16(1, 2, 3)));
+	UASSERTEQ(size_t, list.size(), 2);
+	UASSERTEQ(f32, list.get(v3s16(1, 2, 3)).timeout, 10.0f);
+
+	list.step(1.0f);
+	UASSERTEQ(f32, list.get(v3s16(1, 2, 3)).elapsed, 1.0f);
+	UASSERTEQ(f32, list.get(v3s16(4, 5, 6)).elapsed, 1.0f);
+
+	list.clear();
+	UASSERTEQ(size_t, list.size(), 0);
+	UASSERTEQ(f32, list.get(v3s16(4, 5, 6)).timeout, 0.0f);
+}
+
+void TestNodeTimer::testRemove()
+{
+	NodeTimerList list;
+	for (s16 i = 0; i < 16; i++)
+		list.set(NodeTimer(1.0f + i, 0.0f, v3s16(i, 0, 0)));
+
+	list.remove(v3s16(0, 0, 0));
+	list.remove(v3s16(7, 0, 0));
+	list.remove(v3s16(0, 1, 0)); // does not exist
+	UASSERTEQ(size_t, list.size(), 14);
+	UASSERTEQ(f32, list.get(v3s16(7, 0, 0)).timeout, 0.0f);
+
+	std::vector<NodeTimer> elapsed = list.step(100.0f);
+	UASSERTEQ(size_t, elapsed.size(), 14);
+	for (const NodeTimer &t : elapsed)
+		UASSERT(t.position.X != 0 && t.position.X != 7);
+}
+
+void TestNodeTimer::testStep()
+{
+	NodeTimerList list;
+	// Inserted out of order on purpose
+	const s16 order[] = {5, 2, 8, 1, 9, 3, 7, 4, 6};
+	for (s16 i : order)
+		list.set(NodeTimer((f32)i, 0.0f, v3s16(i, 0, 0)));
+
+	UASSERT(list.step(0.5f).empty());
+
+	std::vector<NodeTimer> elapsed = list.step(4.0f);
+	UASSERTEQ(size_t, elapsed.size(), 4);
+	// Returned in order of their trigger time
+	for (s16 i = 0; i < 4; i++) {
+		UASSERTEQ(s16, elapsed[i].position.X, i + 1);
+		UASSERTEQ(f32, elapsed[i].elapsed, 4.5f);
+	}
+	UASSERTEQ(size_t, list.size(), 5);
+
+	// Restarting a timer moves it back
+	list.set(NodeTimer(1.0f, 0.0f, v3s16(9, 0, 0)));
+	elapsed = list.step(1.0f);
+	UASSERTEQ(size_t, elapsed.size(), 2);
+	UASSERTEQ(s16, elapsed[0].position.X, 5);
+	UASSERTEQ(s16, elapsed[1].position.X, 9);
+
+	elapsed = list.step(10.0f);
+	UASSERTEQ(size_t, elapsed.size(), 3);
+	UASSERTEQ(size_t, list.size(), 0);
+}
+
+void TestNodeTimer::testStepSameTime()
+{
+	NodeTimerList list;
+	// Timers with equal trigger times elapse in the order they were set
+	const s16 order[] = {7, 3, 12, 0, 9, 5, 14, 1, 10, 6};
+	for (s16 i : order)
+		list.set(NodeTimer(2.0f, 0.0f, v3s16(i, 0, 0)));
+	// Setting a timer again puts it last
+	list.set(NodeTimer(2.0f, 0.0f, v3s16(3, 0, 0)));
+
+	const s16 expected[] = {7, 12, 0, 9, 5, 14, 1, 10, 6, 3};
+	std::vector<NodeTimer> elapsed = list.step(2.0f);
+	UASSERTEQ(size_t, elapsed.size(), 10);
+	for (size_t i = 0; i < 10; i++)
+		UASSERTEQ(s16, elapsed[i].position.X, expected[i]);
+}
+
+void TestNodeTimer::testSerialize()
+{
+	NodeTimerList list;
+	list.set(NodeTimer(3.0f, 0.0f, v3s16(1, 2, 3)));
+	list.set(NodeTimer(8.0f, 2.0f, v3s16(15, 0, 7)));
+	list.step(1.0f);
+
+	std::ostringstream os(std::ios::binary);
+	list.serialize(os, 29);
+
+	NodeTimerList list2;
+	std::istringstream is(os.str(), std::ios::binary);
+	list2.deSerialize(is, 29);
+
+	UASSERTEQ(size_t, list2.size(), 2);
+	NodeTimer t = list2.get(v3s16(1, 2, 3));
+	UASSERTEQ(f32, t.timeout, 3.0f);
+	UASSERTEQ(f32, t.elapsed, 1.0f);
+	t = list2.get(v3s16(15, 0, 7));
+	UASSERTEQ(f32, t.timeout, 8.0f);
+	UASSERTEQ(f32, t.elapsed, 3.0f);
+}
@@ -26,6 +26,7 @@ class TestSAO : public TestBase
 	void testActivate(ServerEnvironment *env);
 	void testStaticToFalse(ServerEnvironment *env);
 	void testStaticToTrue(ServerEnvironment *env);
+	void testStepBatch(ServerEnvironment *env);
 
 private:
 	// enough for both removeRemovedObjects and deactivateFarObjects to be called
@@ -42,6 +43,39 @@ core.register_entity(":test:non_static", {
 		static_save = false,
 	}
 })
+
+-- Takes away 1 HP per step, or 2 if a moveresult was passed
+local function step_def(physical)
+	return {
+		initial_properties = {
+			static_save = false,
+			physical = physical,
+		},
+		on_step = function(self, dtime, moveresult)
+			self.object:set_hp(self.object:get_hp() - (moveresult and 2 or 1))
+		end,
+	}
+end
+core.register_entity(":test:step", step_def(false))
+core.register_entity(":test:step_physical", step_def(true))
+-- Removes all other removers
+local removers = {}
+core.register_entity(":test:step_remover", {
+	initial_properties = {
+		static_save = false,
+	},
+	on_activate = function(self)
+		table.insert(removers, self.object)
+	end,
+	on_step = function(self)
+		self.object:set_hp(self.object:get_hp() - 1)
+		for _, obj in ipairs(removers) do
+			if obj ~= self.object then
+				obj:remove()
+			end
+		end
+	end,
+})
 )";
 
 void TestSAO::runTests(IGameDef *gamedef)
@@ -76,6 +110,7 @@ void TestSAO::runTests(IGameDef *gamedef)
 	auto map = std::make_unique<ServerMap>(server.getWorldPath(), gamedef, &emerge, &mb);
 	ServerEnvironment env(std::move(map), &server, &mb);
 	env.loadMeta();
+	server.getScriptIface()->initializeEnvironment(&env);
 
 	m_step_interval = std::max(
 		g_settings->getFloat("active_block_mgmt_interval"), 0.5f) + 0.1f;
@@ -85,6 +120,7 @@ void TestSAO::runTests(IGameDef *gamedef)
 	TEST(testActivate, &env);
 	TEST(testStaticToFalse, &env);
 	TEST(testStaticToTrue, &env);
+	TEST(testStepBatch, &env);
 
 	env.deactivateBlocksAndObjects();
 }
@@ -298,3 +334,53 @@ void TestSAO::testStaticToTrue(ServerEnvironment *env)
 	UASSERTEQ(size_t, block->m_static_objects.getStoredSize(), 1);
 	UASSERTEQ(size_t, block->m_static_objects.getActiveSize(), 0);
 }
+
+void TestSAO::testStepBatch(ServerEnvironment *env)
+{
+	Map &map = env->getMap();
+
+	const v3f testpos(0, 4 * BS, 200 * BS);
+	UASSERT(map.emergeBlock(getNodeBlockPos(floatToInt(testpos, BS)), true));
+
+	// The first one has no on_step and is left out of the batch
+	u16 ids[5];
+	const char *names[5] = {"test:static", "test:step", "test:step_physical",
+		"test:step_remover", "test:step_remover"};
+	for (int i = 0; i < 5; i++) {
+		auto obj = add_entity(env, testpos + v3f(i * BS, 0, 0), names[i]);
+		UASSERT(obj);
+		UASSERTEQ(u16, obj->getHP(), 10);
+		ids[i] = obj->getId();
+	}
+
+	env->step(0.05f);
+
+	auto *obj = env->getActiveObject(ids[0]);
+	UASSERT(obj);
+	UASSERTEQ(u16, obj->getHP(), 10);
+	obj = env->getActiveObject(ids[1]);
+	UASSERT(obj);
+	UASSERTEQ(u16, obj->getHP(), 9);
+	obj = env->getActiveObject(ids[2]);
+	UASSERT(obj);
+	UASSERTEQ(u16, obj->getHP(), 8);
+
+	// Whichever remover ran first removed the other one, which must not
+	// have run its on_step anymore.
+	int stepped = 0, removed = 0;
+	for (int i = 3; i < 5; i++) {
+		obj = env->getActiveObject(ids[i]);
+		if (!obj || obj->isGone())
+			removed++;
+		if (obj && obj->getHP() == 9)
+			stepped++;
+	}
+	UASSERTEQ(int, stepped, 1);
+	UASSERTEQ(int, removed, 1);
+
+	for (u16 id : ids) {
+		if ((obj = env->getActiveObject(id)))
+			obj->markForRemoval();
+	}
+	env->step(m_step_interval);
+}
@@ -19,6 +19,8 @@ class TestVoxelAlgorithms : public TestBase {
 
 	void testVoxelLineIterator();
 	void testLighting(IGameDef *gamedef);
+	void testLightingBatch(IGameDef *gamedef);
+	void testLightingBatchFlush(IGameDef *gamedef);
 };
 
 static TestVoxelAlgorithms g_test_instance;
@@ -27,6 +29,8 @@ void TestVoxelAlgorithms::runTests(IGameDef *gamedef)
 {
 	TEST(testVoxelLineIterator);
 	TEST(testLighting, gamedef);
+	TEST(testLightingBatch, gamedef);
+	TEST(testLightingBatchFlush, gamedef);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -86,6 +90,26 @@ void TestVoxelAlgorithms::testVoxelLineIterator()
 	}
 }
 
+// Makes a 21x21x21 hollow box centered at the origin.
+static void makeHollowBox(Map *map, v3s16 bpmin, v3s16 bpmax)
+{
+	std::map<v3s16, MapBlock*> modified_blocks;
+	MMVManip vm(map);
+	vm.initialEmerge(bpmin, bpmax, false);
+	s32 volume = vm.m_area.getVolume();
+	for (s32 i = 0; i < volume; i++)
+		vm.m_data[i] = MapNode(CONTENT_AIR);
+	for (s16 z = -10; z <= 10; z++)
+	for (s16 y = -10; y <= 10; y++)
+	for (s16 x = -10; x <= 10; x++)
+		vm.setNodeNoEmerge(v3s16(x, y, z), MapNode(t_CONTENT_STONE));
+	for (s16 z = -9; z <= 9; z++)
+	for (s16 y = -9; y <= 9; y++)
+	for (s16 x = -9; x <= 9; x++)
+		vm.setNodeNoEmerge(v3s16(x, y, z), MapNode(CONTENT_AIR));
+	voxalgo::blit_back_with_light(map, &vm, &modified_blocks);
+}
+
 void TestVoxelAlgorithms::testLighting(IGameDef *gamedef)
 {
 	v3s16 pmin(-32, -32, -32);
@@ -93,24 +117,7 @@ void TestVoxelAlgorithms::testLighting(IGameDef *gamedef)
 	v3s16 bpmin = getNodeBlockPos(pmin), bpmax = getNodeBlockPos(pmax);
 	DummyMap map(gamedef, bpmin, bpmax);
 
-	// Make a 21x21x21 hollow box centered at the origin.
-	{
-		std::map<v3s16, MapBlock*> modified_blocks;
-		MMVManip vm(&map);
-		vm.initialEmerge(bpmin, bpmax, false);
-		s32 volume = vm.m_area.getVolume();
-		for (s32 i = 0; i < volume; i++)
-			vm.m_data[i] = MapNode(CONTENT_AIR);
-		for (s16 z = -10; z <= 10; z++)
-		for (s16 y = -10; y <= 10; y++)
-		for (s16 x = -10; x <= 10; x++)
-			vm.setNodeNoEmerge(v3s16(x, y, z), MapNode(t_CONTENT_STONE));
-		for (s16 z = -9; z <= 9; z++)
-		for (s16 y = -9; y <= 9; y++)
-		for (s16 x = -9; x <= 9; x++)
-			vm.setNodeNoEmerge(v3s16(x, y, z), MapNode(CONTENT_AIR));
-		voxalgo::blit_back_with_light(&map, &vm, &modified_blocks);
-	}
+	makeHollowBox(&map, bpmin, bpmax);
 
 	// Place two holes on the edges a torch in the center.
 	{
@@ -153,3 +160,104 @@ void TestVoxelAlgorithms::testLighting(IGameDef *gamedef)
 		UASSERTEQ(int, n.getParam1(), 153);
 	}
 }
+
+void TestVoxelAlgorithms::testLightingBatch(IGameDef *gamedef)
+{
+	v3s16 pmin(-32, -32, -32);
+	v3s16 pmax(31, 31, 31);
+	v3s16 bpmin = getNodeBlockPos(pmin), bpmax = getNodeBlockPos(pmax);
+	DummyMap map_single(gamedef, bpmin, bpmax);
+	DummyMap map_batch(gamedef, bpmin, bpmax);
+	makeHollowBox(&map_single, bpmin, bpmax);
+	makeHollowBox(&map_batch, bpmin, bpmax);
+
+	// Some positions are changed more than once
+	const std::pair<v3s16, MapNode> changes[] = {
+		{v3s16(-10, 0, 0), MapNode(CONTENT_AIR)},
+		{v3s16(0, 10, 0), MapNode(CONTENT_AIR)},
+		{v3s16(0, 0, 0), MapNode(t_CONTENT_TORCH)},
+		{v3s16(5, -9, 5), MapNode(t_CONTENT_TORCH)},
+		{v3s16(0, 9, 0), MapNode(t_CONTENT_STONE)},
+		{v3s16(5, -9, 5), MapNode(t_CONTENT_STONE)},
+		{v3s16(-9, 0, 0), MapNode(t_CONTENT_WATER)},
+		{v3s16(0, 9, 0), MapNode(CONTENT_AIR)},
+		{v3s16(-3, 2, 1), MapNode(t_CONTENT_TORCH)},
+	};
+
+	{
+		std::map<v3s16, MapBlock*> modified_blocks;
+		for (const auto &change : changes)
+			map_single.addNodeAndUpdate(change.first, change.second, modified_blocks);
+	}
+	{
+		std::map<v3s16, MapBlock*> modified_blocks;
+		MapLightUpdateBatch light_batch(&map_batch);
+		for (const auto &change : changes)
+			map_batch.addNodeAndUpdate(change.first, change.second, modified_blocks);
+	}
+
+	for (s16 z = -12; z <= 12; z++)
+	for (s16 y = -12; y <= 12; y++)
+	for (s16 x = -12; x <= 12; x++) {
+		v3s16 p(x, y, z);
+		UASSERTEQ(int, map_single.getNode(p).getParam1(),
+			map_batch.getNode(p).getParam1());
+	}
+}
+
+namespace {
+
+class EventRecorder : public MapEventReceiver {
+public:
+	void onMapEditEvent(const MapEditEvent &event) override
+	{
+		events.push_back(event);
+	}
+
+	std::vector<MapEditEvent> events;
+};
+
+}
+
+void TestVoxelAlgorithms::testLightingBatchFlush(IGameDef *gamedef)
+{
+	v3s16 pmin(-32, -32, -32);
+	v3s16 pmax(31, 31, 31);
+	v3s16 bpmin = getNodeBlockPos(pmin), bpmax = getNodeBlockPos(pmax);
+	DummyMap map(gamedef, bpmin, bpmax);
+	makeHollowBox(&map, bpmin, bpmax);
+
+	EventRecorder recorder;
+	map.addEventReceiver(&recorder);
+	const NodeDefManager *ndef = gamedef->ndef();
+	auto night_light = [&] (v3s16 p) {
+		MapNode n = map.getNode(p);
+		return (int)n.getLight(LIGHTBANK_NIGHT, ndef->getLightingFlags(n));
+	};
+
+	{
+		MapLightUpdateBatch light_batch(&map);
+		map.addNodeWithEvent(v3s16(0, 0, 0), MapNode(t_CONTENT_TORCH));
+		UASSERTEQ(int, night_light(v3s16(0, 1, 0)), 0);
+		UASSERTEQ(int, night_light(v3s16(-1, 0, 0)), 0);
+
+		// Flushing updates the light within the batch
+		map.flushLightUpdates();
+		UASSERTEQ(int, night_light(v3s16(0, 1, 0)), 12);
+		UASSERTEQ(int, night_light(v3s16(-1, 0, 0)), 12);
+
+		// The relit neighbor block is reported in an own event
+		UASSERTEQ(size_t, recorder.events.size(), 2);
+		const MapEditEvent &node_event = recorder.events[0];
+		UASSERT(node_event.type == MEET_ADDNODE);
+		UASSERT(!CONTAINS(node_event.modified_blocks, v3s16(-1, 0, 0)));
+		const MapEditEvent &light_event = recorder.events[1];
+		UASSERT(light_event.type == MEET_OTHER);
+		UASSERT(CONTAINS(light_event.modified_blocks, v3s16(0, 0, 0)));
+		UASSERT(CONTAINS(light_event.modified_blocks, v3s16(-1, 0, 0)));
+	}
+
+	// Nothing was left to do at the end of the batch
+	UASSERTEQ(size_t, recorder.events.size(), 2);
+	map.removeEventReceiver(&recorder);
+}
@@ -235,6 +235,7 @@ void TestVoxelArea::test_intersect()
 	VoxelArea v3({11, 11, 11}, {11, 11, 11});
 	VoxelArea v4({-11, -2, -10}, {10, 2, 11});
 	UASSERT(v2.intersect(v1) == v2);
+	UASSERT(v2.intersect(v1).getExtent() == v2.getExtent());
 	UASSERT(v1.intersect(v2) == v2.intersect(v1));
 	UASSERT(v1.intersect(v3).hasEmptyExtent());
 	UASSERT(v3.intersect(v1) == v1.intersect(v3));
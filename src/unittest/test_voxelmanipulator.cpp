@@ -19,6 +19,7 @@ class TestVoxelManipulator : public TestBase {
 
 	void testVoxelArea();
 	void testVoxelManipulator(const NodeDefManager *nodedef);
+	void testResetArea();
 };
 
 static TestVoxelManipulator g_test_instance;
@@ -27,6 +28,7 @@ void TestVoxelManipulator::runTests(IGameDef *gamedef)
 {
 	TEST(testVoxelArea);
 	TEST(testVoxelManipulator, gamedef->getNodeDefManager());
+	TEST(testResetArea);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -91,3 +93,26 @@ void TestVoxelManipulator::testVoxelManipulator(const NodeDefManager *nodedef)
 	UASSERT(v.getNode(v3s16(-1,0,-1)).getContent() == t_CONTENT_GRASS);
 	EXCEPTION_CHECK(InvalidPositionException, v.getNode(v3s16(0,1,1)));
 }
+
+void TestVoxelManipulator::testResetArea()
+{
+	VoxelManipulator v;
+	v.resetArea(VoxelArea(v3s16(0,0,0), v3s16(3,3,3)));
+	v.setNode(v3s16(1,2,3), MapNode(t_CONTENT_GRASS));
+	UASSERT(v.getNode(v3s16(1,2,3)).getContent() == t_CONTENT_GRASS);
+
+	// Same volume: the memory is kept, but the contents are gone
+	const MapNode *data = v.m_data;
+	VoxelArea moved(v3s16(10,-4,0), v3s16(13,-1,3));
+	v.resetArea(moved);
+	UASSERT(v.m_data == data);
+	UASSERT(v.m_area == moved);
+	EXCEPTION_CHECK(InvalidPositionException, v.getNode(v3s16(11,-3,1)));
+	UASSERT(!v.exists(v3s16(13,-1,3)));
+
+	// Different volume
+	VoxelArea larger(v3s16(0,0,0), v3s16(7,7,7));
+	v.resetArea(larger);
+	UASSERT(v.m_area == larger);
+	UASSERT(!v.exists(v3s16(7,7,7)));
+}
@@ -174,6 +174,18 @@ void VoxelManipulator::addArea(const VoxelArea &area)
 	delete[] old_flags;
 }
 
+void VoxelManipulator::resetArea(const VoxelArea &area)
+{
+	if (!m_data || area.getVolume() != m_area.getVolume()) {
+		clear();
+		addArea(area);
+		return;
+	}
+
+	m_area = area;
+	memset(m_flags, VOXELFLAG_NO_DATA, m_area.getVolume());
+}
+
 void VoxelManipulator::copyFrom(MapNode *src, const VoxelArea& src_area,
 		v3s16 from_pos, v3s16 to_pos, const v3s16 &size)
 {
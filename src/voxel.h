@@ -174,22 +174,21 @@ class VoxelArea
 	{
 		// This is an example of an operation that would be simpler with
 		// non-inclusive edges, but oh well.
-		VoxelArea ret;
-
 		if (a.MaxEdge.X < MinEdge.X || a.MinEdge.X > MaxEdge.X)
 			return VoxelArea();
 		if (a.MaxEdge.Y < MinEdge.Y || a.MinEdge.Y > MaxEdge.Y)
 			return VoxelArea();
 		if (a.MaxEdge.Z < MinEdge.Z || a.MinEdge.Z > MaxEdge.Z)
 			return VoxelArea();
-		ret.MinEdge.X = std::max(a.MinEdge.X, MinEdge.X);
-		ret.MaxEdge.X = std::min(a.MaxEdge.X, MaxEdge.X);
-		ret.MinEdge.Y = std::max(a.MinEdge.Y, MinEdge.Y);
-		ret.MaxEdge.Y = std::min(a.MaxEdge.Y, MaxEdge.Y);
-		ret.MinEdge.Z = std::max(a.MinEdge.Z, MinEdge.Z);
-		ret.MaxEdge.Z = std::min(a.MaxEdge.Z, MaxEdge.Z);
 
-		return ret;
+		// The constructor takes care of the cached extent
+		return VoxelArea(
+			v3s16(std::max(a.MinEdge.X, MinEdge.X),
+				std::max(a.MinEdge.Y, MinEdge.Y),
+				std::max(a.MinEdge.Z, MinEdge.Z)),
+			v3s16(std::min(a.MaxEdge.X, MaxEdge.X),
+				std::min(a.MaxEdge.Y, MaxEdge.Y),
+				std::min(a.MaxEdge.Z, MaxEdge.Z)));
 	}
 
 	/**
@@ -466,6 +465,12 @@ class VoxelManipulator
 
 	void addArea(const VoxelArea &area);
 
+	/*
+		Replaces the contents with the given area flagged VOXELFLAG_NO_DATA.
+		Keeps the allocation if the volume doesn't change.
+	*/
+	void resetArea(const VoxelArea &area);
+
 	void setFlags(const VoxelArea &area, u8 flag);
 	void clearFlags(const VoxelArea &area, u8 flag);
 